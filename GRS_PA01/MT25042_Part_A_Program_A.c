@@ -8,6 +8,11 @@
  * Usage: ./program_a <worker_type> [num_processes]
  *        worker_type: cpu, mem, or io
  *        num_processes: number of child processes (default: 2)
+ *
+ * With PA01_SCALE_TOTAL set the children share one fixed job through a
+ * chunk counter in shared memory (MT25042_Part_B_scaling.h).  With
+ * PA01_POOL_TASKS set they are a pre-forked pool running short tasks
+ * from a shared queue instead (MT25042_Part_B_pool.h).
  * 
  * AI Declaration: This code structure was generated with AI assistance.
  */
@@ -19,6 +24,8 @@
 #include <sys/types.h>
 #include <sys/wait.h>
 #include "MT25042_Part_B_workers.h"
+#include "MT25042_Part_B_scaling.h"
+#include "MT25042_Part_B_pool.h"
 
 #define DEFAULT_NUM_PROCESSES 2
 
@@ -56,6 +63,19 @@ int main(int argc, char *argv[]) {
     printf("[Parent PID: %d] Creating %d child processes for '%s' worker\n", 
            getpid(), num_processes, worker_type);
 
+    /* Pool mode: children forked once, tasks and results in shared memory */
+    if (pool_enabled()) {
+        return pool_run(worker_type, num_processes, "Program_A") == 0 ?
+               EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    /* Strong scaling: counter and statistics shared with the children */
+    scale_job_t *job = NULL;
+    if (scaling_enabled()) {
+        job = scale_job_create(worker_type, num_processes, 1);
+        if (job == NULL) return EXIT_FAILURE;
+    }
+
     /* Create child processes using fork() */
     for (int i = 0; i < num_processes; i++) {
         pid_t pid = fork();
@@ -71,7 +91,13 @@ int main(int argc, char *argv[]) {
                    i + 1, getpid(), worker_type);
 
             /* Execute the appropriate worker function */
-            if (strcmp(worker_type, "cpu") == 0) {
+            if (job != NULL) {
+                work_src_t src;
+                scale_counter_source(job, i, &src);
+                worker_run_share(worker_type, &src);
+                scale_worker_done(job, i);
+            }
+            else if (strcmp(worker_type, "cpu") == 0) {
                 worker_cpu();
             } 
             else if (strcmp(worker_type, "mem") == 0) {
@@ -107,5 +133,10 @@ int main(int argc, char *argv[]) {
     }
 
     printf("[Parent PID: %d] All children completed.\n", getpid());
+
+    if (job != NULL) {
+        scale_report(job, "Program_A");
+        scale_job_destroy(job);
+    }
     return EXIT_SUCCESS;
 }
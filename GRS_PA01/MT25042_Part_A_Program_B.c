@@ -8,6 +8,9 @@
  * Usage: ./program_b <worker_type> [num_threads]
  *        worker_type: cpu, mem, or io
  *        num_threads: number of threads (default: 2)
+ *
+ * With PA01_SCALE_TOTAL set the threads share one fixed job through
+ * work-stealing deques (MT25042_Part_B_scaling.h).
  * 
  * AI Declaration: This code structure was generated with AI assistance.
  */
@@ -18,6 +21,7 @@
 #include <string.h>
 #include <pthread.h>
 #include "MT25042_Part_B_workers.h"
+#include "MT25042_Part_B_scaling.h"
 
 #define DEFAULT_NUM_THREADS 2
 
@@ -25,6 +29,7 @@
 typedef struct {
     int thread_id;
     char worker_type[10];
+    scale_job_t *job;       /* strong scaling job, or NULL */
 } thread_args_t;
 
 /**
@@ -39,7 +44,13 @@ void *thread_function(void *arg) {
            args->thread_id, (unsigned long)pthread_self(), args->worker_type);
 
     /* Execute the appropriate worker function based on type */
-    if (strcmp(args->worker_type, "cpu") == 0) {
+    if (args->job != NULL) {
+        work_src_t src;
+        scale_deque_source(args->job, args->thread_id - 1, &src);
+        worker_run_share(args->worker_type, &src);
+        scale_worker_done(args->job, args->thread_id - 1);
+    }
+    else if (strcmp(args->worker_type, "cpu") == 0) {
         worker_cpu();
     } 
     else if (strcmp(args->worker_type, "mem") == 0) {
@@ -98,9 +109,17 @@ int main(int argc, char *argv[]) {
         return EXIT_FAILURE;
     }
 
+    /* Strong scaling: one deque of chunks per thread */
+    scale_job_t *job = NULL;
+    if (scaling_enabled()) {
+        job = scale_job_create(worker_type, num_threads, 0);
+        if (job == NULL) return EXIT_FAILURE;
+    }
+
     /* Create threads */
     for (int i = 0; i < num_threads; i++) {
         args[i].thread_id = i + 1;
+        args[i].job = job;
         strncpy(args[i].worker_type, worker_type, sizeof(args[i].worker_type) - 1);
         args[i].worker_type[sizeof(args[i].worker_type) - 1] = '\0';
 
@@ -128,5 +147,10 @@ int main(int argc, char *argv[]) {
     free(args);
 
     printf("[Main Thread] All threads completed.\n");
+
+    if (job != NULL) {
+        scale_report(job, "Program_B");
+        scale_job_destroy(job);
+    }
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,358 @@
+/**
+ * MT25042_Part_A_spawn_bench.c
+ * Graduate Systems (CSE638) - PA01: Processes and Threads
+ *
+ * Task creation microbenchmark: what it costs to start and reap one
+ * execution context, which Part C/D only see inside whole runs.
+ *
+ * For each method, parent RSS and iteration it measures
+ *   create  parent just before the call -> first instruction of the child
+ *   reap    child's last instruction -> parent back from waitpid/join
+ * with CLOCK_MONOTONIC on both sides; the child writes its two timestamps
+ * into a MAP_SHARED page (a pipe for posix_spawn, which execs a new image).
+ *
+ *   fork         fork(), copies the parent's page tables
+ *   vfork        vfork(), parent suspended until the child exits
+ *   posix_spawn  re-execs this binary (/proc/self/exe), so create includes
+ *                exec and the dynamic loader
+ *   clone3       clone3() with just SIGCHLD, i.e. a raw fork
+ *   clone3_vm    clone3() with CLONE_VM and its own stack, no copy at all
+ *                (x86_64 only: the child needs a few lines of assembly)
+ *   pthread      pthread_create() / pthread_join()
+ *
+ * Before each RSS step the parent maps and touches that much anonymous
+ * memory, since fork's page table copy scales with it.
+ *
+ * Usage: ./spawn_bench [method|all] [iterations]
+ *        iterations: per method and RSS (default: 2000)
+ * Environment:
+ *   PA01_SPAWN_RSS=0,64M,256M   parent RSS steps
+ *
+ * Output, one line per method and RSS (microseconds):
+ *   SPAWN,<method>,<rss_mb>,<iters>,<create_p50>,<create_p90>,<create_p99>,
+ *         <create_max>,<reap_p50>,<reap_p90>,<reap_p99>,<reap_max>
+ *
+ * AI Declaration: clone3 trampoline written from clone3(2) and the
+ *   x86_64 syscall ABI.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <linux/sched.h>
+#include "MT25042_Part_B_util.h"
+
+#define DEFAULT_ITERATIONS 2000
+#define DEFAULT_RSS        "0,64M,256M"
+#define WARMUP             20
+#define CHILD_STACK        (64 * 1024)
+#define CHILD_ARG          "--spawn-child"
+
+extern char **environ;
+
+/* What the child reports; lives in a MAP_SHARED page */
+typedef struct {
+    volatile uint64_t start_ns;
+    volatile uint64_t exit_ns;
+} stamps_t;
+
+typedef struct {
+    const char *name;
+    int (*spawn)(void);                 /* one create + reap, 0 on success */
+} method_t;
+
+static stamps_t *stamps;
+static uint64_t  reaped_ns;
+static char     *child_stack;
+static const char *self_exe = "/proc/self/exe";
+
+/* Waits for pid and records when the parent got it back */
+static int reap(pid_t pid) {
+    int status;
+    if (waitpid(pid, &status, 0) != pid) return -1;
+    reaped_ns = now_ns();
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0 ? 0 : -1;
+}
+
+/*------------------------------------------------------------------------------
+ * Methods
+ *----------------------------------------------------------------------------*/
+
+static int spawn_fork(void) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        stamps->start_ns = now_ns();
+        stamps->exit_ns = now_ns();
+        _exit(0);
+    }
+    return pid < 0 ? -1 : reap(pid);
+}
+
+static int spawn_vfork(void) {
+    pid_t pid = vfork();
+    if (pid == 0) {
+        stamps->start_ns = now_ns();
+        stamps->exit_ns = now_ns();
+        _exit(0);
+    }
+    return pid < 0 ? -1 : reap(pid);
+}
+
+/* The child half is main() with CHILD_ARG: it writes both stamps to the
+ * inherited pipe */
+static int spawn_posix(void) {
+    int fds[2];
+    if (pipe(fds) != 0) return -1;
+    fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+
+    char fd_arg[16];
+    snprintf(fd_arg, sizeof(fd_arg), "%d", fds[1]);
+    char *argv[] = { (char *)self_exe, CHILD_ARG, fd_arg, NULL };
+
+    pid_t pid;
+    int ret = posix_spawn(&pid, self_exe, NULL, NULL, argv, environ);
+    close(fds[1]);
+    if (ret != 0) {
+        close(fds[0]);
+        errno = ret;
+        return -1;
+    }
+    ret = reap(pid);
+
+    stamps_t s;
+    if (read(fds[0], &s, sizeof(s)) != (ssize_t)sizeof(s)) ret = -1;
+    close(fds[0]);
+    stamps->start_ns = s.start_ns;
+    stamps->exit_ns = s.exit_ns;
+    return ret;
+}
+
+static int spawn_clone3(void) {
+    struct clone_args args;
+    memset(&args, 0, sizeof(args));
+    args.exit_signal = SIGCHLD;
+
+    long pid = syscall(SYS_clone3, &args, sizeof(args));
+    if (pid == 0) {
+        stamps->start_ns = now_ns();
+        stamps->exit_ns = now_ns();
+        _exit(0);
+    }
+    return pid < 0 ? -1 : reap((pid_t)pid);
+}
+
+#if defined(__x86_64__)
+/*
+ * clone3_run(args, size, fn): with CLONE_VM the child starts on
+ * args->stack, so it cannot return through the C syscall() wrapper.  This
+ * calls fn on the new stack and exits without touching the parent's
+ * frames.  r8 survives the syscall (only rcx and r11 are clobbered).
+ */
+long clone3_run(struct clone_args *args, size_t size, void (*fn)(void));
+__asm__(
+    "    .text\n"
+    "    .type clone3_run, @function\n"
+    "clone3_run:\n"
+    "    mov  %rdx, %r8\n"
+    "    mov  $435, %eax\n"                 /* __NR_clone3 */
+    "    syscall\n"
+    "    test %rax, %rax\n"
+    "    jnz  1f\n"
+    "    xor  %ebp, %ebp\n"
+    "    call *%r8\n"
+    "    xor  %edi, %edi\n"
+    "    mov  $60, %eax\n"                  /* __NR_exit */
+    "    syscall\n"
+    "1:  ret\n"
+    "    .size clone3_run, .-clone3_run\n");
+
+/* Runs in the parent's memory, on child_stack; the vDSO clock is fine
+ * there, anything that touches errno or locks is not */
+static void clone3_vm_child(void) {
+    stamps->start_ns = now_ns();
+    stamps->exit_ns = now_ns();
+}
+
+static int spawn_clone3_vm(void) {
+    struct clone_args args;
+    memset(&args, 0, sizeof(args));
+    args.flags = CLONE_VM;
+    args.exit_signal = SIGCHLD;
+    args.stack = (uint64_t)(uintptr_t)child_stack;
+    args.stack_size = CHILD_STACK;
+
+    long pid = clone3_run(&args, sizeof(args), clone3_vm_child);
+    if (pid < 0) {
+        errno = (int)-pid;
+        return -1;
+    }
+    return reap((pid_t)pid);
+}
+#endif
+
+static void *thread_child(void *arg) {
+    (void)arg;
+    stamps->start_ns = now_ns();
+    stamps->exit_ns = now_ns();
+    return NULL;
+}
+
+static int spawn_pthread(void) {
+    pthread_t t;
+    int ret = pthread_create(&t, NULL, thread_child, NULL);
+    if (ret != 0) {
+        errno = ret;
+        return -1;
+    }
+    pthread_join(t, NULL);
+    reaped_ns = now_ns();
+    return 0;
+}
+
+static const method_t methods[] = {
+    { "fork",        spawn_fork },
+    { "vfork",       spawn_vfork },
+    { "posix_spawn", spawn_posix },
+    { "clone3",      spawn_clone3 },
+#if defined(__x86_64__)
+    { "clone3_vm",   spawn_clone3_vm },
+#endif
+    { "pthread",     spawn_pthread },
+};
+
+/*------------------------------------------------------------------------------
+ * Driver
+ *----------------------------------------------------------------------------*/
+
+/* Times `iters` create/reap rounds of m; -1 if the method fails */
+static int run_method(const method_t *m, int iters, size_t rss,
+                      uint64_t *create, uint64_t *reap_lat) {
+    for (int i = -WARMUP; i < iters; i++) {
+        stamps->start_ns = stamps->exit_ns = 0;
+        uint64_t t0 = now_ns();
+        if (m->spawn() != 0 || stamps->start_ns == 0) {
+            fprintf(stderr, "  %s: %s\n", m->name,
+                    errno ? strerror(errno) : "child did not report");
+            return -1;
+        }
+        if (i < 0) continue;
+        create[i] = stamps->start_ns - t0;
+        reap_lat[i] = reaped_ns - stamps->exit_ns;
+    }
+
+    qsort(create, iters, sizeof(uint64_t), cmp_u64);
+    qsort(reap_lat, iters, sizeof(uint64_t), cmp_u64);
+
+    printf("  %-12s %6zu MB   create p50 %8.1f  p99 %8.1f us   "
+           "reap p50 %8.1f  p99 %8.1f us\n", m->name, rss >> 20,
+           pct_us(create, iters, 0.50), pct_us(create, iters, 0.99),
+           pct_us(reap_lat, iters, 0.50), pct_us(reap_lat, iters, 0.99));
+    printf("SPAWN,%s,%zu,%d,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f\n",
+           m->name, rss >> 20, iters,
+           pct_us(create, iters, 0.50), pct_us(create, iters, 0.90),
+           pct_us(create, iters, 0.99), pct_us(create, iters, 1.0),
+           pct_us(reap_lat, iters, 0.50), pct_us(reap_lat, iters, 0.90),
+           pct_us(reap_lat, iters, 0.99), pct_us(reap_lat, iters, 1.0));
+    fflush(stdout);
+    return 0;
+}
+
+/* posix_spawn's child: report and exit, nothing else */
+static int child_main(const char *fd_arg) {
+    stamps_t s;
+    s.start_ns = now_ns();
+    int fd = atoi(fd_arg);
+    s.exit_ns = now_ns();
+    return write(fd, &s, sizeof(s)) == (ssize_t)sizeof(s) ? 0 : 1;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc == 3 && strcmp(argv[1], CHILD_ARG) == 0) {
+        return child_main(argv[2]);
+    }
+
+    const char *which = argc >= 2 ? argv[1] : "all";
+    int iters = argc >= 3 ? atoi(argv[2]) : DEFAULT_ITERATIONS;
+    if (iters < 1) {
+        fprintf(stderr, "Usage: %s [method|all] [iterations]\n", argv[0]);
+        fprintf(stderr, "  method: fork, vfork, posix_spawn, clone3, "
+                        "clone3_vm, pthread\n");
+        return EXIT_FAILURE;
+    }
+
+    int nmethods = (int)(sizeof(methods) / sizeof(methods[0]));
+    int found = strcmp(which, "all") == 0;
+    for (int i = 0; i < nmethods && !found; i++) {
+        found = strcmp(which, methods[i].name) == 0;
+    }
+    if (!found) {
+        fprintf(stderr, "Error: Unknown method '%s'\n", which);
+        return EXIT_FAILURE;
+    }
+
+    stamps = mmap(NULL, sizeof(stamps_t), PROT_READ | PROT_WRITE,
+                  MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    child_stack = mmap(NULL, CHILD_STACK, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+    uint64_t *create = malloc(iters * sizeof(uint64_t));
+    uint64_t *reap_lat = malloc(iters * sizeof(uint64_t));
+    if (stamps == MAP_FAILED || child_stack == MAP_FAILED ||
+        create == NULL || reap_lat == NULL) {
+        perror("allocation failed");
+        return EXIT_FAILURE;
+    }
+
+    const char *rss_env = getenv("PA01_SPAWN_RSS");
+    char *rss_list = strdup(rss_env != NULL && *rss_env != '\0' ? rss_env
+                                                                 : DEFAULT_RSS);
+
+    printf("[Spawn] %d iterations per method and RSS step\n", iters);
+    for (char *save = NULL, *tok = strtok_r(rss_list, ",", &save); tok != NULL;
+         tok = strtok_r(NULL, ",", &save)) {
+        /* Grow the parent: touched anonymous memory, 4K pages */
+        size_t rss = parse_size(tok, 0);
+        if (rss == 0 && strcmp(tok, "0") != 0) {
+            fprintf(stderr, "Invalid PA01_SPAWN_RSS step '%s'\n", tok);
+            return EXIT_FAILURE;
+        }
+        void *ballast = NULL;
+        if (rss > 0) {
+            ballast = mmap(NULL, rss, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (ballast == MAP_FAILED) {
+                perror("mmap failed");
+                return EXIT_FAILURE;
+            }
+            madvise(ballast, rss, MADV_NOHUGEPAGE);
+            memset(ballast, 1, rss);
+        }
+        printf("[Spawn] Parent RSS +%zu MB\n", rss >> 20);
+
+        for (int i = 0; i < nmethods; i++) {
+            if (strcmp(which, "all") != 0 && strcmp(which, methods[i].name) != 0) {
+                continue;
+            }
+            errno = 0;
+            run_method(&methods[i], iters, rss, create, reap_lat);
+        }
+
+        if (ballast != NULL) munmap(ballast, rss);
+    }
+
+    free(rss_list);
+    free(create);
+    free(reap_lat);
+    return EXIT_SUCCESS;
+}
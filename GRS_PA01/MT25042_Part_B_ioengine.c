@@ -0,0 +1,539 @@
+/**
+ * MT25042_Part_B_ioengine.c
+ * Graduate Systems (CSE638) - PA01: Processes and Threads
+ *
+ * io_uring, O_DIRECT, buffered and mmap backends of the I/O engine
+ * (see MT25042_Part_B_ioengine.h).
+ *
+ * AI Declaration: This code structure was generated with AI assistance;
+ *   follows io_uring_setup(2), io_uring_enter(2) and io_uring_register(2);
+ *   no liburing.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <linux/io_uring.h>
+#include "MT25042_Part_B_ioengine.h"
+#include "MT25042_Part_B_util.h"
+
+#define IO_ALIGN          4096            /* O_DIRECT buffer/offset alignment */
+#define DEFAULT_BS        (4UL * 1024)
+#define DEFAULT_QD        32
+#define DEFAULT_READ_PCT  50
+#define DEFAULT_FILE_SIZE (64UL * 1024 * 1024)
+#define DEFAULT_OPS       (64UL * 1024)
+#define MAX_QD            4096
+
+typedef enum {
+    ENGINE_URING, ENGINE_DIRECT, ENGINE_BUFFERED, ENGINE_MMAP, NUM_ENGINES
+} engine_t;
+
+static const char *engine_names[NUM_ENGINES] = {
+    "uring", "direct", "buffered", "mmap"
+};
+
+typedef struct {
+    engine_t engine;
+    int      direct;                     /* open with O_DIRECT */
+    size_t   bs;
+    unsigned qd;
+    int      read_pct;
+    int      sequential;
+    size_t   file_size;
+    size_t   ops;
+    size_t   sync_every;                 /* writes per flush, 0: at the end */
+    int      sync_range;                 /* sync_file_range instead of
+                                            fdatasync / msync            */
+    int      populate;                   /* mmap with MAP_POPULATE        */
+} io_cfg_t;
+
+/* State of one worker's run */
+typedef struct {
+    int            fd;
+    unsigned char *buf;                  /* qd blocks, IO_ALIGN aligned */
+    uint64_t      *lat_ns;               /* one per completed request   */
+    size_t         completed;
+    size_t         nblocks;              /* blocks in the file          */
+    uint64_t       next_block;           /* PA01_IO_PATTERN=seq         */
+    uint64_t       rnd;
+    unsigned char *map;                  /* mmap engine                 */
+    size_t         unsynced;             /* writes since the last flush */
+    uint64_t       dirty_lo, dirty_hi;   /* byte range they touched     */
+} io_job_t;
+
+/*------------------------------------------------------------------------------
+ * Configuration
+ *----------------------------------------------------------------------------*/
+
+static int load_config(io_cfg_t *cfg) {
+    const char *engine = getenv("PA01_IO_ENGINE");
+    const char *direct = getenv("PA01_IO_DIRECT");
+    const char *read_pct = getenv("PA01_IO_READ");
+    const char *pattern = getenv("PA01_IO_PATTERN");
+    const char *sync = getenv("PA01_IO_SYNC");
+    const char *populate = getenv("PA01_IO_POPULATE");
+
+    cfg->engine = NUM_ENGINES;
+    for (int i = 0; i < NUM_ENGINES; i++) {
+        if (strcmp(engine, engine_names[i]) == 0) cfg->engine = (engine_t)i;
+    }
+    if (cfg->engine == NUM_ENGINES) {
+        fprintf(stderr, "    [IO Worker] PA01_IO_ENGINE=%s unknown "
+                "(uring, direct, buffered, mmap)\n", engine);
+        return -1;
+    }
+
+    cfg->direct = cfg->engine == ENGINE_DIRECT ||
+                  (cfg->engine == ENGINE_URING &&
+                   !(direct != NULL && strcmp(direct, "0") == 0));
+    cfg->bs = parse_size(getenv("PA01_IO_BS"), DEFAULT_BS);
+    cfg->qd = (unsigned)parse_size(getenv("PA01_IO_QD"), DEFAULT_QD);
+    cfg->read_pct = read_pct != NULL && *read_pct != '\0' ? atoi(read_pct)
+                                                          : DEFAULT_READ_PCT;
+    cfg->sequential = pattern != NULL && strcmp(pattern, "seq") == 0;
+    cfg->file_size = parse_size(getenv("PA01_IO_FILE_SIZE"), DEFAULT_FILE_SIZE);
+    cfg->ops = parse_size(getenv("PA01_IO_OPS"), DEFAULT_OPS);
+    cfg->sync_every = parse_size(getenv("PA01_IO_SYNC_EVERY"), 0);
+    cfg->sync_range = sync != NULL && strcmp(sync, "range") == 0;
+    cfg->populate = populate != NULL && *populate != '\0' && strcmp(populate, "0") != 0;
+
+    if (cfg->engine != ENGINE_URING) cfg->qd = 1;
+    if (cfg->qd > MAX_QD) cfg->qd = MAX_QD;
+    if (cfg->read_pct < 0) cfg->read_pct = 0;
+    if (cfg->read_pct > 100) cfg->read_pct = 100;
+    if (cfg->direct && cfg->bs % IO_ALIGN != 0) {
+        cfg->bs = (cfg->bs + IO_ALIGN - 1) / IO_ALIGN * IO_ALIGN;
+        fprintf(stderr, "    [IO Worker] O_DIRECT block size rounded up to %zu\n",
+                cfg->bs);
+    }
+    if (cfg->file_size < cfg->bs) cfg->file_size = cfg->bs;
+    return 0;
+}
+
+/*------------------------------------------------------------------------------
+ * Helpers
+ *----------------------------------------------------------------------------*/
+
+static uint64_t next_offset(const io_cfg_t *cfg, io_job_t *job) {
+    uint64_t block;
+    if (cfg->sequential) {
+        block = job->next_block;
+        job->next_block = (job->next_block + 1) % job->nblocks;
+    } else {
+        block = xorshift64(&job->rnd) % job->nblocks;
+    }
+    return block * cfg->bs;
+}
+
+static int next_is_read(const io_cfg_t *cfg, io_job_t *job) {
+    return (int)(xorshift64(&job->rnd) % 100) < cfg->read_pct;
+}
+
+/* Allocates the whole file once (fallocate: contiguous extents, no
+ * block allocation or truncate during the run) and writes it so reads hit
+ * real data, then drops it from the page cache so every engine starts
+ * cold */
+static int prefill(const char *filename, const io_cfg_t *cfg,
+                   const unsigned char *block) {
+    int fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return -1;
+
+    if (fallocate(fd, 0, 0, (off_t)cfg->file_size) != 0 &&
+        ftruncate(fd, (off_t)cfg->file_size) != 0) {   /* no fallocate here */
+        close(fd);
+        return -1;
+    }
+
+    for (size_t off = 0; off + cfg->bs <= cfg->file_size; off += cfg->bs) {
+        if (pwrite(fd, block, cfg->bs, (off_t)off) != (ssize_t)cfg->bs) {
+            close(fd);
+            return -1;
+        }
+    }
+    fsync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+    return 0;
+}
+
+/*------------------------------------------------------------------------------
+ * Flushing (direct, buffered, mmap)
+ *----------------------------------------------------------------------------*/
+
+/* Makes the writes since the last flush durable: fdatasync, or msync of
+ * their range for mmap.  PA01_IO_SYNC=range writes back just that range
+ * with sync_file_range, which skips metadata and the device cache */
+static int flush_writes(const io_cfg_t *cfg, io_job_t *job) {
+    if (job->unsynced == 0) return 0;
+
+    uint64_t lo = job->dirty_lo & ~(uint64_t)(IO_ALIGN - 1);
+    uint64_t len = job->dirty_hi - lo;
+    int rc;
+    if (cfg->sync_range) {
+        rc = sync_file_range(job->fd, (off_t)lo, (off_t)len,
+                             SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE |
+                             SYNC_FILE_RANGE_WAIT_AFTER);
+    } else if (job->map != NULL) {
+        rc = msync(job->map + lo, len, MS_SYNC);
+    } else {
+        rc = fdatasync(job->fd);
+    }
+    if (rc != 0) perror("    [IO Worker] flush failed");
+
+    job->unsynced = 0;
+    return rc;
+}
+
+/* Records a write at `off` and flushes every PA01_IO_SYNC_EVERY writes */
+static int note_write(const io_cfg_t *cfg, io_job_t *job, uint64_t off) {
+    if (job->unsynced == 0 || off < job->dirty_lo) job->dirty_lo = off;
+    if (job->unsynced == 0 || off + cfg->bs > job->dirty_hi) job->dirty_hi = off + cfg->bs;
+    job->unsynced++;
+    if (cfg->sync_every > 0 && job->unsynced >= cfg->sync_every) {
+        return flush_writes(cfg, job);
+    }
+    return 0;
+}
+
+/*------------------------------------------------------------------------------
+ * Synchronous backends (direct, buffered): one request at a time
+ *----------------------------------------------------------------------------*/
+
+static int run_sync(const io_cfg_t *cfg, io_job_t *job) {
+    for (size_t i = 0; i < cfg->ops; i++) {
+        off_t off = (off_t)next_offset(cfg, job);
+        int is_read = next_is_read(cfg, job);
+
+        uint64_t t0 = now_ns();
+        ssize_t n = is_read ? pread(job->fd, job->buf, cfg->bs, off)
+                            : pwrite(job->fd, job->buf, cfg->bs, off);
+        if (n != (ssize_t)cfg->bs) {
+            perror(is_read ? "    [IO Worker] pread failed"
+                           : "    [IO Worker] pwrite failed");
+            return -1;
+        }
+        /* A batch flush counts towards the write that triggered it */
+        if (!is_read && note_write(cfg, job, (uint64_t)off) != 0) return -1;
+        job->lat_ns[job->completed++] = now_ns() - t0;
+    }
+    return 0;
+}
+
+/*------------------------------------------------------------------------------
+ * mmap backend: memcpy to/from a shared mapping of the file
+ *----------------------------------------------------------------------------*/
+
+static int run_mmap(const io_cfg_t *cfg, io_job_t *job) {
+    uint64_t t0 = now_ns();
+    job->map = mmap(NULL, cfg->file_size, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | (cfg->populate ? MAP_POPULATE : 0), job->fd, 0);
+    if (job->map == MAP_FAILED) {
+        job->map = NULL;
+        perror("    [IO Worker] mmap failed");
+        return -1;
+    }
+    /* Readahead follows the access pattern */
+    madvise(job->map, cfg->file_size,
+            cfg->sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+    if (cfg->populate) {
+        printf("    [IO Worker] MAP_POPULATE took %.1f ms\n", (now_ns() - t0) / 1e6);
+    }
+
+    for (size_t i = 0; i < cfg->ops; i++) {
+        uint64_t off = next_offset(cfg, job);
+        int is_read = next_is_read(cfg, job);
+
+        uint64_t t1 = now_ns();
+        if (is_read) {
+            memcpy(job->buf, job->map + off, cfg->bs);
+        } else {
+            memcpy(job->map + off, job->buf, cfg->bs);
+            if (note_write(cfg, job, off) != 0) return -1;
+        }
+        job->lat_ns[job->completed++] = now_ns() - t1;
+    }
+    return 0;
+}
+
+/*------------------------------------------------------------------------------
+ * io_uring backend
+ *----------------------------------------------------------------------------*/
+
+typedef struct {
+    int                  fd;
+    unsigned            *sq_tail, *sq_mask, *sq_array;
+    unsigned            *cq_head, *cq_tail, *cq_mask;
+    struct io_uring_sqe *sqes;
+    struct io_uring_cqe *cqes;
+    void                *sq_ptr, *cq_ptr;
+    size_t               sq_len, cq_len, sqes_len;
+} uring_t;
+
+static void uring_close(uring_t *r) {
+    if (r->sqes != NULL) munmap(r->sqes, r->sqes_len);
+    if (r->cq_ptr != NULL && r->cq_ptr != r->sq_ptr) munmap(r->cq_ptr, r->cq_len);
+    if (r->sq_ptr != NULL) munmap(r->sq_ptr, r->sq_len);
+    if (r->fd >= 0) close(r->fd);
+}
+
+static int uring_setup(uring_t *r, unsigned entries) {
+    struct io_uring_params p;
+
+    memset(r, 0, sizeof(*r));
+    memset(&p, 0, sizeof(p));
+    r->fd = (int)syscall(__NR_io_uring_setup, entries, &p);
+    if (r->fd < 0) return -1;
+
+    r->sq_len = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    r->cq_len = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        if (r->cq_len > r->sq_len) r->sq_len = r->cq_len;
+        r->cq_len = r->sq_len;
+    }
+
+    r->sq_ptr = mmap(NULL, r->sq_len, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE, r->fd, IORING_OFF_SQ_RING);
+    if (r->sq_ptr == MAP_FAILED) {
+        r->sq_ptr = NULL;
+        goto fail;
+    }
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        r->cq_ptr = r->sq_ptr;
+    } else {
+        r->cq_ptr = mmap(NULL, r->cq_len, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE, r->fd, IORING_OFF_CQ_RING);
+        if (r->cq_ptr == MAP_FAILED) {
+            r->cq_ptr = NULL;
+            goto fail;
+        }
+    }
+    r->sqes_len = p.sq_entries * sizeof(struct io_uring_sqe);
+    r->sqes = mmap(NULL, r->sqes_len, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE, r->fd, IORING_OFF_SQES);
+    if (r->sqes == MAP_FAILED) {
+        r->sqes = NULL;
+        goto fail;
+    }
+
+    unsigned char *sq = r->sq_ptr, *cq = r->cq_ptr;
+    r->sq_tail  = (unsigned *)(sq + p.sq_off.tail);
+    r->sq_mask  = (unsigned *)(sq + p.sq_off.ring_mask);
+    r->sq_array = (unsigned *)(sq + p.sq_off.array);
+    r->cq_head  = (unsigned *)(cq + p.cq_off.head);
+    r->cq_tail  = (unsigned *)(cq + p.cq_off.tail);
+    r->cq_mask  = (unsigned *)(cq + p.cq_off.ring_mask);
+    r->cqes     = (struct io_uring_cqe *)(cq + p.cq_off.cqes);
+    return 0;
+
+fail:
+    uring_close(r);
+    return -1;
+}
+
+static int run_uring(const io_cfg_t *cfg, io_job_t *job, int *fixed) {
+    uring_t r;
+    if (uring_setup(&r, cfg->qd) != 0) {
+        perror("    [IO Worker] io_uring_setup failed");
+        return -1;
+    }
+
+    /* One registered buffer per slot and the file as fixed file 0; the
+     * kernel then skips the page pinning and fd lookup per request */
+    struct iovec iov[MAX_QD];
+    for (unsigned i = 0; i < cfg->qd; i++) {
+        iov[i].iov_base = job->buf + (size_t)i * cfg->bs;
+        iov[i].iov_len = cfg->bs;
+    }
+    int fixed_bufs = syscall(__NR_io_uring_register, r.fd,
+                             IORING_REGISTER_BUFFERS, iov, cfg->qd) == 0;
+    int fixed_file = syscall(__NR_io_uring_register, r.fd,
+                             IORING_REGISTER_FILES, &job->fd, 1) == 0;
+    if (!fixed_bufs || !fixed_file) {
+        fprintf(stderr, "    [IO Worker] io_uring registration failed (%s), "
+                "using plain READ/WRITE\n", strerror(errno));
+    }
+    *fixed = fixed_bufs && fixed_file;
+
+    unsigned slots[MAX_QD], nfree = cfg->qd, pending = 0;
+    uint64_t start[MAX_QD];
+    size_t submitted = 0;
+    int failed = 0;
+
+    for (unsigned i = 0; i < cfg->qd; i++) slots[i] = cfg->qd - 1 - i;
+
+    while (job->completed < submitted || (submitted < cfg->ops && !failed)) {
+        /* Fill every free slot */
+        unsigned tail = *r.sq_tail;
+        while (nfree > 0 && submitted < cfg->ops && !failed) {
+            unsigned slot = slots[--nfree];
+            unsigned idx = tail & *r.sq_mask;
+            struct io_uring_sqe *sqe = &r.sqes[idx];
+            int is_read = next_is_read(cfg, job);
+
+            memset(sqe, 0, sizeof(*sqe));
+            if (fixed_bufs) {
+                sqe->opcode = is_read ? IORING_OP_READ_FIXED : IORING_OP_WRITE_FIXED;
+                sqe->buf_index = (uint16_t)slot;
+            } else {
+                sqe->opcode = is_read ? IORING_OP_READ : IORING_OP_WRITE;
+            }
+            if (fixed_file) {
+                sqe->flags = IOSQE_FIXED_FILE;
+                sqe->fd = 0;
+            } else {
+                sqe->fd = job->fd;
+            }
+            sqe->addr = (uint64_t)(uintptr_t)iov[slot].iov_base;
+            sqe->len = (uint32_t)cfg->bs;
+            sqe->off = next_offset(cfg, job);
+            sqe->user_data = slot;
+            r.sq_array[idx] = idx;
+
+            start[slot] = now_ns();
+            tail++;
+            pending++;
+            submitted++;
+        }
+        __atomic_store_n(r.sq_tail, tail, __ATOMIC_RELEASE);
+
+        /* Submit and wait for at least one completion */
+        int ret = (int)syscall(__NR_io_uring_enter, r.fd, pending, 1,
+                               IORING_ENTER_GETEVENTS, NULL, 0);
+        if (ret < 0) {
+            if (errno == EINTR || errno == EAGAIN || errno == EBUSY) continue;
+            perror("    [IO Worker] io_uring_enter failed");
+            failed = 1;
+            break;
+        }
+        pending -= (unsigned)ret;
+
+        unsigned head = *r.cq_head;
+        unsigned cq_tail = __atomic_load_n(r.cq_tail, __ATOMIC_ACQUIRE);
+        uint64_t now = now_ns();
+        for (; head != cq_tail; head++) {
+            struct io_uring_cqe *cqe = &r.cqes[head & *r.cq_mask];
+            unsigned slot = (unsigned)cqe->user_data;
+
+            if (cqe->res != (int)cfg->bs && !failed) {
+                fprintf(stderr, "    [IO Worker] io_uring request failed: %s\n",
+                        cqe->res < 0 ? strerror(-cqe->res) : "short transfer");
+                failed = 1;
+            }
+            job->lat_ns[job->completed++] = now - start[slot];
+            slots[nfree++] = slot;
+        }
+        __atomic_store_n(r.cq_head, head, __ATOMIC_RELEASE);
+    }
+
+    uring_close(&r);
+    return failed ? -1 : 0;
+}
+
+/*------------------------------------------------------------------------------
+ * Entry points
+ *----------------------------------------------------------------------------*/
+
+int ioengine_enabled(void) {
+    const char *s = getenv("PA01_IO_ENGINE");
+    return s != NULL && *s != '\0';
+}
+
+void ioengine_run(const char *filename) {
+    io_cfg_t cfg;
+    io_job_t job;
+
+    if (load_config(&cfg) != 0) return;
+    memset(&job, 0, sizeof(job));
+    job.fd = -1;
+    job.nblocks = cfg.file_size / cfg.bs;
+    job.rnd = 0x9E3779B97F4A7C15ULL ^ ((uint64_t)syscall(SYS_gettid) << 32);
+
+    printf("    [IO Worker] Engine %s%s: bs %zu, qd %u, %d%% reads, %s, "
+           "%zu ops on %zu MB\n", engine_names[cfg.engine],
+           cfg.direct ? " (O_DIRECT)" : "", cfg.bs, cfg.qd, cfg.read_pct,
+           cfg.sequential ? "sequential" : "random", cfg.ops,
+           cfg.file_size >> 20);
+    if (cfg.engine != ENGINE_URING) {
+        const char *how = cfg.sync_range ? "sync_file_range"
+                          : cfg.engine == ENGINE_MMAP ? "msync" : "fdatasync";
+        if (cfg.sync_every > 0) {
+            printf("    [IO Worker] Flush with %s every %zu writes\n", how,
+                   cfg.sync_every);
+        } else {
+            printf("    [IO Worker] Flush with %s at the end\n", how);
+        }
+    }
+
+    if (posix_memalign((void **)&job.buf, IO_ALIGN, (size_t)cfg.qd * cfg.bs) != 0 ||
+        (job.lat_ns = malloc(cfg.ops * sizeof(uint64_t))) == NULL) {
+        perror("    [IO Worker] malloc failed");
+        goto out;
+    }
+    for (size_t i = 0; i < (size_t)cfg.qd * cfg.bs; i++) {
+        job.buf[i] = (unsigned char)('A' + (i % 26));
+    }
+
+    if (prefill(filename, &cfg, job.buf) != 0) {
+        perror("    [IO Worker] prefill failed");
+        goto out;
+    }
+
+    job.fd = open(filename, O_RDWR | (cfg.direct ? O_DIRECT : 0));
+    if (job.fd < 0 && cfg.direct && errno == EINVAL) {
+        fprintf(stderr, "    [IO Worker] O_DIRECT not supported here (tmpfs?), "
+                "set PA01_IO_DIR; using the page cache\n");
+        cfg.direct = 0;
+        job.fd = open(filename, O_RDWR);
+    }
+    if (job.fd < 0) {
+        perror("    [IO Worker] open failed");
+        goto out;
+    }
+
+    int fixed = 0, rc;
+    uint64_t t0 = now_ns();
+    if (cfg.engine == ENGINE_URING) rc = run_uring(&cfg, &job, &fixed);
+    else if (cfg.engine == ENGINE_MMAP) rc = run_mmap(&cfg, &job);
+    else rc = run_sync(&cfg, &job);
+    /* Writes are only done once they reach the device */
+    if (cfg.engine != ENGINE_URING) flush_writes(&cfg, &job);
+    else if (!cfg.direct) fdatasync(job.fd);
+    uint64_t elapsed = now_ns() - t0;
+
+    if (rc == 0 && job.completed > 0) {
+        qsort(job.lat_ns, job.completed, sizeof(uint64_t), cmp_u64);
+        double secs = elapsed / 1e9;
+        double iops = job.completed / secs;
+        double mbps = iops * cfg.bs / (1024.0 * 1024.0);
+        size_t n = job.completed;
+
+        printf("    [IO Worker] %.0f IOPS, %.1f MB/s, latency p50 %.1f us, "
+               "p99 %.1f us, max %.1f us%s\n", iops, mbps,
+               pct_us(job.lat_ns, n, 0.50), pct_us(job.lat_ns, n, 0.99),
+               job.lat_ns[n - 1] / 1e3,
+               cfg.engine == ENGINE_URING && fixed ? " (fixed buffers/file)" : "");
+        printf("IOENGINE,%d,%ld,%s,%d,%zu,%u,%d,%zu,%.0f,%.2f,%.1f,%.1f,%.1f,%.1f,%.1f,%s,%zu\n",
+               getpid(), (long)syscall(SYS_gettid), engine_names[cfg.engine],
+               cfg.direct, cfg.bs, cfg.qd, cfg.read_pct, n, iops, mbps,
+               pct_us(job.lat_ns, n, 0.50), pct_us(job.lat_ns, n, 0.90),
+               pct_us(job.lat_ns, n, 0.99), pct_us(job.lat_ns, n, 0.999),
+               job.lat_ns[n - 1] / 1e3, cfg.sync_range ? "range" : "full",
+               cfg.sync_every);
+    }
+
+out:
+    if (job.map != NULL) munmap(job.map, cfg.file_size);
+    if (job.fd >= 0) close(job.fd);
+    unlink(filename);
+    free(job.lat_ns);
+    free(job.buf);
+}
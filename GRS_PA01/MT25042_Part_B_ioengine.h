@@ -0,0 +1,59 @@
+/**
+ * MT25042_Part_B_ioengine.h
+ * Graduate Systems (CSE638) - PA01: Processes and Threads
+ *
+ * Block I/O engine for the I/O worker
+ *
+ * Instead of write/fsync/read of one 1 MB file per iteration, each worker
+ * issues PA01_IO_OPS block-sized reads and writes against its own
+ * preallocated file and times every one of them:
+ *
+ *   uring     io_uring with up to PA01_IO_QD requests in flight, buffers
+ *             and the file registered with the ring (READ_FIXED /
+ *             WRITE_FIXED on a fixed file), O_DIRECT unless PA01_IO_DIRECT=0
+ *   direct    pread/pwrite with O_DIRECT, one request at a time
+ *   buffered  pread/pwrite through the page cache, one request at a time
+ *   mmap      memcpy to/from a MAP_SHARED mapping of the file, madvise
+ *             hint from PA01_IO_PATTERN
+ *
+ * The file is preallocated once with fallocate and reused for every
+ * request.  Except for uring, writes are flushed in batches:
+ * fdatasync (msync for mmap) every PA01_IO_SYNC_EVERY writes, or
+ * sync_file_range of the batch's range with PA01_IO_SYNC=range.
+ *
+ * Environment (the engine is enabled by PA01_IO_ENGINE):
+ *   PA01_IO_ENGINE=uring|direct|buffered|mmap
+ *   PA01_IO_BS=4K           block size (multiple of 4K for O_DIRECT)
+ *   PA01_IO_QD=32           requests in flight (uring only)
+ *   PA01_IO_READ=50         percentage of reads, the rest are writes
+ *   PA01_IO_PATTERN=rand    rand | seq offsets
+ *   PA01_IO_FILE_SIZE=64M   size of each worker's file
+ *   PA01_IO_OPS=64K         requests per worker
+ *   PA01_IO_DIR=/tmp        where the files go (O_DIRECT needs a real
+ *                           filesystem, not tmpfs)
+ *   PA01_IO_DIRECT=0        uring through the page cache
+ *   PA01_IO_SYNC_EVERY=0    writes per flush (0: one flush at the end)
+ *   PA01_IO_SYNC=full       full | range (sync_file_range, not durable
+ *                           for metadata or a volatile device cache)
+ *   PA01_IO_POPULATE=1      mmap with MAP_POPULATE
+ *
+ * Output, one line per worker (latency from submission to completion):
+ *   IOENGINE,<pid>,<tid>,<engine>,<direct>,<bs>,<qd>,<read_pct>,<ops>,
+ *            <iops>,<mb_per_s>,<p50_us>,<p90_us>,<p99_us>,<p999_us>,<max_us>,
+ *            <sync>,<sync_every>
+ *
+ * AI Declaration: This code structure was generated with AI assistance;
+ *   follows io_uring_setup(2), io_uring_enter(2) and io_uring_register(2);
+ *   no liburing.
+ */
+
+#ifndef IOENGINE_H
+#define IOENGINE_H
+
+/* Non-zero if PA01_IO_ENGINE is set */
+int ioengine_enabled(void);
+
+/* Runs the configured engine on `filename` and prints the results */
+void ioengine_run(const char *filename);
+
+#endif /* IOENGINE_H */
@@ -0,0 +1,326 @@
+/**
+ * MT25042_Part_B_memalloc.c
+ * Graduate Systems (CSE638) - PA01: Processes and Threads
+ *
+ * NUMA policy / page size allocator, placement report and dTLB counter
+ * for the memory worker (see MT25042_Part_B_memalloc.h).
+ *
+ * AI Declaration: This code structure was generated with AI assistance;
+ *   follows the mbind(2), move_pages(2) and perf_event_open(2) man pages.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+#include <linux/perf_event.h>
+#include "MT25042_Part_B_memalloc.h"
+
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+#ifndef MAP_HUGE_2MB
+#define MAP_HUGE_2MB (21 << MAP_HUGE_SHIFT)
+#endif
+#ifndef MAP_HUGE_1GB
+#define MAP_HUGE_1GB (30 << MAP_HUGE_SHIFT)
+#endif
+
+#define SIZE_4K         4096UL
+#define SIZE_2M         (2UL * 1024 * 1024)
+#define SIZE_1G         (1024UL * 1024 * 1024)
+#define MAX_NODES       64                  /* one unsigned long of mask */
+#define QUERY_BATCH     512                 /* pages per move_pages call */
+
+typedef enum { PAGES_4K, PAGES_THP, PAGES_2M, PAGES_1G } page_kind_t;
+
+static const char *page_names[] = { "4k", "thp", "2m", "1g" };
+
+static struct {
+    int           mode;                     /* MPOL_*, -1 for default */
+    unsigned long nodemask;
+    page_kind_t   pages;
+    char          name[32];
+} cfg;
+
+static pthread_once_t cfg_once = PTHREAD_ONCE_INIT;
+
+/*------------------------------------------------------------------------------
+ * Configuration
+ *----------------------------------------------------------------------------*/
+
+/* Online nodes from sysfs ("0", "0-1", "0,2-3"); node 0 if unreadable */
+static unsigned long online_nodes(void) {
+    unsigned long mask = 0;
+    char buf[256];
+    FILE *f = fopen("/sys/devices/system/node/online", "r");
+
+    if (f != NULL) {
+        if (fgets(buf, sizeof(buf), f) != NULL) {
+            for (char *tok = strtok(buf, ",\n"); tok; tok = strtok(NULL, ",\n")) {
+                int lo, hi;
+                int n = sscanf(tok, "%d-%d", &lo, &hi);
+                if (n < 1) continue;
+                if (n == 1) hi = lo;
+                for (int i = lo; i <= hi && i < MAX_NODES; i++) mask |= 1UL << i;
+            }
+        }
+        fclose(f);
+    }
+    return mask ? mask : 1UL;
+}
+
+static void load_config(void) {
+    const char *policy = getenv("PA01_MEM_POLICY");
+    const char *pages = getenv("PA01_MEM_PAGES");
+
+    cfg.mode = -1;
+    cfg.nodemask = 0;
+    snprintf(cfg.name, sizeof(cfg.name), "default");
+
+    if (policy == NULL || *policy == '\0' || strcmp(policy, "default") == 0) {
+        /* first touch */
+    } else if (strcmp(policy, "local") == 0) {
+        cfg.mode = MPOL_LOCAL;
+        snprintf(cfg.name, sizeof(cfg.name), "local");
+    } else if (strcmp(policy, "interleave") == 0) {
+        cfg.mode = MPOL_INTERLEAVE;
+        cfg.nodemask = online_nodes();
+        snprintf(cfg.name, sizeof(cfg.name), "interleave");
+    } else if (strncmp(policy, "bind:", 5) == 0 && policy[5] != '\0') {
+        int node = atoi(policy + 5);
+        if (node >= 0 && node < MAX_NODES && (online_nodes() & (1UL << node))) {
+            cfg.mode = MPOL_BIND;
+            cfg.nodemask = 1UL << node;
+            snprintf(cfg.name, sizeof(cfg.name), "bind:%d", node);
+        } else {
+            fprintf(stderr, "    [MEM Worker] PA01_MEM_POLICY=%s: node not online, "
+                    "using default\n", policy);
+        }
+    } else {
+        fprintf(stderr, "    [MEM Worker] PA01_MEM_POLICY=%s unknown, using default\n",
+                policy);
+    }
+
+    cfg.pages = PAGES_4K;
+    if (pages != NULL && *pages != '\0') {
+        int found = 0;
+        for (int i = 0; i <= PAGES_1G; i++) {
+            if (strcmp(pages, page_names[i]) == 0) {
+                cfg.pages = (page_kind_t)i;
+                found = 1;
+            }
+        }
+        if (!found) {
+            fprintf(stderr, "    [MEM Worker] PA01_MEM_PAGES=%s unknown, using 4k\n",
+                    pages);
+        }
+    }
+}
+
+const char *mem_policy_name(void) {
+    pthread_once(&cfg_once, load_config);
+    return cfg.name;
+}
+
+int mem_placement_requested(void) {
+    const char *policy = getenv("PA01_MEM_POLICY");
+    const char *pages = getenv("PA01_MEM_PAGES");
+    return (policy != NULL && *policy != '\0') || (pages != NULL && *pages != '\0');
+}
+
+/*------------------------------------------------------------------------------
+ * Allocation
+ *----------------------------------------------------------------------------*/
+
+static size_t round_up(size_t v, size_t align) {
+    return (v + align - 1) & ~(align - 1);
+}
+
+/* 2 MB aligned anonymous mapping marked for transparent hugepages */
+static void *map_thp(size_t len) {
+    size_t span = len + SIZE_2M;
+    uint8_t *p = mmap(NULL, span, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) return NULL;
+
+    uint8_t *aligned = (uint8_t *)round_up((uintptr_t)p, SIZE_2M);
+    if (aligned > p) munmap(p, aligned - p);
+    if (aligned + len < p + span) munmap(aligned + len, p + span - (aligned + len));
+
+    /* Only a hint: with THP disabled the pages stay 4k */
+    madvise(aligned, len, MADV_HUGEPAGE);
+    return aligned;
+}
+
+int mem_region_alloc(mem_region_t *r, size_t size) {
+    pthread_once(&cfg_once, load_config);
+
+    page_kind_t kind = cfg.pages;
+    void *p = NULL;
+
+    r->size = size;
+    if (kind == PAGES_2M || kind == PAGES_1G) {
+        size_t page = kind == PAGES_2M ? SIZE_2M : SIZE_1G;
+        r->mapped = round_up(size, page);
+        p = mmap(NULL, r->mapped, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB |
+                 (kind == PAGES_2M ? MAP_HUGE_2MB : MAP_HUGE_1GB), -1, 0);
+        if (p == MAP_FAILED) {
+            static int warned;
+            if (!__atomic_exchange_n(&warned, 1, __ATOMIC_RELAXED)) {
+                fprintf(stderr, "    [MEM Worker] No %s hugetlb pages (%s), using thp\n",
+                        page_names[kind], strerror(errno));
+            }
+            p = NULL;
+            kind = PAGES_THP;
+        }
+    }
+    if (kind == PAGES_THP) {
+        r->mapped = round_up(size, SIZE_2M);
+        p = map_thp(r->mapped);
+    } else if (kind == PAGES_4K) {
+        r->mapped = round_up(size, SIZE_4K);
+        p = mmap(NULL, r->mapped, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) p = NULL;
+    }
+    if (p == NULL) return -1;
+
+    /* Before the first touch, so every page is placed by the policy */
+    if (cfg.mode >= 0) {
+        unsigned long *mask = cfg.nodemask ? &cfg.nodemask : NULL;
+        if (syscall(SYS_mbind, p, r->mapped, cfg.mode, mask,
+                    mask ? MAX_NODES + 1 : 0, 0) != 0) {
+            fprintf(stderr, "    [MEM Worker] mbind(%s) failed: %s\n",
+                    cfg.name, strerror(errno));
+        }
+    }
+
+    r->addr = p;
+    r->pages = page_names[kind];
+    return 0;
+}
+
+void mem_region_free(mem_region_t *r) {
+    if (r->addr != NULL) munmap(r->addr, r->mapped);
+    r->addr = NULL;
+}
+
+/*------------------------------------------------------------------------------
+ * Placement report
+ *----------------------------------------------------------------------------*/
+
+/* Node of every resident 4k page of the region (hugepages report the
+ * node of the page they are part of) */
+static void count_nodes(const mem_region_t *r, mem_placement_t *p) {
+    void *pages[QUERY_BATCH];
+    int status[QUERY_BATCH];
+    size_t npages = r->mapped / SIZE_4K;
+
+    for (size_t base = 0; base < npages; base += QUERY_BATCH) {
+        size_t n = npages - base < QUERY_BATCH ? npages - base : QUERY_BATCH;
+        for (size_t i = 0; i < n; i++) {
+            pages[i] = r->addr + (base + i) * SIZE_4K;
+        }
+        if (syscall(SYS_move_pages, 0, n, pages, NULL, status, 0) != 0) return;
+        for (size_t i = 0; i < n; i++) {
+            if (status[i] < 0) continue;             /* not resident */
+            if (status[i] == p->cpu_node) p->local_kb += SIZE_4K / 1024;
+            else p->remote_kb += SIZE_4K / 1024;
+        }
+    }
+}
+
+/* Bytes of [lo, hi) covered by the regions */
+static size_t overlap(const mem_region_t *regions, int n, uintptr_t lo,
+                      uintptr_t hi) {
+    size_t bytes = 0;
+    for (int i = 0; i < n; i++) {
+        uintptr_t a = (uintptr_t)regions[i].addr;
+        uintptr_t b = a + regions[i].mapped;
+        if (a < lo) a = lo;
+        if (b > hi) b = hi;
+        if (a < b) bytes += b - a;
+    }
+    return bytes;
+}
+
+/* AnonHugePages of the VMAs holding the THP regions.  Adjacent mappings
+ * may be merged into one VMA, so each VMA is capped at its overlap with
+ * the regions (exact for one worker, an upper bound with several). */
+static long thp_kb(const mem_region_t *regions, int n) {
+    FILE *f = fopen("/proc/self/smaps", "r");
+    if (f == NULL) return 0;
+
+    char line[256];
+    size_t vma_overlap = 0;
+    long total = 0, kb;
+    unsigned long lo, hi;
+
+    while (fgets(line, sizeof(line), f) != NULL) {
+        if (sscanf(line, "%lx-%lx ", &lo, &hi) == 2) {
+            vma_overlap = overlap(regions, n, lo, hi);
+        } else if (vma_overlap > 0 &&
+                   sscanf(line, "AnonHugePages: %ld kB", &kb) == 1) {
+            long cap = (long)(vma_overlap / 1024);
+            total += kb < cap ? kb : cap;
+        }
+    }
+    fclose(f);
+    return total;
+}
+
+void mem_placement(const mem_region_t *regions, int n, mem_placement_t *p) {
+    unsigned cpu = 0, node = 0;
+
+    memset(p, 0, sizeof(*p));
+    if (syscall(SYS_getcpu, &cpu, &node, NULL) == 0) p->cpu_node = (int)node;
+
+    mem_region_t thp[n > 0 ? n : 1];
+    int nthp = 0;
+    for (int i = 0; i < n; i++) {
+        count_nodes(&regions[i], p);
+        if (strcmp(regions[i].pages, "thp") == 0) thp[nthp++] = regions[i];
+        else if (strcmp(regions[i].pages, "4k") != 0) {
+            p->huge_kb += (long)(regions[i].mapped / 1024);
+        }
+    }
+    if (nthp > 0) p->huge_kb += thp_kb(thp, nthp);
+}
+
+/*------------------------------------------------------------------------------
+ * dTLB misses
+ *----------------------------------------------------------------------------*/
+
+int mem_tlb_open(void) {
+    struct perf_event_attr attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.config = PERF_COUNT_HW_CACHE_DTLB |
+                  (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                  (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    attr.exclude_kernel = 1;                /* allowed at paranoid level 2 */
+    attr.exclude_hv = 1;
+
+    int fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    return fd >= 0 ? fd : -1;
+}
+
+long long mem_tlb_read(int fd) {
+    if (fd < 0) return -1;
+
+    uint64_t count;
+    ssize_t n = read(fd, &count, sizeof(count));
+    close(fd);
+    return n == (ssize_t)sizeof(count) ? (long long)count : -1;
+}
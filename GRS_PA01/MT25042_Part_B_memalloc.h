@@ -0,0 +1,75 @@
+/**
+ * MT25042_Part_B_memalloc.h
+ * Graduate Systems (CSE638) - PA01: Processes and Threads
+ *
+ * NUMA placement and page size of the memory worker's arrays
+ *
+ * Each array is its own anonymous mapping.  The NUMA policy is applied to
+ * the mapping with mbind() before anything touches it (set_mempolicy()
+ * would also move the thread's stack and libc allocations), and the page
+ * size is chosen when it is mapped.  The worker that owns the arrays
+ * touches them first, so under the default policy every process/thread
+ * gets its pages on the node it runs on, in parallel.
+ *
+ * Environment:
+ *   PA01_MEM_POLICY=default|local|interleave|bind:<node>
+ *       default     first touch (the kernel's default)
+ *       local       MPOL_LOCAL: node of the CPU that faults the page in
+ *       interleave  round robin over all online nodes
+ *       bind:<node> MPOL_BIND to one node
+ *   PA01_MEM_PAGES=4k|thp|2m|1g
+ *       thp         2 MB aligned, madvise(MADV_HUGEPAGE)
+ *       2m / 1g     MAP_HUGETLB from the reserved pool (vm.nr_hugepages),
+ *                   falls back to thp if the pool is empty
+ *
+ * No libnuma: mbind, move_pages and getcpu are called through syscall().
+ *
+ * AI Declaration: This code structure was generated with AI assistance;
+ *   follows the mbind(2), move_pages(2) and perf_event_open(2) man pages.
+ */
+
+#ifndef MEMALLOC_H
+#define MEMALLOC_H
+
+#include <stddef.h>
+
+typedef struct {
+    unsigned char *addr;
+    size_t size;                       /* bytes requested                */
+    size_t mapped;                     /* bytes mapped (page multiple)   */
+    const char *pages;                 /* 4k, thp, 2m, 1g as obtained    */
+} mem_region_t;
+
+typedef struct {
+    int  cpu_node;                     /* node the caller runs on        */
+    long local_kb;                     /* resident on cpu_node           */
+    long remote_kb;                    /* resident on any other node     */
+    long huge_kb;                      /* backed by 2 MB / 1 GB pages    */
+} mem_placement_t;
+
+/* PA01_MEM_POLICY as parsed, e.g. "interleave" or "bind:1" */
+const char *mem_policy_name(void);
+
+/* Non-zero if PA01_MEM_POLICY or PA01_MEM_PAGES is set: only then does
+ * the worker probe and report placement (it costs time in the run) */
+int mem_placement_requested(void);
+
+/* Maps `size` bytes with PA01_MEM_PAGES pages and PA01_MEM_POLICY
+ * applied, untouched.  Returns 0, or -1 with errno set. */
+int mem_region_alloc(mem_region_t *r, size_t size);
+
+void mem_region_free(mem_region_t *r);
+
+/* Where the resident pages of regions[0 .. n) are, relative to the
+ * caller's current node (move_pages) and how many are huge (smaps) */
+void mem_placement(const mem_region_t *regions, int n, mem_placement_t *p);
+
+/* Counts the calling thread's user-space dTLB load misses from now on.
+ * Returns a descriptor for mem_tlb_read(), or -1 if the PMU is not
+ * available (VMs, perf_event_paranoid > 2). */
+int mem_tlb_open(void);
+
+/* Misses since mem_tlb_open() and closes fd; -1 if fd is -1 */
+long long mem_tlb_read(int fd);
+
+#endif /* MEMALLOC_H */
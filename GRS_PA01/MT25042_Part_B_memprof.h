@@ -0,0 +1,36 @@
+/**
+ * MT25042_Part_B_memprof.h
+ * Graduate Systems (CSE638) - PA01: Processes and Threads
+ *
+ * Memory hierarchy profiler for the memory worker
+ *
+ * Sweeps the working set in powers of two and times one access pattern
+ * at a time over it, then groups the results by the cache level (from
+ * sysfs) the working set fits in.
+ *
+ * Environment (profiling is enabled by PA01_MEM_PROFILE):
+ *   PA01_MEM_PROFILE=all | seq,stride,chase,gather,scatter
+ *   PA01_MEM_MIN=4K        smallest working set (K/M/G suffixes)
+ *   PA01_MEM_MAX=4G        largest working set (mapped once per worker)
+ *   PA01_MEM_STRIDE=64     bytes between accesses of "stride"
+ *   PA01_MEM_ACCESSES=4M   minimum accesses timed per point
+ *
+ * Output, one line per point and one per (pattern, level):
+ *   MEMPROF,<pid>,<tid>,<pattern>,<ws_bytes>,<level>,<ns_per_access>,<gb_per_s>
+ *   MEMLEVEL,<pid>,<tid>,<pattern>,<level>,<level_bytes>,<ns_per_access>,<gb_per_s>
+ *
+ * AI Declaration: This code structure was generated with AI assistance;
+ *   the pointer chase uses Sattolo's algorithm so the chain is one cycle
+ *   through every node.
+ */
+
+#ifndef MEMPROF_H
+#define MEMPROF_H
+
+/* Non-zero if PA01_MEM_PROFILE is set */
+int memprof_enabled(void);
+
+/* Runs the sweep configured by PA01_MEM_* and prints the results */
+void memprof_run(void);
+
+#endif /* MEMPROF_H */
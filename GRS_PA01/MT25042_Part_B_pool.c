@@ -0,0 +1,436 @@
+/**
+ * MT25042_Part_B_pool.c
+ * Graduate Systems (CSE638) - PA01: Processes and Threads
+ *
+ * Pre-forked worker pool: shared task queue, result table and the
+ * parent's aggregation (see MT25042_Part_B_pool.h).
+ *
+ * AI Declaration: Queue follows D. Vyukov's bounded MPMC queue
+ *   (1024cores.net); futex use from futex(2).
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <sched.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <linux/futex.h>
+#include "MT25042_Part_B_pool.h"
+#include "MT25042_Part_B_workers.h"
+#include "MT25042_Part_B_util.h"
+
+#define CACHE_LINE     64
+#define QUEUE_SLOTS    256              /* power of two */
+#define TASK_STOP      (-1)             /* tells a pool worker to exit */
+#define READY_POLL_MS  100              /* parent checks for dead workers */
+
+/* One queue slot; seq says whose turn it is (Vyukov) */
+typedef struct {
+    long seq;
+    long task;
+} pool_cell_t;
+
+/* One task: its iterations, and what the worker filled in */
+typedef struct {
+    int      begin;
+    int      end;
+    int      worker;
+    double   value;
+    uint64_t queued_ns;
+    uint64_t start_ns;
+    uint64_t end_ns;
+} pool_task_t;
+
+typedef struct {
+    pid_t    pid;
+    long     tasks;
+    uint64_t busy_ns;
+} __attribute__((aligned(CACHE_LINE))) pool_worker_t;
+
+/* Everything the parent and the children share, in one MAP_SHARED mapping */
+typedef struct {
+    long        enq __attribute__((aligned(CACHE_LINE)));
+    long        deq __attribute__((aligned(CACHE_LINE)));
+    uint32_t    posted __attribute__((aligned(CACHE_LINE)));  /* futex */
+    uint32_t    sleepers;
+    uint32_t    ready __attribute__((aligned(CACHE_LINE)));   /* futex */
+    pool_cell_t cells[QUEUE_SLOTS] __attribute__((aligned(CACHE_LINE)));
+    int            workers;
+    int            ntasks;
+    int            iters;
+    size_t         size;
+    pool_task_t   *tasks;
+    pool_worker_t *stats;
+} __attribute__((aligned(CACHE_LINE))) pool_t;   /* stats, tasks follow */
+
+/* A worker's claim() context */
+typedef struct {
+    pool_t     *pool;
+    work_src_t *src;
+    int         id;
+    long        task;                    /* running, or -1 */
+    double      value0;                  /* src->value when it started */
+    int         ready;                   /* setup done, told the parent */
+} pool_src_t;
+
+static int env_int(const char *name, int def) {
+    const char *s = getenv(name);
+    return s != NULL && atoi(s) > 0 ? atoi(s) : def;
+}
+
+/* Shared (not FUTEX_PRIVATE) futexes: the word is in a MAP_SHARED page */
+static void futex_wait(uint32_t *addr, uint32_t val, const struct timespec *timeout) {
+    syscall(SYS_futex, addr, FUTEX_WAIT, val, timeout, NULL, 0);
+}
+
+static void futex_wake(uint32_t *addr, int n) {
+    syscall(SYS_futex, addr, FUTEX_WAKE, n, NULL, NULL, 0);
+}
+
+int pool_enabled(void) {
+    return env_int("PA01_POOL_TASKS", 0) > 0;
+}
+
+/*------------------------------------------------------------------------------
+ * Task queue
+ *----------------------------------------------------------------------------*/
+
+/* 0 if full */
+static int queue_push(pool_t *p, long task) {
+    long pos = __atomic_load_n(&p->enq, __ATOMIC_RELAXED);
+    pool_cell_t *c;
+
+    for (;;) {
+        c = &p->cells[pos & (QUEUE_SLOTS - 1)];
+        long dif = __atomic_load_n(&c->seq, __ATOMIC_ACQUIRE) - pos;
+        if (dif == 0) {
+            if (__atomic_compare_exchange_n(&p->enq, &pos, pos + 1, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (dif < 0) {
+            return 0;
+        } else {
+            pos = __atomic_load_n(&p->enq, __ATOMIC_RELAXED);
+        }
+    }
+    c->task = task;
+    __atomic_store_n(&c->seq, pos + 1, __ATOMIC_RELEASE);
+    return 1;
+}
+
+/* 0 if empty */
+static int queue_pop(pool_t *p, long *task) {
+    long pos = __atomic_load_n(&p->deq, __ATOMIC_RELAXED);
+    pool_cell_t *c;
+
+    for (;;) {
+        c = &p->cells[pos & (QUEUE_SLOTS - 1)];
+        long dif = __atomic_load_n(&c->seq, __ATOMIC_ACQUIRE) - (pos + 1);
+        if (dif == 0) {
+            if (__atomic_compare_exchange_n(&p->deq, &pos, pos + 1, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (dif < 0) {
+            return 0;
+        } else {
+            pos = __atomic_load_n(&p->deq, __ATOMIC_RELAXED);
+        }
+    }
+    *task = c->task;
+    __atomic_store_n(&c->seq, pos + QUEUE_SLOTS, __ATOMIC_RELEASE);
+    return 1;
+}
+
+/* Producer: queue a task (waiting while the ring is full), wake a sleeper */
+static void pool_post(pool_t *p, long task) {
+    while (!queue_push(p, task)) sched_yield();
+    __atomic_fetch_add(&p->posted, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&p->sleepers, __ATOMIC_SEQ_CST) > 0) {
+        futex_wake(&p->posted, 1);
+    }
+}
+
+/* Consumer: next task, sleeping while there is none.  A post between
+ * reading `posted` and FUTEX_WAIT changes the word, so it is not lost */
+static long pool_take(pool_t *p) {
+    long task;
+    for (;;) {
+        uint32_t seen = __atomic_load_n(&p->posted, __ATOMIC_SEQ_CST);
+        if (queue_pop(p, &task)) return task;
+        __atomic_fetch_add(&p->sleepers, 1, __ATOMIC_SEQ_CST);
+        futex_wait(&p->posted, seen, NULL);
+        __atomic_fetch_sub(&p->sleepers, 1, __ATOMIC_SEQ_CST);
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * Workers
+ *----------------------------------------------------------------------------*/
+
+/* Closes the running task: result, end time, and the worker's totals */
+static void task_finish(pool_src_t *w) {
+    pool_task_t *t = &w->pool->tasks[w->task];
+    pool_worker_t *st = &w->pool->stats[w->id];
+
+    t->end_ns = now_ns();
+    t->value = w->src->value - w->value0;
+    t->worker = w->id;
+    st->tasks++;
+    st->busy_ns += t->end_ns - t->start_ns;
+    w->task = -1;
+}
+
+static void task_start(pool_src_t *w, long task, int *begin, int *end) {
+    pool_task_t *t = &w->pool->tasks[task];
+
+    t->start_ns = now_ns();
+    w->task = task;
+    w->value0 = w->src->value;
+    *begin = t->begin;
+    *end = t->end;
+}
+
+/* claim() of a pool worker: called when a task's iterations are used up.
+ * The first call comes after the worker's setup (buffers, files), which
+ * is done once and shared by all its tasks */
+static int claim_task(void *ctx, int *begin, int *end) {
+    pool_src_t *w = ctx;
+    pool_t *p = w->pool;
+
+    if (w->task >= 0) {
+        task_finish(w);
+    } else if (!w->ready) {
+        w->ready = 1;
+        __atomic_fetch_add(&p->ready, 1, __ATOMIC_SEQ_CST);
+        futex_wake(&p->ready, 1);
+    }
+    long task = pool_take(w->pool);
+    if (task == TASK_STOP) return 0;
+    task_start(w, task, begin, end);
+    return 1;
+}
+
+/* Child body in pool mode */
+static void pool_worker(pool_t *p, int id, const char *worker_type) {
+    work_src_t src = { claim_task, NULL, 0, 0, 0.0 };
+    pool_src_t w = { p, &src, id, -1, 0.0, 0 };
+    src.ctx = &w;
+
+    p->stats[id].pid = getpid();
+    worker_run_share(worker_type, &src);
+}
+
+/* Child body in fork mode: exactly one task */
+static void fork_worker(pool_t *p, int id, long task, const char *worker_type) {
+    work_src_t src = { NULL, NULL, 0, 0, 0.0 };
+    pool_src_t w = { p, &src, id, -1, 0.0, 1 };
+
+    p->stats[id].pid = getpid();
+    task_start(&w, task, &src.next, &src.end);
+    worker_run_share(worker_type, &src);
+    task_finish(&w);
+}
+
+/*------------------------------------------------------------------------------
+ * Parent
+ *----------------------------------------------------------------------------*/
+
+static pool_t *pool_create(int workers) {
+    int ntasks = env_int("PA01_POOL_TASKS", 0);
+    size_t size = sizeof(pool_t) + (size_t)workers * sizeof(pool_worker_t) +
+                  (size_t)ntasks * sizeof(pool_task_t);
+
+    pool_t *p = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) {
+        perror("mmap failed");
+        return NULL;
+    }
+    memset(p, 0, size);
+
+    for (long i = 0; i < QUEUE_SLOTS; i++) p->cells[i].seq = i;
+    p->workers = workers;
+    p->ntasks = ntasks;
+    p->iters = env_int("PA01_POOL_ITERS", 1);
+    p->size = size;
+    p->stats = (pool_worker_t *)(p + 1);
+    p->tasks = (pool_task_t *)(p->stats + workers);
+
+    for (int i = 0; i < ntasks; i++) {
+        p->tasks[i].begin = (int)(((long)i * p->iters) % LOOP_COUNT);
+        p->tasks[i].end = p->tasks[i].begin + p->iters;
+        p->tasks[i].worker = -1;
+    }
+    return p;
+}
+
+/* Kills and reaps the whole pool, when a worker died during setup */
+static int pool_abort(pool_t *p, int forked) {
+    fprintf(stderr, "[Pool] a worker exited before it was ready, aborting\n");
+    for (int i = 0; i < forked; i++) kill(p->stats[i].pid, SIGKILL);
+    while (wait(NULL) > 0) { }
+    return -1;
+}
+
+/* Forks the pool, waits until every worker is set up, then queues the
+ * tasks (from *start_ns on).  A worker that dies before it is ready
+ * (failed allocation, crash) never bumps `ready`, so the wait wakes up
+ * every READY_POLL_MS to look for one and gives up on the pool */
+static int run_pool(pool_t *p, const char *worker_type, double *spawn_ms,
+                    uint64_t *start_ns) {
+    uint64_t t0 = now_ns();
+
+    for (int i = 0; i < p->workers; i++) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            perror("fork failed");
+            return pool_abort(p, i);
+        }
+        if (pid == 0) {
+            pool_worker(p, i, worker_type);
+            exit(EXIT_SUCCESS);
+        }
+        p->stats[i].pid = pid;
+    }
+
+    const struct timespec poll = { 0, READY_POLL_MS * 1000000L };
+    uint32_t ready;
+    while ((ready = __atomic_load_n(&p->ready, __ATOMIC_SEQ_CST)) < (uint32_t)p->workers) {
+        if (waitpid(-1, NULL, WNOHANG) > 0) return pool_abort(p, p->workers);
+        futex_wait(&p->ready, ready, &poll);
+    }
+    *start_ns = now_ns();
+    *spawn_ms = (*start_ns - t0) / 1e6;
+
+    for (long t = 0; t < p->ntasks; t++) {
+        p->tasks[t].queued_ns = now_ns();
+        pool_post(p, t);
+    }
+    for (int i = 0; i < p->workers; i++) pool_post(p, TASK_STOP);
+
+    while (wait(NULL) > 0) { }
+    return 0;
+}
+
+/* One child per task, at most p->workers at a time */
+static int run_fork(pool_t *p, const char *worker_type) {
+    pid_t *slots = calloc(p->workers, sizeof(pid_t));
+    if (slots == NULL) {
+        perror("calloc failed");
+        return -1;
+    }
+
+    int running = 0;
+    for (long t = 0; t < p->ntasks; t++) {
+        int id = running;
+        if (running == p->workers) {
+            pid_t done = wait(NULL);
+            for (id = 0; id < p->workers && slots[id] != done; id++) { }
+            if (id == p->workers) {
+                free(slots);
+                return -1;
+            }
+        } else {
+            running++;
+        }
+
+        p->tasks[t].queued_ns = now_ns();
+        pid_t pid = fork();
+        if (pid < 0) {
+            perror("fork failed");
+            free(slots);
+            return -1;
+        }
+        if (pid == 0) {
+            fork_worker(p, id, t, worker_type);
+            exit(EXIT_SUCCESS);
+        }
+        slots[id] = pid;
+    }
+
+    while (wait(NULL) > 0) { }
+    free(slots);
+    return 0;
+}
+
+static void pool_report(pool_t *p, const char *worker_type, const char *mode,
+                        const char *program, double spawn_ms, uint64_t start_ns) {
+    uint64_t *dispatch = malloc(p->ntasks * sizeof(uint64_t));
+    uint64_t *run = malloc(p->ntasks * sizeof(uint64_t));
+    uint64_t last_ns = start_ns;
+    double value = 0.0;
+    size_t done = 0;
+
+    if (dispatch == NULL || run == NULL) {
+        perror("malloc failed");
+        free(dispatch);
+        free(run);
+        return;
+    }
+
+    for (int i = 0; i < p->ntasks; i++) {
+        pool_task_t *t = &p->tasks[i];
+        if (t->worker < 0) continue;               /* never ran */
+        dispatch[done] = t->start_ns - t->queued_ns;
+        run[done] = t->end_ns - t->start_ns;
+        if (t->end_ns > last_ns) last_ns = t->end_ns;
+        value += t->value;
+        done++;
+    }
+    qsort(dispatch, done, sizeof(uint64_t), cmp_u64);
+    qsort(run, done, sizeof(uint64_t), cmp_u64);
+
+    for (int i = 0; i < p->workers; i++) {
+        printf("POOLWORKER,%s,%s,%d,%d,%ld,%.3f\n", program, worker_type,
+               i + 1, (int)p->stats[i].pid, p->stats[i].tasks,
+               p->stats[i].busy_ns / 1e9);
+    }
+
+    double elapsed = (last_ns - start_ns) / 1e9;
+    printf("[Pool] %s: %zu/%d tasks in %.3f s, dispatch p50 %.1f us, "
+           "result %.6f\n", mode, done, p->ntasks, elapsed,
+           pct_us(dispatch, done, 0.50), value);
+    printf("POOL,%s,%s,%s,%d,%d,%d,%.3f,%.3f,%.1f,%.1f,%.1f,%.3f,%.3f,%.6f\n",
+           program, worker_type, mode, p->workers, p->ntasks, p->iters,
+           spawn_ms, elapsed, elapsed > 0 ? done / elapsed : 0.0,
+           pct_us(dispatch, done, 0.50), pct_us(dispatch, done, 0.99),
+           pct_us(run, done, 0.50) / 1e3, pct_us(run, done, 0.99) / 1e3, value);
+
+    free(dispatch);
+    free(run);
+}
+
+int pool_run(const char *worker_type, int workers, const char *program) {
+    const char *mode = getenv("PA01_POOL_MODE");
+    int forking = mode != NULL && strcmp(mode, "fork") == 0;
+    mode = forking ? "fork" : "pool";
+
+    pool_t *p = pool_create(workers);
+    if (p == NULL) return -1;
+
+    printf("[Pool] %d tasks of %d iteration(s) of '%s' on %d %s\n",
+           p->ntasks, p->iters, worker_type, workers,
+           forking ? "fresh children (one per task)" : "pre-forked workers");
+    flush_before_fork();
+
+    double spawn_ms = 0.0;
+    uint64_t start_ns = now_ns();
+    int ret = forking ? run_fork(p, worker_type)
+                      : run_pool(p, worker_type, &spawn_ms, &start_ns);
+    if (ret == 0) {
+        pool_report(p, worker_type, mode, program, spawn_ms, start_ns);
+    }
+
+    munmap(p, p->size);
+    return ret;
+}
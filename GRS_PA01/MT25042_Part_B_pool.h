@@ -0,0 +1,47 @@
+/**
+ * MT25042_Part_B_pool.h
+ * Graduate Systems (CSE638) - PA01: Processes and Threads
+ *
+ * Pre-forked process pool for Program A
+ *
+ * A forked child normally runs its whole worker and only hands back an
+ * exit status.  In pool mode the children are forked once and then run
+ * many short tasks (PA01_POOL_ITERS loop iterations each) they take from
+ * a lock-free queue in shared memory.  Each task's result (the work_src_t
+ * value, see MT25042_Part_B_workers.h) and timestamps go into a
+ * MAP_SHARED table that the parent aggregates once the children exit.
+ *
+ *   pool  workers forked once, tasks through a bounded MPMC ring
+ *         (Vyukov); idle workers sleep on a futex in the shared page
+ *   fork  same tasks and table, but one fresh child per task with at
+ *         most <workers> alive, to measure what the pool saves
+ *
+ * Environment:
+ *   PA01_POOL_TASKS=<n>      enables it: number of tasks
+ *   PA01_POOL_ITERS=1        loop iterations per task
+ *   PA01_POOL_MODE=pool      pool | fork
+ *
+ * Output (dispatch = task queued to task started, which includes the
+ * fork in fork mode; spawn = pool creation until every worker is ready):
+ *   POOLWORKER,<program>,<worker_type>,<id>,<pid>,<tasks>,<busy_s>
+ *   POOL,<program>,<worker_type>,<mode>,<workers>,<tasks>,<task_iters>,
+ *        <spawn_ms>,<elapsed_s>,<tasks_per_s>,<dispatch_p50_us>,
+ *        <dispatch_p99_us>,<task_p50_ms>,<task_p99_ms>,<result>
+ *
+ * AI Declaration: Queue follows D. Vyukov's bounded MPMC queue
+ *   (1024cores.net); futex use from futex(2).
+ */
+
+#ifndef POOL_H
+#define POOL_H
+
+/* Non-zero if PA01_POOL_TASKS is set */
+int pool_enabled(void);
+
+/**
+ * Runs PA01_POOL_TASKS tasks of `worker_type` on `workers` child
+ * processes and prints the POOLWORKER and POOL lines.  0 on success.
+ */
+int pool_run(const char *worker_type, int workers, const char *program);
+
+#endif /* POOL_H */
@@ -0,0 +1,248 @@
+/**
+ * MT25042_Part_B_scaling.c
+ * Graduate Systems (CSE638) - PA01: Processes and Threads
+ *
+ * Shared chunk counter (Program A), work-stealing deques (Program B) and
+ * the load balance report of the strong scaling mode
+ * (see MT25042_Part_B_scaling.h).
+ *
+ * AI Declaration: Deque follows Chase and Lev, "Dynamic Circular
+ *   Work-Stealing Deque" (SPAA 2005), without the push/grow half.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include "MT25042_Part_B_scaling.h"
+#include "MT25042_Part_B_util.h"
+
+#define CACHE_LINE     64
+#define DEFAULT_CHUNK  8
+#define DEQUE_EMPTY    (-1)
+#define DEQUE_ABORT    (-2)             /* lost a race, try again */
+
+/*
+ * Chunks are numbered 0 .. nchunks-1 and each deque starts out as one
+ * contiguous block of them.  Nothing is pushed after that, so a deque is
+ * just the range [top, bottom): the owner takes bottom - 1, thieves take
+ * top.  Each sits on its own cache line.
+ */
+typedef struct {
+    long top;
+    long bottom;
+} __attribute__((aligned(CACHE_LINE))) scale_deque_t;
+
+/* Per-worker statistics (and the deque source's context) */
+typedef struct {
+    scale_job_t *job;
+    int          id;
+    uint64_t     rnd;
+    long         iters;
+    long         chunks;
+    long         steals;
+    uint64_t     busy_ns;
+} __attribute__((aligned(CACHE_LINE))) scale_worker_t;
+
+struct scale_job {
+    long           next_chunk;           /* Program A counter */
+    char           pad[CACHE_LINE - sizeof(long)];
+    int            workers;
+    int            total;
+    int            chunk;
+    int            nchunks;
+    int            shared;
+    size_t         size;                 /* bytes mapped      */
+    uint64_t       start_ns;
+    char           worker_type[16];
+    scale_deque_t *deques;
+    scale_worker_t *stats;
+} __attribute__((aligned(CACHE_LINE)));  /* deques follow it */
+
+int scaling_enabled(void) {
+    const char *s = getenv("PA01_SCALE_TOTAL");
+    return s != NULL && atoi(s) > 0;
+}
+
+scale_job_t *scale_job_create(const char *worker_type, int workers, int shared) {
+    const char *chunk = getenv("PA01_SCALE_CHUNK");
+
+    /* Job, deques and statistics in one mapping (shared across fork) */
+    size_t size = sizeof(scale_job_t) +
+                  (size_t)workers * (sizeof(scale_deque_t) + sizeof(scale_worker_t));
+    scale_job_t *job = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                            (shared ? MAP_SHARED : MAP_PRIVATE) | MAP_ANONYMOUS,
+                            -1, 0);
+    if (job == MAP_FAILED) {
+        perror("mmap failed");
+        return NULL;
+    }
+    memset(job, 0, size);
+
+    job->workers = workers;
+    job->total = atoi(getenv("PA01_SCALE_TOTAL"));
+    job->chunk = chunk != NULL && atoi(chunk) > 0 ? atoi(chunk) : DEFAULT_CHUNK;
+    job->nchunks = (job->total + job->chunk - 1) / job->chunk;
+    job->shared = shared;
+    job->size = size;
+    snprintf(job->worker_type, sizeof(job->worker_type), "%s", worker_type);
+    job->deques = (scale_deque_t *)(job + 1);
+    job->stats = (scale_worker_t *)(job->deques + workers);
+
+    for (int i = 0; i < workers; i++) {
+        job->deques[i].top = (long)job->nchunks * i / workers;
+        job->deques[i].bottom = (long)job->nchunks * (i + 1) / workers;
+        job->stats[i].job = job;
+        job->stats[i].id = i;
+        job->stats[i].rnd = 0x9E3779B97F4A7C15ULL * (uint64_t)(i + 1);
+    }
+
+    printf("[Scaling] %d iterations of '%s' in %d chunks of %d over %d %s\n",
+           job->total, worker_type, job->nchunks, job->chunk, workers,
+           shared ? "processes (shared counter)" : "threads (work stealing)");
+    flush_before_fork();
+
+    job->start_ns = now_ns();
+    return job;
+}
+
+void scale_job_destroy(scale_job_t *job) {
+    if (job != NULL) munmap(job, job->size);
+}
+
+/* Chunk number -> iteration range */
+static int chunk_range(scale_job_t *job, scale_worker_t *w, long c,
+                       int *begin, int *end) {
+    *begin = (int)(c * job->chunk);
+    *end = *begin + job->chunk < job->total ? *begin + job->chunk : job->total;
+    w->iters += *end - *begin;
+    w->chunks++;
+    return 1;
+}
+
+/*------------------------------------------------------------------------------
+ * Program A: shared counter
+ *----------------------------------------------------------------------------*/
+
+static int claim_counter(void *ctx, int *begin, int *end) {
+    scale_worker_t *w = ctx;
+    scale_job_t *job = w->job;
+
+    long c = __atomic_fetch_add(&job->next_chunk, 1, __ATOMIC_RELAXED);
+    if (c >= job->nchunks) return 0;
+    return chunk_range(job, w, c, begin, end);
+}
+
+void scale_counter_source(scale_job_t *job, int id, work_src_t *src) {
+    src->claim = claim_counter;
+    src->ctx = &job->stats[id];
+    src->next = src->end = 0;
+    src->value = 0.0;
+}
+
+/*------------------------------------------------------------------------------
+ * Program B: work-stealing deques
+ *----------------------------------------------------------------------------*/
+
+/* Owner end; only worker i calls this on deque i */
+static long deque_take(scale_deque_t *d) {
+    long b = __atomic_load_n(&d->bottom, __ATOMIC_RELAXED) - 1;
+    __atomic_store_n(&d->bottom, b, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    long t = __atomic_load_n(&d->top, __ATOMIC_RELAXED);
+
+    if (t > b) {                                   /* already empty */
+        __atomic_store_n(&d->bottom, b + 1, __ATOMIC_RELAXED);
+        return DEQUE_EMPTY;
+    }
+    if (t == b) {                                  /* last one: race thieves */
+        int won = __atomic_compare_exchange_n(&d->top, &t, t + 1, 0,
+                                              __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+        __atomic_store_n(&d->bottom, b + 1, __ATOMIC_RELAXED);
+        return won ? b : DEQUE_EMPTY;
+    }
+    return b;
+}
+
+/* Thief end; any worker */
+static long deque_steal(scale_deque_t *d) {
+    long t = __atomic_load_n(&d->top, __ATOMIC_ACQUIRE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    long b = __atomic_load_n(&d->bottom, __ATOMIC_ACQUIRE);
+
+    if (t >= b) return DEQUE_EMPTY;
+    if (!__atomic_compare_exchange_n(&d->top, &t, t + 1, 0,
+                                     __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+        return DEQUE_ABORT;
+    }
+    return t;
+}
+
+static int claim_deque(void *ctx, int *begin, int *end) {
+    scale_worker_t *w = ctx;
+    scale_job_t *job = w->job;
+
+    long c = deque_take(&job->deques[w->id]);
+    if (c >= 0) return chunk_range(job, w, c, begin, end);
+
+    /* Own deque is empty and nothing is ever pushed, so the job is done
+     * once every other deque is empty too */
+    int n = job->workers;
+    int first = n > 1 ? (int)(xorshift64(&w->rnd) % (uint64_t)n) : 0;
+    for (int k = 0; k < n; k++) {
+        int victim = (first + k) % n;
+        if (victim == w->id) continue;
+        do {
+            c = deque_steal(&job->deques[victim]);
+        } while (c == DEQUE_ABORT);
+        if (c >= 0) {
+            w->steals++;
+            return chunk_range(job, w, c, begin, end);
+        }
+    }
+    return 0;
+}
+
+void scale_deque_source(scale_job_t *job, int id, work_src_t *src) {
+    src->claim = claim_deque;
+    src->ctx = &job->stats[id];
+    src->next = src->end = 0;
+    src->value = 0.0;
+}
+
+/*------------------------------------------------------------------------------
+ * Report
+ *----------------------------------------------------------------------------*/
+
+void scale_worker_done(scale_job_t *job, int id) {
+    job->stats[id].busy_ns = now_ns() - job->start_ns;
+}
+
+void scale_report(scale_job_t *job, const char *program) {
+    double elapsed = (now_ns() - job->start_ns) / 1e9;
+    double busy_sum = 0.0, busy_max = 0.0;
+    long min_iters = -1, max_iters = 0, steals = 0;
+
+    for (int i = 0; i < job->workers; i++) {
+        scale_worker_t *w = &job->stats[i];
+        double busy = w->busy_ns / 1e9;
+
+        printf("SCALEWORKER,%s,%s,%d,%ld,%ld,%ld,%.3f\n", program,
+               job->worker_type, i + 1, w->iters, w->chunks, w->steals, busy);
+        busy_sum += busy;
+        if (busy > busy_max) busy_max = busy;
+        if (min_iters < 0 || w->iters < min_iters) min_iters = w->iters;
+        if (w->iters > max_iters) max_iters = w->iters;
+        steals += w->steals;
+    }
+
+    double imbalance = busy_sum > 0 ? busy_max / (busy_sum / job->workers) : 1.0;
+    printf("[Scaling] %s: %.3f s, iterations per worker %ld..%ld, "
+           "imbalance %.3f, %ld steals\n", program, elapsed, min_iters,
+           max_iters, imbalance, steals);
+    printf("SCALE,%s,%s,%d,%d,%d,%.3f,%ld,%ld,%.3f,%ld\n", program,
+           job->worker_type, job->workers, job->total, job->chunk, elapsed,
+           min_iters, max_iters, imbalance, steals);
+}
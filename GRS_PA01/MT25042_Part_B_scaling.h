@@ -0,0 +1,66 @@
+/**
+ * MT25042_Part_B_scaling.h
+ * Graduate Systems (CSE638) - PA01: Processes and Threads
+ *
+ * Strong scaling: a fixed job shared by all workers
+ *
+ * Normally every worker runs all LOOP_COUNT iterations, so N workers do
+ * N times the work.  With PA01_SCALE_TOTAL set, the job is that many
+ * iterations in total, cut into chunks of PA01_SCALE_CHUNK and handed out
+ * while the workers run:
+ *
+ *   Program A  one atomic chunk counter in a MAP_SHARED page, incremented
+ *              by every child (self-scheduling)
+ *   Program B  one work-stealing deque per thread (Chase-Lev), seeded
+ *              with an equal block of chunks; a thread takes from the
+ *              bottom of its own and steals from the top of a random other
+ *              one once it is empty
+ *
+ * Environment:
+ *   PA01_SCALE_TOTAL=<iterations>   enables it (e.g. LOOP_COUNT)
+ *   PA01_SCALE_CHUNK=8              iterations per chunk
+ *
+ * Output after all workers are done (busy = job start to the worker's
+ * last chunk; imbalance = max busy / mean busy, 1.0 is perfect):
+ *   SCALEWORKER,<program>,<worker_type>,<id>,<iters>,<chunks>,<steals>,<busy_s>
+ *   SCALE,<program>,<worker_type>,<workers>,<total>,<chunk>,<elapsed_s>,
+ *         <min_iters>,<max_iters>,<imbalance>,<steals>
+ * Speedup and efficiency against 1 worker come from comparing SCALE lines
+ * (MT25042_Part_D_script.sh).
+ *
+ * AI Declaration: Deque follows Chase and Lev, "Dynamic Circular
+ *   Work-Stealing Deque" (SPAA 2005), without the push/grow half.
+ */
+
+#ifndef SCALING_H
+#define SCALING_H
+
+#include "MT25042_Part_B_workers.h"
+
+typedef struct scale_job scale_job_t;
+
+/* Non-zero if PA01_SCALE_TOTAL is set */
+int scaling_enabled(void);
+
+/**
+ * Job for `workers` workers of `worker_type`, timed from here.  With
+ * `shared` set it lives in a MAP_SHARED mapping so forked children and
+ * the parent see the same counter and statistics.  NULL on failure.
+ */
+scale_job_t *scale_job_create(const char *worker_type, int workers, int shared);
+
+void scale_job_destroy(scale_job_t *job);
+
+/* Source for worker `id` (0-based) drawing from the shared counter */
+void scale_counter_source(scale_job_t *job, int id, work_src_t *src);
+
+/* Source for worker `id` drawing from its deque, stealing when empty */
+void scale_deque_source(scale_job_t *job, int id, work_src_t *src);
+
+/* Records that worker `id` ran out of chunks */
+void scale_worker_done(scale_job_t *job, int id);
+
+/* Prints the SCALEWORKER and SCALE lines */
+void scale_report(scale_job_t *job, const char *program);
+
+#endif /* SCALING_H */
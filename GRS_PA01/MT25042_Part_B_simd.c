@@ -0,0 +1,191 @@
+/**
+ * MT25042_Part_B_simd.c
+ * Graduate Systems (CSE638) - PA01: Processes and Threads
+ *
+ * Scalar reference kernels, the SSE2 / AVX2 / AVX-512 instantiations of
+ * MT25042_Part_B_simd_kernels.h, CPUID dispatch and the check mode.
+ *
+ * AI Declaration: This code structure was generated with AI assistance;
+ *   dispatch follows the GCC manual section on __builtin_cpu_supports.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include "MT25042_Part_B_simd.h"
+
+/* Relative difference allowed between a vector level and scalar: the
+ * sums are added in a different order and sin/cos/tan are polynomials */
+#define SIMD_CHECK_TOLERANCE 1e-12
+
+/*------------------------------------------------------------------------------
+ * Scalar reference (libm, same arithmetic as the original worker_cpu)
+ *----------------------------------------------------------------------------*/
+
+static double leibniz_scalar(int terms) {
+    double pi = 0.0;
+    for (int j = 0; j < terms; j++) {
+        int sign = (j % 2 == 0) ? 1 : -1;
+        pi += sign * (4.0 / (2.0 * j + 1));
+    }
+    return pi;
+}
+
+static double trig_scalar(int steps) {
+    double result = 0.0;
+    for (int k = 0; k < steps; k++) {
+        double temp = sin((double)k * 0.001) * cos((double)k * 0.001);
+        temp += tan((double)k * 0.0001 + 0.0001);
+        result += temp * temp;
+    }
+    return result;
+}
+
+static double nested_scalar(int dim) {
+    double result = 0.0;
+    for (int m = 0; m < dim; m++) {
+        for (int n = 0; n < dim; n++) {
+            result += (double)(m * n) / (m + n + 1);
+        }
+    }
+    return result;
+}
+
+/*------------------------------------------------------------------------------
+ * Vector levels
+ *----------------------------------------------------------------------------*/
+
+#if defined(__x86_64__) || defined(__i386__)
+#define HAVE_SIMD_LEVELS 1
+
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#define SIMD_ISA   sse2
+#define SIMD_BYTES 16
+#include "MT25042_Part_B_simd_kernels.h"
+#undef SIMD_ISA
+#undef SIMD_BYTES
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+#define SIMD_ISA   avx2
+#define SIMD_BYTES 32
+#include "MT25042_Part_B_simd_kernels.h"
+#undef SIMD_ISA
+#undef SIMD_BYTES
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+#define SIMD_ISA   avx512
+#define SIMD_BYTES 64
+#include "MT25042_Part_B_simd_kernels.h"
+#undef SIMD_ISA
+#undef SIMD_BYTES
+#pragma GCC pop_options
+#endif
+
+/* Ordered from the reference to the widest level */
+static const simd_kernels_t simd_levels[] = {
+    { "scalar", leibniz_scalar, trig_scalar, nested_scalar },
+#ifdef HAVE_SIMD_LEVELS
+    { "sse2",   leibniz_sse2,   trig_sse2,   nested_sse2   },
+    { "avx2",   leibniz_avx2,   trig_avx2,   nested_avx2   },
+    { "avx512", leibniz_avx512, trig_avx512, nested_avx512 },
+#endif
+};
+
+#define NUM_SIMD_LEVELS (int)(sizeof(simd_levels) / sizeof(simd_levels[0]))
+
+/* CPUID check (includes OS support for the wider register state) */
+static int level_supported(int level) {
+#ifdef HAVE_SIMD_LEVELS
+    __builtin_cpu_init();
+    switch (level) {
+    case 1: return __builtin_cpu_supports("sse2");
+    case 2: return __builtin_cpu_supports("avx2") &&
+                   __builtin_cpu_supports("fma");
+    case 3: return __builtin_cpu_supports("avx512f");
+    }
+#endif
+    return level == 0;
+}
+
+const simd_kernels_t *simd_lookup(const char *isa) {
+    if (strcmp(isa, "auto") == 0) {
+        for (int i = NUM_SIMD_LEVELS - 1; i > 0; i--) {
+            if (level_supported(i)) return &simd_levels[i];
+        }
+        return &simd_levels[0];
+    }
+
+    for (int i = 0; i < NUM_SIMD_LEVELS; i++) {
+        if (strcmp(isa, simd_levels[i].name) == 0) {
+            return level_supported(i) ? &simd_levels[i] : NULL;
+        }
+    }
+    return NULL;
+}
+
+static int check_one(const char *level, const char *kernel, double got,
+                     double ref) {
+    double err = fabs(got - ref) / (fabs(ref) > 0 ? fabs(ref) : 1.0);
+    int ok = err <= SIMD_CHECK_TOLERANCE;
+    printf("    [SIMD check] %-6s %-8s %.15g vs %.15g (rel. err %.2e) %s\n",
+           level, kernel, got, ref, err, ok ? "OK" : "MISMATCH");
+    return !ok;
+}
+
+int simd_check(void) {
+    const simd_kernels_t *ref = &simd_levels[0];
+    double ref_l = ref->leibniz(CPU_LEIBNIZ_TERMS);
+    double ref_t = ref->trig(CPU_TRIG_STEPS);
+    double ref_n = ref->nested(CPU_NESTED_DIM);
+    int failures = 0;
+
+    for (int i = 1; i < NUM_SIMD_LEVELS; i++) {
+        const simd_kernels_t *k = &simd_levels[i];
+        if (!level_supported(i)) {
+            printf("    [SIMD check] %-6s not supported by this CPU\n", k->name);
+            continue;
+        }
+        failures += check_one(k->name, "leibniz", k->leibniz(CPU_LEIBNIZ_TERMS), ref_l);
+        failures += check_one(k->name, "trig", k->trig(CPU_TRIG_STEPS), ref_t);
+        failures += check_one(k->name, "nested", k->nested(CPU_NESTED_DIM), ref_n);
+    }
+    return failures;
+}
+
+static const simd_kernels_t *env_kernels = NULL;
+static pthread_once_t env_once = PTHREAD_ONCE_INIT;
+
+static void resolve_env(void) {
+    const char *check = getenv("PA01_SIMD_CHECK");
+    if (check != NULL && *check != '\0' && strcmp(check, "0") != 0) {
+        int failures = simd_check();
+        if (failures > 0) {
+            fprintf(stderr, "    [SIMD check] %d mismatches against scalar\n",
+                    failures);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    const char *isa = getenv("PA01_ISA");
+    if (isa == NULL || *isa == '\0') return;
+
+    env_kernels = simd_lookup(isa);
+    if (env_kernels == NULL) {
+        env_kernels = simd_lookup("auto");
+        fprintf(stderr, "    [CPU Worker] PA01_ISA=%s unknown or not supported, "
+                "using %s\n", isa, env_kernels->name);
+    }
+}
+
+const simd_kernels_t *simd_from_env(void) {
+    pthread_once(&env_once, resolve_env);
+    return env_kernels;
+}
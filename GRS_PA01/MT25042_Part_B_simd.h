@@ -0,0 +1,58 @@
+/**
+ * MT25042_Part_B_simd.h
+ * Graduate Systems (CSE638) - PA01: Processes and Threads
+ *
+ * Runtime-dispatched kernels for the CPU worker
+ *
+ * The three computations of worker_cpu (Leibniz series, sin*cos + tan
+ * loop, 100x100 nested division) as plain functions, in one scalar
+ * reference version (libm) and SSE2 / AVX2 / AVX-512 versions with
+ * polynomial sin/cos/tan.  The level is picked at run time from CPUID
+ * (__builtin_cpu_supports), so one binary runs on any x86-64 machine.
+ *
+ * Environment:
+ *   PA01_ISA=scalar|sse2|avx2|avx512|auto   worker_cpu uses these kernels
+ *                                           (unset: original volatile loop)
+ *   PA01_SIMD_CHECK=1                       compare every supported level
+ *                                           against scalar first, exit 1 on
+ *                                           a mismatch
+ *
+ * AI Declaration: This code structure was generated with AI assistance;
+ *   polynomial coefficients taken from Cephes sin.c and the pi/2 split
+ *   from fdlibm.
+ */
+
+#ifndef SIMD_H
+#define SIMD_H
+
+/* Work per LOOP_COUNT iteration, same as the original worker_cpu */
+#define CPU_LEIBNIZ_TERMS 10000
+#define CPU_TRIG_STEPS    1000
+#define CPU_NESTED_DIM    100
+
+typedef struct {
+    const char *name;                  /* scalar, sse2, avx2, avx512 */
+    double (*leibniz)(int terms);      /* sum of (-1)^j * 4/(2j+1)    */
+    double (*trig)(int steps);         /* sum of (sin*cos + tan)^2    */
+    double (*nested)(int dim);         /* sum of m*n / (m+n+1)        */
+} simd_kernels_t;
+
+/**
+ * Kernels for an ISA level name, or "auto" for the best supported one.
+ * Returns NULL if the name is unknown or the CPU does not support it.
+ */
+const simd_kernels_t *simd_lookup(const char *isa);
+
+/**
+ * Kernels requested by PA01_ISA (NULL if unset), resolved once per
+ * process.  Runs simd_check() first when PA01_SIMD_CHECK is set.
+ */
+const simd_kernels_t *simd_from_env(void);
+
+/**
+ * Compares every supported level against the scalar reference and
+ * prints the relative error per kernel.  Returns the number of mismatches.
+ */
+int simd_check(void);
+
+#endif /* SIMD_H */
@@ -0,0 +1,158 @@
+/**
+ * MT25042_Part_B_simd_kernels.h
+ * Graduate Systems (CSE638) - PA01: Processes and Threads
+ *
+ * Vector kernel template, included once per ISA level by
+ * MT25042_Part_B_simd.c with:
+ *   SIMD_ISA    suffix of the generated functions (sse2, avx2, ...)
+ *   SIMD_BYTES  vector width in bytes (16, 32, 64)
+ * inside a "#pragma GCC target" region, so the same GCC vector-extension
+ * code is compiled to SSE2, AVX2 or AVX-512 instructions.
+ *
+ * sin/cos/tan: x = q*pi/2 + r with |r| <= pi/4 (three-part Cody-Waite
+ * reduction), Cephes polynomials for sin r and cos r, and the quadrant
+ * q mod 4 selecting/negating them.  Accurate for |x| < 2^20.
+ *
+ * No include guard: meant to be included several times.
+ *
+ * AI Declaration: This code structure was generated with AI assistance;
+ *   polynomial coefficients taken from Cephes sin.c and the pi/2 split
+ *   from fdlibm.
+ */
+
+#define SIMD_CAT_(a, b) a##_##b
+#define SIMD_CAT(a, b)  SIMD_CAT_(a, b)
+#define FN(name)        SIMD_CAT(name, SIMD_ISA)
+#define VD              FN(vd)
+#define VL              FN(vl)
+#define VLEN            (SIMD_BYTES / 8)
+
+typedef double    VD __attribute__((vector_size(SIMD_BYTES)));
+typedef long long VL __attribute__((vector_size(SIMD_BYTES)));
+
+/* Lane indices 0, 1, ..., VLEN-1 */
+static inline VL FN(lanes)(void) {
+    VL l;
+    for (int i = 0; i < VLEN; i++) l[i] = i;
+    return l;
+}
+
+/* m ? a : b per lane, m all-ones or zero */
+static inline VD FN(select)(VL m, VD a, VD b) {
+    return (VD)(((VL)a & m) | ((VL)b & ~m));
+}
+
+/* a with its sign flipped where m is all-ones */
+static inline VD FN(negate_if)(VL m, VD a) {
+    return (VD)((VL)a ^ (m & (-0x7fffffffffffffffLL - 1)));   /* sign bit */
+}
+
+static inline double FN(hsum)(VD v) {
+    double s = 0.0;
+    for (int i = 0; i < VLEN; i++) s += v[i];
+    return s;
+}
+
+/* sin r and cos r for |r| <= pi/4 */
+static inline void FN(sincos_poly)(VD r, VD *s, VD *c) {
+    VD z = r * r;
+    VD ps = ((((( 1.58962301576546568060e-10  * z
+                - 2.50507477628578072866e-8)  * z
+                + 2.75573136213857245213e-6)  * z
+                - 1.98412698295895385996e-4)  * z
+                + 8.33333333332211858878e-3)  * z
+                - 1.66666666666666307295e-1);
+    VD pc = (((((-1.13585365213876817300e-11  * z
+                + 2.08757008419747316778e-9)  * z
+                - 2.75573141792967388112e-7)  * z
+                + 2.48015872888517045348e-5)  * z
+                - 1.38888888888730564116e-3)  * z
+                + 4.16666666666665929218e-2);
+    *s = r + r * z * ps;
+    *c = 1.0 - 0.5 * z + z * z * pc;
+}
+
+/* x = q*pi/2 + r; returns r, *q gets q (its low bits are q mod 4) */
+static inline VD FN(reduce)(VD x, VL *q) {
+    const double magic = 6755399441055744.0;    /* 1.5 * 2^52 */
+    VD kq = x * 0.63661977236758134308 + magic;  /* 2/pi      */
+    VD k  = kq - magic;                          /* round()   */
+    *q = (VL)kq;                                 /* low bits = k */
+    return ((x - k * 1.57079632673412561417e+00)
+               - k * 6.07710050650619224932e-11)
+               - k * 2.02226624879595063154e-21;
+}
+
+static inline void FN(sincos)(VD x, VD *sn, VD *cs) {
+    VL q;
+    VD s, c;
+    FN(sincos_poly)(FN(reduce)(x, &q), &s, &c);
+    VL odd = -(q & 1);
+    /* quadrant 0..3: sin = s, c, -s, -c   cos = c, -s, -c, s */
+    *sn = FN(negate_if)(-((q >> 1) & 1), FN(select)(odd, c, s));
+    *cs = FN(negate_if)(-(((q + 1) >> 1) & 1), FN(select)(odd, s, c));
+}
+
+static inline VD FN(tan)(VD x) {
+    VL q;
+    VD s, c;
+    FN(sincos_poly)(FN(reduce)(x, &q), &s, &c);
+    VL odd = -(q & 1);
+    /* even quadrant: s/c, odd: -c/s */
+    return FN(negate_if)(odd, FN(select)(odd, c, s) / FN(select)(odd, s, c));
+}
+
+/* Leibniz: lanes of one vector alternate sign (VLEN is even) */
+static double FN(leibniz)(int terms) {
+    VL li = FN(lanes)();
+    VD lane = __builtin_convertvector(li, VD);
+    VD sign = 1.0 - 2.0 * __builtin_convertvector(li & 1, VD);
+    VD acc = { 0 };
+
+    int j = 0;
+    for (; j + VLEN <= terms; j += VLEN)
+        acc += sign * (4.0 / (2.0 * (lane + j) + 1.0));
+    if (j < terms) {
+        VD t = sign * (4.0 / (2.0 * (lane + j) + 1.0));
+        acc += FN(select)(li + j < terms, t, (VD){ 0 });
+    }
+    return FN(hsum)(acc);
+}
+
+static double FN(trig)(int steps) {
+    VL li = FN(lanes)();
+    VD lane = __builtin_convertvector(li, VD);
+    VD acc = { 0 };
+
+    for (int k = 0; k < steps; k += VLEN) {
+        VD kk = lane + k, s, c;
+        FN(sincos)(kk * 0.001, &s, &c);
+        VD t = s * c + FN(tan)(kk * 0.0001 + 0.0001);
+        if (k + VLEN <= steps) acc += t * t;
+        else acc += FN(select)(li + k < steps, t * t, (VD){ 0 });
+    }
+    return FN(hsum)(acc);
+}
+
+static double FN(nested)(int dim) {
+    VL li = FN(lanes)();
+    VD lane = __builtin_convertvector(li, VD);
+    VD acc = { 0 };
+
+    for (int m = 0; m < dim; m++) {
+        for (int n = 0; n < dim; n += VLEN) {
+            VD nn = lane + n;
+            VD t = (m * nn) / (m + nn + 1.0);
+            if (n + VLEN <= dim) acc += t;
+            else acc += FN(select)(li + n < dim, t, (VD){ 0 });
+        }
+    }
+    return FN(hsum)(acc);
+}
+
+#undef SIMD_CAT_
+#undef SIMD_CAT
+#undef FN
+#undef VD
+#undef VL
+#undef VLEN
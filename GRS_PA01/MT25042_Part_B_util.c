@@ -0,0 +1,49 @@
+/**
+ * MT25042_Part_B_util.c
+ * Graduate Systems (CSE638) - PA01: Processes and Threads
+ *
+ * Shared helpers (see MT25042_Part_B_util.h).
+ *
+ * AI Declaration: This code structure was generated with AI assistance.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <time.h>
+#include "MT25042_Part_B_util.h"
+
+uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+size_t parse_size(const char *s, size_t def) {
+    if (s == NULL || *s == '\0') return def;
+
+    char *end;
+    unsigned long long v = strtoull(s, &end, 10);
+    switch (toupper((unsigned char)*end)) {
+    case 'G': v <<= 10; /* fall through */
+    case 'M': v <<= 10; /* fall through */
+    case 'K': v <<= 10; end++; break;
+    case '\0': break;
+    default: return def;
+    }
+    return (*end == '\0' && v > 0) ? (size_t)v : def;
+}
+
+int cmp_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+double pct_us(const uint64_t *sorted, size_t n, double p) {
+    return n ? sorted[(size_t)(p * (double)(n - 1))] / 1e3 : 0.0;
+}
+
+void flush_before_fork(void) {
+    fflush(stdout);
+}
@@ -0,0 +1,40 @@
+/**
+ * MT25042_Part_B_util.h
+ * Graduate Systems (CSE638) - PA01: Processes and Threads
+ *
+ * Small helpers shared by the measurement modules: clock, PRNG, size
+ * knobs, percentiles.
+ *
+ * AI Declaration: This code structure was generated with AI assistance.
+ */
+
+#ifndef UTIL_H
+#define UTIL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* CLOCK_MONOTONIC in nanoseconds */
+uint64_t now_ns(void);
+
+/* Marsaglia xorshift; inline since it sits in the hot loops */
+static inline uint64_t xorshift64(uint64_t *x) {
+    *x ^= *x << 13;
+    *x ^= *x >> 7;
+    *x ^= *x << 17;
+    return *x;
+}
+
+/* "64", "4K", "16M", "2G"; returns def if unset or malformed */
+size_t parse_size(const char *s, size_t def);
+
+/* qsort() comparator for uint64_t */
+int cmp_u64(const void *a, const void *b);
+
+/* p-th percentile (0..1) of n sorted nanosecond times, in microseconds */
+double pct_us(const uint64_t *sorted, size_t n, double p);
+
+/* Flushes stdout, so a fork does not duplicate what is still buffered */
+void flush_before_fork(void);
+
+#endif /* UTIL_H */
@@ -18,7 +18,13 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <pthread.h>
+#include <time.h>
+#include <sys/syscall.h>
 #include "MT25042_Part_B_workers.h"
+#include "MT25042_Part_B_simd.h"
+#include "MT25042_Part_B_memprof.h"
+#include "MT25042_Part_B_memalloc.h"
+#include "MT25042_Part_B_ioengine.h"
 
 /* Memory size for memory-intensive operations (16 MB per array) */
 #define MEM_ARRAY_SIZE (16 * 1024 * 1024)
@@ -29,6 +35,43 @@
 /* Temporary file prefix for I/O operations */
 #define IO_TEMP_FILE_PREFIX "/tmp/pa01_io_worker_"
 
+/* Every iteration of the loop, in one piece (the normal workers) */
+#define WORK_SRC_ALL { NULL, NULL, 0, LOOP_COUNT, 0.0 }
+
+/* Next iteration to run from src; 0 once its job is done */
+static int work_next(work_src_t *src, int *iter) {
+    if (src->next >= src->end &&
+        (src->claim == NULL || !src->claim(src->ctx, &src->next, &src->end))) {
+        return 0;
+    }
+    *iter = src->next++;
+    return 1;
+}
+
+/**
+ * CPU worker on the dispatched kernels (PA01_ISA set)
+ *
+ * Same three computations and totals as the loop below, but without
+ * volatile accumulators, so the vector levels can do the work.
+ */
+static void worker_cpu_kernels(const simd_kernels_t *k, work_src_t *src) {
+    double pi = 0.0;
+    double result = 0.0;
+
+    printf("    [CPU Worker] Starting CPU-intensive work (LOOP_COUNT=%d, isa=%s)\n",
+           LOOP_COUNT, k->name);
+
+    for (int i; work_next(src, &i); ) {
+        pi += k->leibniz(CPU_LEIBNIZ_TERMS);
+        result += k->trig(CPU_TRIG_STEPS);
+        result += k->nested(CPU_NESTED_DIM);
+        src->value = pi;
+    }
+
+    printf("    [CPU Worker] Completed. Pi approximation: %.10f, Result: %.2f\n",
+           pi, result);
+}
+
 /**
  * CPU-intensive worker function
  * 
@@ -39,15 +82,24 @@
  * 
  * The goal is to keep the CPU busy with actual computations,
  * not waiting on memory or I/O.
+ *
+ * With PA01_ISA set, runs the scalar/SIMD kernels of
+ * MT25042_Part_B_simd.h instead (see worker_cpu_kernels).
  */
-void worker_cpu(void) {
+static void cpu_work(work_src_t *src) {
+    const simd_kernels_t *kernels = simd_from_env();
+    if (kernels != NULL) {
+        worker_cpu_kernels(kernels, src);
+        return;
+    }
+
     volatile double pi = 0.0;          /* volatile prevents optimization */
     volatile double temp = 0.0;
     volatile double result = 0.0;
     
     printf("    [CPU Worker] Starting CPU-intensive work (LOOP_COUNT=%d)\n", LOOP_COUNT);
 
-    for (int i = 0; i < LOOP_COUNT; i++) {
+    for (int i; work_next(src, &i); ) {
         /* Leibniz series for pi: pi/4 = 1 - 1/3 + 1/5 - 1/7 + ... */
         for (int j = 0; j < 10000; j++) {
             int sign = (j % 2 == 0) ? 1 : -1;
@@ -67,12 +119,18 @@ void worker_cpu(void) {
                 result += (double)(m * n) / (m + n + 1);
             }
         }
+        src->value = pi;
     }
 
     printf("    [CPU Worker] Completed. Pi approximation: %.10f, Result: %.2f\n", 
            pi, result);
 }
 
+void worker_cpu(void) {
+    work_src_t all = WORK_SRC_ALL;
+    cpu_work(&all);
+}
+
 /**
  * Memory-intensive worker function
  * 
@@ -83,27 +141,49 @@ void worker_cpu(void) {
  * 4. Sorts data to trigger memory movements
  * 
  * The goal is to stress the memory subsystem, not the CPU.
+ *
+ * The arrays follow PA01_MEM_POLICY / PA01_MEM_PAGES
+ * (MT25042_Part_B_memalloc.h) and are first touched here, by the worker
+ * that uses them.  With either variable set it times the first touch
+ * of both arrays, counts dTLB misses and at the end prints where their
+ * pages ended up:
+ *   MEMPLACE,<pid>,<tid>,<policy>,<pages>,<cpu_node>,<local_kb>,<remote_kb>,
+ *            <huge_kb>,<dtlb_misses>,<first_touch_ms>
+ * dtlb_misses is -1 when no PMU is available.  Without them the work is
+ * exactly the stock worker's, so Part C/D timings stay comparable.
  */
-void worker_mem(void) {
+static void mem_work(work_src_t *src) {
     printf("    [MEM Worker] Starting memory-intensive work (LOOP_COUNT=%d)\n", LOOP_COUNT);
 
     /* Allocate large arrays (16 MB each - larger than typical L3 cache) */
-    unsigned char *array1 = malloc(MEM_ARRAY_SIZE);
-    unsigned char *array2 = malloc(MEM_ARRAY_SIZE);
-    
-    if (array1 == NULL || array2 == NULL) {
-        perror("    [MEM Worker] malloc failed");
-        if (array1) free(array1);
-        if (array2) free(array2);
+    mem_region_t regions[2] = { { 0 }, { 0 } };
+    if (mem_region_alloc(&regions[0], MEM_ARRAY_SIZE) != 0 ||
+        mem_region_alloc(&regions[1], MEM_ARRAY_SIZE) != 0) {
+        perror("    [MEM Worker] mmap failed");
+        mem_region_free(&regions[0]);
+        mem_region_free(&regions[1]);
         return;
     }
+    unsigned char *array1 = regions[0].addr;
+    unsigned char *array2 = regions[1].addr;
+    int probe = mem_placement_requested();
 
-    /* Initialize arrays with pattern */
+    /* First touch: every worker faults its own pages in, in parallel
+     * with the others, so the policy places them relative to it.  The
+     * stock worker leaves array2 to the first memcpy */
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
     for (size_t i = 0; i < MEM_ARRAY_SIZE; i++) {
         array1[i] = (unsigned char)(i & 0xFF);
     }
+    if (probe) memset(array2, 0, MEM_ARRAY_SIZE);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double first_touch_ms = (t1.tv_sec - t0.tv_sec) * 1e3 +
+                            (t1.tv_nsec - t0.tv_nsec) / 1e6;
+
+    int tlb_fd = probe ? mem_tlb_open() : -1;
 
-    for (int iter = 0; iter < LOOP_COUNT; iter++) {
+    for (int iter; work_next(src, &iter); ) {
         /* Memory copy operation (tests memory bandwidth) */
         memcpy(array2, array1, MEM_ARRAY_SIZE);
         
@@ -127,15 +207,40 @@ void worker_mem(void) {
         for (size_t i = 0; i < MEM_ARRAY_SIZE; i++) {
             array1[i] = (array1[i] + array2[MEM_ARRAY_SIZE - 1 - i]) & 0xFF;
         }
+        src->value += array1[seed % MEM_ARRAY_SIZE];
+    }
+
+    if (probe) {
+        long long dtlb_misses = mem_tlb_read(tlb_fd);
+        mem_placement_t place;
+        mem_placement(regions, 2, &place);
+        printf("MEMPLACE,%d,%ld,%s,%s,%d,%ld,%ld,%ld,%lld,%.1f\n",
+               getpid(), (long)syscall(SYS_gettid), mem_policy_name(),
+               regions[0].pages, place.cpu_node, place.local_kb, place.remote_kb,
+               place.huge_kb, dtlb_misses, first_touch_ms);
     }
 
     /* Cleanup */
-    free(array1);
-    free(array2);
+    mem_region_free(&regions[0]);
+    mem_region_free(&regions[1]);
 
     printf("    [MEM Worker] Completed memory operations.\n");
 }
 
+/*
+ * With PA01_MEM_PROFILE set it runs the memory hierarchy profiler
+ * (MT25042_Part_B_memprof.h) instead.
+ */
+void worker_mem(void) {
+    if (memprof_enabled()) {
+        memprof_run();
+        return;
+    }
+
+    work_src_t all = WORK_SRC_ALL;
+    mem_work(&all);
+}
+
 /**
  * I/O-intensive worker function
  * 
@@ -148,7 +253,7 @@ void worker_mem(void) {
  * The goal is to make the process spend most time waiting for I/O,
  * with the CPU sitting idle.
  */
-void worker_io(void) {
+static void io_work(work_src_t *src) {
     printf("    [IO Worker] Starting I/O-intensive work (LOOP_COUNT=%d)\n", LOOP_COUNT);
 
     /* Create unique temporary filename based on PID and thread ID */
@@ -168,7 +273,8 @@ void worker_io(void) {
         buffer[i] = (char)('A' + (i % 26));
     }
 
-    for (int iter = 0; iter < LOOP_COUNT; iter++) {
+    int done = 0;
+    for (int iter; work_next(src, &iter); ) {
         /* Open file for writing */
         int fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
         if (fd < 0) {
@@ -202,10 +308,16 @@ void worker_io(void) {
         }
 
         close(fd);
+        src->value += (bytes_written > 0 ? bytes_written : 0) +
+                      (bytes_read > 0 ? bytes_read : 0);
 
-        /* Every 100 iterations, print progress */
-        if ((iter + 1) % 100 == 0) {
+        /* Every 100 iterations, print progress.  A worker with a share of
+         * a job gets scattered iteration numbers, so it counts its own */
+        done++;
+        if (src->claim == NULL && (iter + 1) % 100 == 0) {
             printf("    [IO Worker] Progress: %d/%d iterations\n", iter + 1, LOOP_COUNT);
+        } else if (src->claim != NULL && done % 100 == 0) {
+            printf("    [IO Worker] Progress: %d iterations done\n", done);
         }
     }
 
@@ -215,3 +327,34 @@ void worker_io(void) {
 
     printf("    [IO Worker] Completed I/O operations.\n");
 }
+
+/*
+ * With PA01_IO_ENGINE set it runs the block I/O engine
+ * (MT25042_Part_B_ioengine.h) on its own file instead.
+ */
+void worker_io(void) {
+    if (ioengine_enabled()) {
+        char filename[256];
+        const char *dir = getenv("PA01_IO_DIR");
+        snprintf(filename, sizeof(filename), "%s/pa01_io_worker_%d_%lu.tmp",
+                 dir != NULL && *dir != '\0' ? dir : "/tmp", getpid(),
+                 (unsigned long)pthread_self());
+        ioengine_run(filename);
+        return;
+    }
+
+    work_src_t all = WORK_SRC_ALL;
+    io_work(&all);
+}
+
+void worker_run_share(const char *worker_type, work_src_t *src) {
+    if (strcmp(worker_type, "cpu") == 0) {
+        cpu_work(src);
+    }
+    else if (strcmp(worker_type, "mem") == 0) {
+        mem_work(src);
+    }
+    else if (strcmp(worker_type, "io") == 0) {
+        io_work(src);
+    }
+}
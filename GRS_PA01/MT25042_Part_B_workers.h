@@ -41,4 +41,28 @@ void worker_mem(void);
  */
 void worker_io(void);
 
+/**
+ * Source of loop iterations for a worker that gets a share of a fixed
+ * job (strong scaling, MT25042_Part_B_scaling.h) instead of LOOP_COUNT.
+ * claim() hands out the next chunk [*begin, *end) and returns 0 once the
+ * job is done; next/end are the rest of the current chunk.  value is
+ * the worker's running result, updated after every iteration (cpu: the
+ * pi sum, mem: a checksum of the array, io: bytes written and read), so
+ * the difference across a chunk is that chunk's result.
+ */
+typedef struct {
+    int  (*claim)(void *ctx, int *begin, int *end);
+    void  *ctx;
+    int    next;
+    int    end;
+    double value;
+} work_src_t;
+
+/**
+ * Runs the loop of the given worker type (cpu, mem, io) over the
+ * iterations src hands out.  The PA01_MEM_PROFILE / PA01_IO_ENGINE modes
+ * do not apply: they do not have LOOP_COUNT iterations to share.
+ */
+void worker_run_share(const char *worker_type, work_src_t *src);
+
 #endif /* WORKERS_H */
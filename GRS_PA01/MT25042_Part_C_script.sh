@@ -9,6 +9,21 @@
 # - I/O: File system inputs/outputs
 # - Execution time: Elapsed wall clock time
 #
+# The cpu worker is then repeated for every ISA level of the SIMD kernels
+# this CPU supports (PA01_ISA), stored as Function cpu_<isa>.
+#
+# MEM_PROFILE=<patterns> (e.g. MEM_PROFILE=all) additionally runs the memory
+# hierarchy profiler (PA01_MEM_PROFILE) on one mem worker of each program;
+# its MEMPROF and MEMLEVEL lines go to MT25042_Part_C_MemProfile.csv.
+#
+# With PA01_MEM_POLICY / PA01_MEM_PAGES set, the mem worker's page placement
+# is recorded in the last four columns: policy/pages, KB on a remote NUMA
+# node, KB on hugepages and dTLB load misses (NA when neither is set).
+#
+# IO_ENGINES="uring direct buffered mmap" additionally runs the io worker on
+# each block I/O engine (PA01_IO_ENGINE) with 2 processes and 2 threads;
+# IOPS, MB/s and latency percentiles go to MT25042_Part_C_IOEngine.csv.
+#
 # Usage: ./MT25042_Part_C_script.sh [cpu_list]
 #
 # AI Declaration: This script structure was generated with AI assistance.
@@ -20,11 +35,18 @@
 ROLL_NUM="MT25042"
 SCRIPT_DIR="$(cd "$(dirname "$0")" && pwd)"
 OUTPUT_CSV="${SCRIPT_DIR}/${ROLL_NUM}_Part_C_CSV.csv"
+MEMPROF_CSV="${SCRIPT_DIR}/${ROLL_NUM}_Part_C_MemProfile.csv"
+IOENGINE_CSV="${SCRIPT_DIR}/${ROLL_NUM}_Part_C_IOEngine.csv"
 PROGRAM_A="${SCRIPT_DIR}/program_a"
 PROGRAM_B="${SCRIPT_DIR}/program_b"
 CPU_LIST="${1:-0,1}"
 
+# The baseline rows run the stock workers: the profiler, I/O engine and
+# pool modes are only switched on inline, by MEM_PROFILE / IO_ENGINES
+unset PA01_MEM_PROFILE PA01_IO_ENGINE PA01_POOL_TASKS
+
 WORKER_TYPES=("cpu" "mem" "io")
+ISA_LEVELS=("scalar" "sse2" "avx2" "avx512")
 
 # Colors
 RED='\033[0;31m'
@@ -65,7 +87,7 @@ check_dependencies() {
 }
 
 init_csv() {
-    echo "Program,Function,CPU_Percent,Memory_KB,IO_Read_KB,IO_Write_KB,Exec_Time_Real,Exec_Time_User,Exec_Time_Sys" > "$OUTPUT_CSV"
+    echo "Program,Function,CPU_Percent,Memory_KB,IO_Read_KB,IO_Write_KB,Exec_Time_Real,Exec_Time_User,Exec_Time_Sys,Mem_Policy,Remote_KB,Huge_KB,dTLB_Misses" > "$OUTPUT_CSV"
     print_msg "$GREEN" "Initialized CSV: $OUTPUT_CSV"
 }
 
@@ -98,10 +120,45 @@ parse_elapsed() {
     echo "$seconds"
 }
 
+# Mem_Policy,Remote_KB,Huge_KB,dTLB_Misses from the MEMPLACE lines of the
+# mem worker (summed over workers); NA for the other workers.
+# dTLB_Misses is NA when the PMU is not available.
+mem_placement_columns() {
+    awk -F',' '
+        $1 == "MEMPLACE" {
+            if (policy == "") policy = $4 "/" $5
+            remote += $8; huge += $9
+            if ($10 < 0) no_tlb = 1; else tlb += $10
+            n++
+        }
+        END {
+            if (n == 0) { print "NA,NA,NA,NA"; exit }
+            printf "%s,%d,%d,%s\n", policy, remote, huge, no_tlb ? "NA" : tlb
+        }' "$1"
+}
+
+# ISA levels of MT25042_Part_B_simd.c this CPU supports
+supported_isas() {
+    local flags=$(grep -m1 '^flags' /proc/cpuinfo)
+    for isa in "${ISA_LEVELS[@]}"; do
+        case "$isa" in
+            sse2)   [[ " $flags " == *" sse2 "* ]] || continue ;;
+            avx2)   [[ " $flags " == *" avx2 "* && " $flags " == *" fma "* ]] || continue ;;
+            avx512) [[ " $flags " == *" avx512f "* ]] || continue ;;
+        esac
+        echo "$isa"
+    done
+}
+
+# Optional third argument: PA01_ISA level, recorded as Function <worker>_<isa>
 run_and_measure() {
     local program=$1
     local worker_type=$2
+    local isa=$3
+    local function_name="$worker_type"
     local program_name program_path
+
+    [[ -n "$isa" ]] && function_name="${worker_type}_${isa}"
     
     if [[ "$program" == "A" ]]; then
         program_name="Program_A"
@@ -112,7 +169,7 @@ run_and_measure() {
     fi
     
     print_msg "$YELLOW" "=========================================="
-    print_msg "$YELLOW" "Running: ${program_name} + ${worker_type}"
+    print_msg "$YELLOW" "Running: ${program_name} + ${function_name}"
     print_msg "$YELLOW" "=========================================="
     
     local tmp_dir=$(mktemp -d)
@@ -122,7 +179,7 @@ run_and_measure() {
     print_msg "$BLUE" "Starting with CPU affinity: $CPU_LIST"
     
     # Run with /usr/bin/time -v to get detailed stats
-    /usr/bin/time -v taskset -c "$CPU_LIST" "$program_path" "$worker_type" \
+    PA01_ISA="$isa" /usr/bin/time -v taskset -c "$CPU_LIST" "$program_path" "$worker_type" \
         > "$prog_output" 2> "$time_output"
     
     # Parse the time output
@@ -147,9 +204,11 @@ run_and_measure() {
     [[ -z "$real_time" ]] && real_time="0"
     [[ -z "$user_time" ]] && user_time="0"
     [[ -z "$sys_time" ]] && sys_time="0"
+
+    local placement=$(mem_placement_columns "$prog_output")
     
     # Print results
-    print_msg "$GREEN" "Results for ${program_name} + ${worker_type}:"
+    print_msg "$GREEN" "Results for ${program_name} + ${function_name}:"
     echo "  CPU%:         ${cpu_percent}%"
     echo "  Memory:       ${max_rss} KB"
     echo "  I/O Read:     ${io_read_kb} KB"
@@ -157,16 +216,60 @@ run_and_measure() {
     echo "  Real Time:    ${real_time}s"
     echo "  User Time:    ${user_time}s"
     echo "  Sys Time:     ${sys_time}s"
+    [[ "$placement" != NA,* ]] && echo "  Placement:    ${placement} (policy/pages,remote KB,huge KB,dTLB misses)"
     
     # Append to CSV
-    echo "${program_name},${worker_type},${cpu_percent},${max_rss},${io_read_kb},${io_write_kb},${real_time},${user_time},${sys_time}" >> "$OUTPUT_CSV"
+    echo "${program_name},${function_name},${cpu_percent},${max_rss},${io_read_kb},${io_write_kb},${real_time},${user_time},${sys_time},${placement}" >> "$OUTPUT_CSV"
     
     # Show program output
     print_msg "$BLUE" "Program output:"
     cat "$prog_output" 2>/dev/null | head -20
     
     rm -rf "$tmp_dir"
-    print_msg "$GREEN" "Completed: ${program_name} + ${worker_type}"
+    print_msg "$GREEN" "Completed: ${program_name} + ${function_name}"
+    echo ""
+}
+
+# Memory hierarchy profile of one worker per program for the patterns in
+# MEM_PROFILE (other PA01_MEM_* from the environment), one CSV row per
+# MEMPROF / MEMLEVEL line
+run_mem_profile() {
+    echo "Program,Record,PID,TID,Pattern,Working_Set_or_Level,Level_or_Size,ns_per_access,GB_per_s" > "$MEMPROF_CSV"
+
+    for program in A B; do
+        local program_path="$PROGRAM_A"
+        [[ "$program" == "B" ]] && program_path="$PROGRAM_B"
+
+        print_msg "$YELLOW" "Memory profile: Program_${program} (PA01_MEM_PROFILE=$MEM_PROFILE)"
+        PA01_MEM_PROFILE="$MEM_PROFILE" taskset -c "$CPU_LIST" "$program_path" mem 1 \
+            | grep -E '^MEM(PROF|LEVEL),' \
+            | sed "s/^/Program_${program},/" >> "$MEMPROF_CSV"
+        sleep 1
+    done
+
+    print_msg "$GREEN" "Memory profile saved to: $MEMPROF_CSV"
+    echo ""
+}
+
+# Processes vs threads on each engine of IO_ENGINES (PA01_IO_* knobs from
+# the environment), one CSV row per worker
+run_io_engines() {
+    echo "Program,Record,PID,TID,Engine,Direct,Block_Size,Queue_Depth,Read_Pct,Ops,IOPS,MB_per_s,p50_us,p90_us,p99_us,p999_us,max_us,Sync,Sync_Every" > "$IOENGINE_CSV"
+
+    for engine in $IO_ENGINES; do
+        for program in A B; do
+            local program_path="$PROGRAM_A"
+            [[ "$program" == "B" ]] && program_path="$PROGRAM_B"
+
+            print_msg "$YELLOW" "I/O engine: Program_${program} + ${engine}"
+            PA01_IO_ENGINE="$engine" taskset -c "$CPU_LIST" "$program_path" io 2 \
+                | grep '^IOENGINE,' \
+                | sed "s/^/Program_${program},/" >> "$IOENGINE_CSV"
+            sleep 1
+        done
+    done
+
+    print_msg "$GREEN" "I/O engine results saved to: $IOENGINE_CSV"
     echo ""
 }
 
@@ -209,6 +312,21 @@ main() {
         run_and_measure "B" "$worker"
         sleep 1
     done
+
+    for isa in $(supported_isas); do
+        run_and_measure "A" "cpu" "$isa"
+        sleep 1
+        run_and_measure "B" "cpu" "$isa"
+        sleep 1
+    done
+
+    if [[ -n "$MEM_PROFILE" ]]; then
+        run_mem_profile
+    fi
+
+    if [[ -n "$IO_ENGINES" ]]; then
+        run_io_engines
+    fi
     
     print_summary
     
@@ -4,6 +4,13 @@
 # Graduate Systems (CSE638) - PA01: Processes and Threads
 #
 # Extends Part C to vary process/thread counts and generate plots.
+# The mem worker's NUMA/hugepage placement (PA01_MEM_POLICY,
+# PA01_MEM_PAGES) is recorded in the same extra columns as Part C.
+#
+# With PA01_SCALE_TOTAL set every run shares that fixed number of
+# iterations (strong scaling), a 1-worker baseline is added to both count
+# lists and speedup, efficiency and load balance per run go to
+# MT25042_Part_D_Scaling.csv.
 #
 # Usage: ./MT25042_Part_D_script.sh [cpu_list]
 #
@@ -16,15 +23,25 @@
 ROLL_NUM="MT25042"
 SCRIPT_DIR="$(cd "$(dirname "$0")" && pwd)"
 OUTPUT_CSV="${SCRIPT_DIR}/${ROLL_NUM}_Part_D_CSV.csv"
+SCALING_CSV="${SCRIPT_DIR}/${ROLL_NUM}_Part_D_Scaling.csv"
 PLOT_OUTPUT_DIR="${SCRIPT_DIR}"
 PROGRAM_A="${SCRIPT_DIR}/program_a"
 PROGRAM_B="${SCRIPT_DIR}/program_b"
 CPU_LIST="${1:-0,1,2,3}"
 
+# Every run is a stock worker: modes that replace its work stay off
+unset PA01_MEM_PROFILE PA01_IO_ENGINE PA01_POOL_TASKS
+
 PROCESS_COUNTS=(2 3 4 5)
 THREAD_COUNTS=(2 3 4 5 6 7 8)
 WORKER_TYPES=("cpu" "mem" "io")
 
+# Strong scaling needs the 1-worker time as its baseline
+if [[ -n "$PA01_SCALE_TOTAL" ]]; then
+    PROCESS_COUNTS=(1 "${PROCESS_COUNTS[@]}")
+    THREAD_COUNTS=(1 "${THREAD_COUNTS[@]}")
+fi
+
 # Colors
 RED='\033[0;31m'
 GREEN='\033[0;32m'
@@ -68,7 +85,7 @@ check_dependencies() {
 }
 
 init_csv() {
-    echo "Program,Function,Count,CPU_Percent,Memory_KB,IO_Read_KB,IO_Write_KB,Exec_Time_Real,Exec_Time_User,Exec_Time_Sys" > "$OUTPUT_CSV"
+    echo "Program,Function,Count,CPU_Percent,Memory_KB,IO_Read_KB,IO_Write_KB,Exec_Time_Real,Exec_Time_User,Exec_Time_Sys,Mem_Policy,Remote_KB,Huge_KB,dTLB_Misses" > "$OUTPUT_CSV"
     print_msg "$GREEN" "Initialized CSV: $OUTPUT_CSV"
 }
 
@@ -91,6 +108,23 @@ parse_elapsed() {
     fi
 }
 
+# Mem_Policy,Remote_KB,Huge_KB,dTLB_Misses from the MEMPLACE lines of the
+# mem worker (summed over workers); NA for the other workers.
+# dTLB_Misses is NA when the PMU is not available.
+mem_placement_columns() {
+    awk -F',' '
+        $1 == "MEMPLACE" {
+            if (policy == "") policy = $4 "/" $5
+            remote += $8; huge += $9
+            if ($10 < 0) no_tlb = 1; else tlb += $10
+            n++
+        }
+        END {
+            if (n == 0) { print "NA,NA,NA,NA"; exit }
+            printf "%s,%d,%d,%s\n", policy, remote, huge, no_tlb ? "NA" : tlb
+        }' "$1"
+}
+
 run_and_measure() {
     local program=$1
     local worker_type=$2
@@ -111,10 +145,11 @@ run_and_measure() {
     
     local tmp_dir=$(mktemp -d)
     local time_output="${tmp_dir}/time.txt"
+    local prog_output="${tmp_dir}/prog.txt"
     
     # Run with /usr/bin/time -v
     /usr/bin/time -v taskset -c "$CPU_LIST" "$program_path" "$worker_type" "$count" \
-        > /dev/null 2> "$time_output"
+        > "$prog_output" 2> "$time_output"
     
     # Parse time output
     local user_time=$(grep "User time" "$time_output" | awk -F': ' '{print $2}')
@@ -135,14 +170,36 @@ run_and_measure() {
     [[ -z "$real_time" ]] && real_time="0"
     [[ -z "$user_time" ]] && user_time="0"
     [[ -z "$sys_time" ]] && sys_time="0"
+
+    local placement=$(mem_placement_columns "$prog_output")
+    [[ -n "$PA01_SCALE_TOTAL" ]] && grep '^SCALE,' "$prog_output" >> "${SCALING_CSV}.raw"
     
     echo "  CPU: ${cpu_percent}%, Mem: ${max_rss}KB, IO_W: ${io_write_kb}KB, Time: ${real_time}s"
     
-    echo "${program_name},${worker_type},${count},${cpu_percent},${max_rss},${io_read_kb},${io_write_kb},${real_time},${user_time},${sys_time}" >> "$OUTPUT_CSV"
+    echo "${program_name},${worker_type},${count},${cpu_percent},${max_rss},${io_read_kb},${io_write_kb},${real_time},${user_time},${sys_time},${placement}" >> "$OUTPUT_CSV"
     
     rm -rf "$tmp_dir"
 }
 
+# Speedup = T(1 worker) / T(n), efficiency = speedup / n, per program and
+# worker type, from the SCALE lines of the strong scaling runs
+write_scaling_csv() {
+    echo "Program,Function,Count,Total_Iters,Chunk,Time_s,Speedup,Efficiency,Min_Iters,Max_Iters,Imbalance,Steals" > "$SCALING_CSV"
+    awk -F',' '
+        { key = $2 "," $3; rows[NR] = $0; if ($4 == 1) t1[key] = $7 }
+        END {
+            for (i = 1; i <= NR; i++) {
+                split(rows[i], f, ",")
+                key = f[2] "," f[3]
+                speedup = (key in t1 && f[7] > 0) ? t1[key] / f[7] : 0
+                printf "%s,%s,%s,%s,%s,%s,%.3f,%.3f,%s,%s,%s,%s\n", f[2], f[3], f[4],
+                       f[5], f[6], f[7], speedup, speedup / f[4], f[8], f[9], f[10], f[11]
+            }
+        }' "${SCALING_CSV}.raw" >> "$SCALING_CSV"
+    rm -f "${SCALING_CSV}.raw"
+    print_msg "$GREEN" "Strong scaling results saved to: $SCALING_CSV"
+}
+
 generate_plots() {
     if ! command -v python3 &> /dev/null; then
         print_msg "$YELLOW" "Skipping plots (python3 not available)"
@@ -197,6 +254,7 @@ main() {
     
     check_dependencies
     init_csv
+    rm -f "${SCALING_CSV}.raw"
     
     print_msg "$BLUE" "Testing Program A (fork) with varying process counts..."
     for worker in "${WORKER_TYPES[@]}"; do
@@ -213,6 +271,7 @@ main() {
     done
     
     print_summary
+    [[ -n "$PA01_SCALE_TOTAL" ]] && write_scaling_csv
     generate_plots
     
     print_msg "$GREEN" "=========================================="
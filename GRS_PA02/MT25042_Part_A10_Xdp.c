@@ -0,0 +1,814 @@
+/**
+ * MT25042_Part_A10_Xdp.c
+ * Graduate Systems (CSE638) - PA02: Analysis of Network I/O primitives
+ *
+ * AF_XDP sender / receiver across the veth pair (kernel bypass):
+ *   The same serialized message_t stream as the TCP implementations, but
+ *   carried in raw Ethernet frames through an AF_XDP socket instead of
+ *   the TCP/IP stack.  Frames use the IEEE local-experimental EtherType
+ *   0x88B5 and a 12-byte fragment header:
+ *
+ *     | eth (14) | seq (4) | frag (2) | nfrags (2) | msg_len (4) | payload |
+ *
+ *   A message is split into ceil(msg_size / frag_payload) frames, where
+ *   frag_payload follows the interface MTU.  There is no retransmission:
+ *   a message with a missing fragment is dropped and counted.
+ *
+ *   UMEM: one anonymous mapping of XSK_FRAME_SIZE chunks, enough for
+ *   four messages in flight (at least XSK_MIN_FRAMES).  All four rings
+ *   have one slot per chunk, so a chunk always has a ring to go back to.
+ *     send   chunks sit on a free stack; a message takes nfrags of them,
+ *            fills them (header + slice of the payload) and posts them on
+ *            the TX ring; sendto() kicks the kernel, which returns each
+ *            chunk on the completion ring once transmitted.
+ *     recv   every chunk starts on the fill ring; the kernel hands them
+ *            back on the RX ring, the payload is copied into the message
+ *            buffer and the chunk goes straight back to the fill ring.
+ *
+ *   RX needs an XDP program on the interface that redirects our frames
+ *   into the socket (XSKMAP indexed by rx queue) and passes everything
+ *   else (ARP, IP) to the stack.  It is loaded with the raw bpf()
+ *   syscall, no libbpf, and attached through a BPF link so it goes away
+ *   with the process.  Native (driver) mode is tried first, then generic
+ *   (-S forces generic).  veth has no zero-copy support, so the socket
+ *   runs in copy mode there; the XDP line says which mode was used.
+ *
+ *   The receiver prints the client RESULT line (implementation
+ *   "af_xdp"; latency = time to assemble one message) plus
+ *     XDP,<msg_size>,<drv|skb>,<copy|zerocopy>,<frames>,<lost_msgs>,
+ *         <rx_dropped>,<rx_ring_full>,<fill_ring_empty>
+ *   The sender runs until SIGINT/SIGTERM like the TCP servers.
+ *
+ * Usage: ./a10_xdp [-i ifname] [-q queue] [-S] send <msg_size>
+ *        ./a10_xdp [-i ifname] [-q queue] [-S] recv <msg_size>
+ *                  [duration_sec] [warmup_sec]
+ *
+ * AI Declaration: This code structure was generated with AI assistance;
+ *   ring handling follows Documentation/networking/af_xdp.rst and the XDP
+ *   program follows the eBPF instruction set documentation.
+ */
+
+#define _GNU_SOURCE
+#include "MT25042_Part_A_Common.h"
+#include "MT25042_Part_A_Trace.h"
+#include "MT25042_Part_A_Placement.h"
+#include <net/if.h>
+#include <poll.h>
+#include <signal.h>
+#include <stddef.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <linux/bpf.h>
+#include <linux/if_link.h>
+#include <linux/if_xdp.h>
+
+#ifndef AF_XDP
+#define AF_XDP             44
+#endif
+#ifndef SOL_XDP
+#define SOL_XDP            283
+#endif
+
+#define ETH_P_PA02         0x88B5      /* IEEE 802 local experimental 1 */
+#define ETH_HDR_LEN        14
+#define XSK_FRAME_SIZE     4096
+#define XSK_MIN_FRAMES     4096
+#define XSK_HEADROOM       256         /* XDP_PACKET_HEADROOM (RX)      */
+#define XSK_MAX_QUEUES     64          /* XSKMAP entries                */
+#define XSK_BATCH          64          /* RX descriptors per peek       */
+#define XSK_IDLE_MS        2000        /* receiver gives up after this  */
+#define DEFAULT_IFNAME     "veth_cli"
+
+/* Fragment header, network byte order, right after the Ethernet header */
+typedef struct __attribute__((packed)) {
+    uint8_t  dst[6];
+    uint8_t  src[6];
+    uint16_t proto;
+    uint32_t seq;                      /* message number                */
+    uint16_t frag;                     /* fragment index                */
+    uint16_t nfrags;
+    uint32_t msg_len;
+} frame_hdr_t;
+
+/* One of the four rings; `cached` is our own (producer or consumer) index */
+typedef struct {
+    uint32_t *producer;
+    uint32_t *consumer;
+    uint32_t *flags;
+    void     *ring;
+    uint32_t  size;
+    uint32_t  mask;
+    uint32_t  cached;
+    void     *map;
+    size_t    map_len;
+} xsk_ring_t;
+
+typedef struct {
+    int         fd;
+    int         ifindex;
+    int         queue;
+    int         zerocopy;
+    uint8_t    *umem;
+    size_t      umem_len;
+    uint32_t    nframes;
+    xsk_ring_t  fill, comp, rx, tx;
+    uint64_t   *free_frames;           /* sender: chunks not in flight  */
+    uint32_t    nfree;
+} xsk_t;
+
+static volatile sig_atomic_t g_stop = 0;
+
+static void on_signal(int sig)
+{
+    (void)sig;
+    g_stop = 1;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Rings                                                              */
+/* ------------------------------------------------------------------ */
+
+static int ring_map(int fd, const struct xdp_ring_offset *off, off_t pgoff,
+                    uint32_t size, size_t elem, int producer_side,
+                    xsk_ring_t *r)
+{
+    r->map_len = off->desc + size * elem;
+    r->map = mmap(NULL, r->map_len, PROT_READ | PROT_WRITE,
+                  MAP_SHARED | MAP_POPULATE, fd, pgoff);
+    if (r->map == MAP_FAILED) {
+        perror("mmap xsk ring");
+        r->map = NULL;
+        return -1;
+    }
+    r->producer = (uint32_t *)((char *)r->map + off->producer);
+    r->consumer = (uint32_t *)((char *)r->map + off->consumer);
+    r->flags    = (uint32_t *)((char *)r->map + off->flags);
+    r->ring     = (char *)r->map + off->desc;
+    r->size     = size;
+    r->mask     = size - 1;
+    r->cached   = producer_side ? *r->producer : *r->consumer;
+    return 0;
+}
+
+/* Producer side (fill, TX): free slots */
+static inline uint32_t prod_free(xsk_ring_t *r)
+{
+    return r->size - (r->cached - __atomic_load_n(r->consumer, __ATOMIC_ACQUIRE));
+}
+
+static inline void prod_submit(xsk_ring_t *r, uint32_t n)
+{
+    r->cached += n;
+    __atomic_store_n(r->producer, r->cached, __ATOMIC_RELEASE);
+}
+
+/* Consumer side (RX, completion): entries ready */
+static inline uint32_t cons_avail(xsk_ring_t *r)
+{
+    return __atomic_load_n(r->producer, __ATOMIC_ACQUIRE) - r->cached;
+}
+
+static inline void cons_release(xsk_ring_t *r, uint32_t n)
+{
+    r->cached += n;
+    __atomic_store_n(r->consumer, r->cached, __ATOMIC_RELEASE);
+}
+
+static inline int ring_needs_wakeup(const xsk_ring_t *r)
+{
+    return __atomic_load_n(r->flags, __ATOMIC_RELAXED) & XDP_RING_NEED_WAKEUP;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Socket + UMEM                                                      */
+/* ------------------------------------------------------------------ */
+
+static uint32_t round_pow2(uint32_t v)
+{
+    uint32_t p = 1;
+    while (p < v) p <<= 1;
+    return p;
+}
+
+/**
+ * xsk_open – creates the AF_XDP socket, registers a UMEM of `nframes`
+ *            chunks, maps the fill/completion rings and the RX or TX
+ *            ring, and binds to (ifindex, queue).
+ *            Returns 0 on success, -1 on failure.
+ */
+static int xsk_open(xsk_t *x, int ifindex, int queue, uint32_t nframes,
+                    int is_rx)
+{
+    memset(x, 0, sizeof(*x));
+    x->ifindex = ifindex;
+    x->queue   = queue;
+    x->nframes = nframes;
+
+    x->fd = socket(AF_XDP, SOCK_RAW, 0);
+    if (x->fd < 0) {
+        perror("socket AF_XDP");
+        return -1;
+    }
+
+    x->umem_len = (size_t)nframes * XSK_FRAME_SIZE;
+    x->umem = mmap(NULL, x->umem_len, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+    if (x->umem == MAP_FAILED) {
+        perror("mmap umem");
+        x->umem = NULL;
+        return -1;
+    }
+
+    struct xdp_umem_reg reg = {
+        .addr       = (uint64_t)(uintptr_t)x->umem,
+        .len        = x->umem_len,
+        .chunk_size = XSK_FRAME_SIZE,
+        .headroom   = 0
+    };
+    if (setsockopt(x->fd, SOL_XDP, XDP_UMEM_REG, &reg, sizeof(reg)) < 0) {
+        perror("setsockopt XDP_UMEM_REG");
+        return -1;
+    }
+
+    /* Fill and completion rings are both required to bind */
+    int data_ring = is_rx ? XDP_RX_RING : XDP_TX_RING;
+    if (setsockopt(x->fd, SOL_XDP, XDP_UMEM_FILL_RING, &nframes, sizeof(nframes)) < 0 ||
+        setsockopt(x->fd, SOL_XDP, XDP_UMEM_COMPLETION_RING, &nframes, sizeof(nframes)) < 0 ||
+        setsockopt(x->fd, SOL_XDP, data_ring, &nframes, sizeof(nframes)) < 0) {
+        perror("setsockopt xsk rings");
+        return -1;
+    }
+
+    struct xdp_mmap_offsets off;
+    socklen_t olen = sizeof(off);
+    if (getsockopt(x->fd, SOL_XDP, XDP_MMAP_OFFSETS, &off, &olen) < 0) {
+        perror("getsockopt XDP_MMAP_OFFSETS");
+        return -1;
+    }
+
+    if (ring_map(x->fd, &off.fr, XDP_UMEM_PGOFF_FILL_RING, nframes,
+                 sizeof(uint64_t), 1, &x->fill) < 0 ||
+        ring_map(x->fd, &off.cr, XDP_UMEM_PGOFF_COMPLETION_RING, nframes,
+                 sizeof(uint64_t), 0, &x->comp) < 0)
+        return -1;
+    if (is_rx ? ring_map(x->fd, &off.rx, XDP_PGOFF_RX_RING, nframes,
+                         sizeof(struct xdp_desc), 0, &x->rx)
+              : ring_map(x->fd, &off.tx, XDP_PGOFF_TX_RING, nframes,
+                         sizeof(struct xdp_desc), 1, &x->tx))
+        return -1;
+
+    struct sockaddr_xdp sxdp = {
+        .sxdp_family   = AF_XDP,
+        .sxdp_ifindex  = (uint32_t)ifindex,
+        .sxdp_queue_id = (uint32_t)queue,
+        .sxdp_flags    = XDP_USE_NEED_WAKEUP
+    };
+    if (bind(x->fd, (struct sockaddr *)&sxdp, sizeof(sxdp)) < 0) {
+        perror("bind AF_XDP");
+        return -1;
+    }
+
+    struct xdp_options opts;
+    socklen_t plen = sizeof(opts);
+    if (getsockopt(x->fd, SOL_XDP, XDP_OPTIONS, &opts, &plen) == 0)
+        x->zerocopy = !!(opts.flags & XDP_OPTIONS_ZEROCOPY);
+
+    if (is_rx) {
+        /* Hand every chunk to the kernel up front */
+        uint64_t *fq = (uint64_t *)x->fill.ring;
+        for (uint32_t i = 0; i < nframes; i++)
+            fq[(x->fill.cached + i) & x->fill.mask] = (uint64_t)i * XSK_FRAME_SIZE;
+        prod_submit(&x->fill, nframes);
+    } else {
+        x->free_frames = (uint64_t *)malloc(nframes * sizeof(uint64_t));
+        if (!x->free_frames) { perror("malloc free_frames"); return -1; }
+        for (uint32_t i = 0; i < nframes; i++)
+            x->free_frames[i] = (uint64_t)i * XSK_FRAME_SIZE;
+        x->nfree = nframes;
+    }
+    return 0;
+}
+
+static void xsk_close(xsk_t *x)
+{
+    xsk_ring_t *rings[] = { &x->fill, &x->comp, &x->rx, &x->tx };
+    for (int i = 0; i < 4; i++)
+        if (rings[i]->map) munmap(rings[i]->map, rings[i]->map_len);
+    if (x->fd >= 0) close(x->fd);
+    if (x->umem) munmap(x->umem, x->umem_len);
+    free(x->free_frames);
+}
+
+/* ------------------------------------------------------------------ */
+/*  XDP redirect program (raw bpf(), no libbpf)                        */
+/* ------------------------------------------------------------------ */
+
+#define I_LDX(sz, d, s, o)   { .code = BPF_LDX | BPF_MEM | (sz), \
+                               .dst_reg = (d), .src_reg = (s), .off = (o) }
+#define I_MOV_X(d, s)        { .code = BPF_ALU64 | BPF_MOV | BPF_X, \
+                               .dst_reg = (d), .src_reg = (s) }
+#define I_MOV_K(d, k)        { .code = BPF_ALU64 | BPF_MOV | BPF_K, \
+                               .dst_reg = (d), .imm = (k) }
+#define I_ADD_K(d, k)        { .code = BPF_ALU64 | BPF_ADD | BPF_K, \
+                               .dst_reg = (d), .imm = (k) }
+#define I_JMP_X(op, d, s, o) { .code = BPF_JMP | (op) | BPF_X, \
+                               .dst_reg = (d), .src_reg = (s), .off = (o) }
+#define I_JMP_K(op, d, k, o) { .code = BPF_JMP | (op) | BPF_K, \
+                               .dst_reg = (d), .off = (o), .imm = (k) }
+#define I_LD_MAP(d)          { .code = BPF_LD | BPF_DW | BPF_IMM, \
+                               .dst_reg = (d), .src_reg = BPF_PSEUDO_MAP_FD }, \
+                             { .code = 0 }
+#define I_CALL(f)            { .code = BPF_JMP | BPF_CALL, .imm = (f) }
+#define I_EXIT()             { .code = BPF_JMP | BPF_EXIT }
+
+#define PROG_MAP_INSN      8           /* index of the I_LD_MAP below   */
+
+static int sys_bpf(int cmd, union bpf_attr *attr)
+{
+    return (int)syscall(__NR_bpf, cmd, attr, sizeof(*attr));
+}
+
+/**
+ * xdp_attach – creates an XSKMAP holding `xsk_fd` at `queue`, loads the
+ *              redirect program and links it to the interface.
+ *              *mode gets "drv" or "skb".  Returns the link fd (closing
+ *              it detaches the program) or -1.
+ */
+static int xdp_attach(int ifindex, int queue, int xsk_fd, int force_skb,
+                      const char **mode)
+{
+    union bpf_attr attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.map_type    = BPF_MAP_TYPE_XSKMAP;
+    attr.key_size    = sizeof(uint32_t);
+    attr.value_size  = sizeof(uint32_t);
+    attr.max_entries = XSK_MAX_QUEUES;
+    int map_fd = sys_bpf(BPF_MAP_CREATE, &attr);
+    if (map_fd < 0) {
+        perror("bpf MAP_CREATE xskmap");
+        return -1;
+    }
+
+    /* Frames of ETH_P_PA02 go to the socket of their rx queue (or the
+     * stack if that queue has none); everything else passes */
+    struct bpf_insn prog[] = {
+        I_LDX(BPF_W, BPF_REG_2, BPF_REG_1, offsetof(struct xdp_md, data)),
+        I_LDX(BPF_W, BPF_REG_3, BPF_REG_1, offsetof(struct xdp_md, data_end)),
+        I_MOV_X(BPF_REG_4, BPF_REG_2),
+        I_ADD_K(BPF_REG_4, ETH_HDR_LEN),
+        I_JMP_X(BPF_JGT, BPF_REG_4, BPF_REG_3, 8),            /* → pass */
+        I_LDX(BPF_H, BPF_REG_4, BPF_REG_2, 12),
+        I_JMP_K(BPF_JNE, BPF_REG_4, htons(ETH_P_PA02), 6),    /* → pass */
+        I_LDX(BPF_W, BPF_REG_2, BPF_REG_1,
+              offsetof(struct xdp_md, rx_queue_index)),
+        I_LD_MAP(BPF_REG_1),
+        I_MOV_K(BPF_REG_3, XDP_PASS),          /* action if no socket  */
+        I_CALL(BPF_FUNC_redirect_map),
+        I_EXIT(),
+        I_MOV_K(BPF_REG_0, XDP_PASS),          /* pass:                */
+        I_EXIT(),
+    };
+    prog[PROG_MAP_INSN].imm = map_fd;
+
+    static char log[4096];
+    memset(&attr, 0, sizeof(attr));
+    attr.prog_type = BPF_PROG_TYPE_XDP;
+    attr.insns     = (uint64_t)(uintptr_t)prog;
+    attr.insn_cnt  = sizeof(prog) / sizeof(prog[0]);
+    attr.license   = (uint64_t)(uintptr_t)"Dual BSD/GPL";
+    attr.log_buf   = (uint64_t)(uintptr_t)log;
+    attr.log_size  = sizeof(log);
+    attr.log_level = 1;
+    int prog_fd = sys_bpf(BPF_PROG_LOAD, &attr);
+    if (prog_fd < 0) {
+        perror("bpf PROG_LOAD");
+        fprintf(stderr, "%s", log);
+        close(map_fd);
+        return -1;
+    }
+
+    uint32_t key = (uint32_t)queue, val = (uint32_t)xsk_fd;
+    memset(&attr, 0, sizeof(attr));
+    attr.map_fd = map_fd;
+    attr.key    = (uint64_t)(uintptr_t)&key;
+    attr.value  = (uint64_t)(uintptr_t)&val;
+    if (sys_bpf(BPF_MAP_UPDATE_ELEM, &attr) < 0) {
+        perror("bpf MAP_UPDATE_ELEM");
+        close(prog_fd);
+        close(map_fd);
+        return -1;
+    }
+
+    int link_fd = -1;
+    for (int skb = force_skb; skb <= 1 && link_fd < 0; skb++) {
+        memset(&attr, 0, sizeof(attr));
+        attr.link_create.prog_fd        = (uint32_t)prog_fd;
+        attr.link_create.target_ifindex = (uint32_t)ifindex;
+        attr.link_create.attach_type    = BPF_XDP;
+        attr.link_create.flags = skb ? XDP_FLAGS_SKB_MODE : XDP_FLAGS_DRV_MODE;
+        link_fd = sys_bpf(BPF_LINK_CREATE, &attr);
+        if (link_fd < 0)
+            fprintf(stderr, "[XDP] %s mode attach failed: %s\n",
+                    skb ? "generic" : "native", strerror(errno));
+        else
+            *mode = skb ? "skb" : "drv";
+    }
+
+    /* The link and the socket keep the program and the map alive */
+    close(prog_fd);
+    close(map_fd);
+    return link_fd;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Sender                                                             */
+/* ------------------------------------------------------------------ */
+
+static inline void xsk_kick_tx(xsk_t *x)
+{
+    if (sendto(x->fd, NULL, 0, MSG_DONTWAIT, NULL, 0) < 0 &&
+        errno != EAGAIN && errno != EBUSY && errno != ENOBUFS &&
+        errno != ENETDOWN) {
+        perror("sendto xsk kick");
+        g_stop = 1;
+    }
+}
+
+/* Moves transmitted chunks from the completion ring to the free stack */
+static inline void xsk_reclaim(xsk_t *x)
+{
+    uint32_t n = cons_avail(&x->comp);
+    const uint64_t *cq = (const uint64_t *)x->comp.ring;
+    for (uint32_t i = 0; i < n; i++)
+        x->free_frames[x->nfree++] = cq[(x->comp.cached + i) & x->comp.mask];
+    if (n) cons_release(&x->comp, n);
+}
+
+static int run_sender(xsk_t *x, const uint8_t mac[6], int msg_size,
+                      int frag_payload)
+{
+    message_t *msg = create_message(msg_size);
+    int len = 0;
+    char *payload = msg ? serialize_message(msg, &len) : NULL;
+    if (!payload) return -1;
+
+    int nfrags = (len + frag_payload - 1) / frag_payload;
+    frame_hdr_t hdr;
+    memset(hdr.dst, 0xff, sizeof(hdr.dst));        /* broadcast         */
+    memcpy(hdr.src, mac, sizeof(hdr.src));
+    hdr.proto   = htons(ETH_P_PA02);
+    hdr.nfrags  = htons((uint16_t)nfrags);
+    hdr.msg_len = htonl((uint32_t)len);
+
+    cpu_meter_t meter;
+    cpu_meter_start(&meter);
+    double t_start = now_sec();
+    long long msgs = 0, frames = 0, kicks = 0;
+
+    while (!g_stop) {
+        xsk_reclaim(x);
+        if (x->nfree < (uint32_t)nfrags || prod_free(&x->tx) < (uint32_t)nfrags) {
+            xsk_kick_tx(x);                    /* drains TX, fills comp */
+            kicks++;
+            continue;
+        }
+
+        trace_event(TR_SEND_BEGIN, (uint32_t)len, 0);
+        hdr.seq = htonl((uint32_t)msgs);
+        struct xdp_desc *tx = (struct xdp_desc *)x->tx.ring;
+        for (int f = 0; f < nfrags; f++) {
+            int      off   = f * frag_payload;
+            int      chunk = len - off < frag_payload ? len - off : frag_payload;
+            uint64_t addr  = x->free_frames[--x->nfree];
+            uint8_t *frame = x->umem + addr;
+
+            hdr.frag = htons((uint16_t)f);
+            memcpy(frame, &hdr, sizeof(hdr));
+            memcpy(frame + sizeof(hdr), payload + off, chunk);
+
+            struct xdp_desc *d = &tx[(x->tx.cached + f) & x->tx.mask];
+            d->addr    = addr;
+            d->len     = (uint32_t)(sizeof(hdr) + chunk);
+            d->options = 0;
+        }
+        prod_submit(&x->tx, (uint32_t)nfrags);
+        xsk_kick_tx(x);                        /* copy mode always needs it */
+        kicks++;
+        trace_event(TR_SEND_END, (uint32_t)len, 0);
+
+        msgs++;
+        frames += nfrags;
+    }
+
+    double secs = now_sec() - t_start;
+    unsigned long long cost = cpu_meter_stop(&meter);
+    long long bytes = msgs * (long long)len;
+    printf("[Sender] %lld msgs, %lld frames, %lld kicks in %.1fs: offered "
+           "%.4f Gbps, %.3f %s/byte\n", msgs, frames, kicks, secs,
+           secs > 0 ? bytes * 8.0 / secs / 1e9 : 0.0,
+           bytes > 0 ? (double)cost / bytes : 0.0, meter.unit);
+
+    free(payload);
+    free_message(msg);
+    return 0;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Receiver                                                           */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+    uint32_t  seq;                     /* message being assembled       */
+    int       got;                     /* fragments received in order   */
+    int       active;                  /* `seq` not complete yet        */
+    int       seen;                    /* `seq` is valid                */
+    long long frames;
+    long long lost_msgs;
+} reasm_t;
+
+/**
+ * xsk_recv_message – assembles the next complete message into `buf`.
+ *                    Chunks go back to the fill ring as soon as their
+ *                    payload is copied.  Returns 1 on a complete message,
+ *                    0 on stop or XSK_IDLE_MS without traffic, -1 on a
+ *                    framing mismatch.
+ */
+static int xsk_recv_message(xsk_t *x, reasm_t *ra, char *buf, int msg_size,
+                            int frag_payload)
+{
+    struct pollfd pfd = { .fd = x->fd, .events = POLLIN };
+    const struct xdp_desc *rx = (const struct xdp_desc *)x->rx.ring;
+    uint64_t *fq = (uint64_t *)x->fill.ring;
+
+    while (!g_stop) {
+        uint32_t n = cons_avail(&x->rx);
+        if (n == 0) {
+            if (ring_needs_wakeup(&x->fill))
+                recvfrom(x->fd, NULL, 0, MSG_DONTWAIT, NULL, NULL);
+            int rc = poll(&pfd, 1, XSK_IDLE_MS);
+            if (rc == 0) return 0;
+            if (rc < 0 && errno != EINTR) { perror("poll xsk"); return -1; }
+            continue;
+        }
+        if (n > XSK_BATCH) n = XSK_BATCH;
+
+        int done = 0, bad = 0;
+        uint32_t i;
+        for (i = 0; i < n && !done; i++) {
+            const struct xdp_desc *d = &rx[(x->rx.cached + i) & x->rx.mask];
+            const frame_hdr_t *h = (const frame_hdr_t *)(x->umem + d->addr);
+            ra->frames++;
+
+            uint32_t seq    = ntohl(h->seq);
+            int      frag   = ntohs(h->frag);
+            int      nfrags = ntohs(h->nfrags);
+            int      chunk  = (int)d->len - (int)sizeof(frame_hdr_t);
+
+            if (d->len < sizeof(frame_hdr_t) || ntohs(h->proto) != ETH_P_PA02) {
+                /* not ours: the program only redirects ETH_P_PA02 */
+            } else if ((int)ntohl(h->msg_len) != msg_size) {
+                fprintf(stderr, "Error: sender uses msg_size %u, expected %d\n",
+                        ntohl(h->msg_len), msg_size);
+                bad = done = 1;
+            } else {
+                if (!ra->seen || seq != ra->seq) {
+                    /* unfinished message + messages never seen at all.
+                     * Only a forward jump is a gap; a lower seq
+                     * (reordering, sender restart) just resyncs */
+                    int32_t ahead = (int32_t)(seq - ra->seq);
+                    if (ra->seen)
+                        ra->lost_msgs += ra->active + (ahead > 0 ? ahead - 1 : 0);
+                    ra->seq    = seq;
+                    ra->got    = 0;
+                    ra->active = 1;
+                    ra->seen   = 1;
+                }
+                if (frag == ra->got && chunk > 0 &&
+                    frag * frag_payload + chunk <= msg_size) {
+                    memcpy(buf + frag * frag_payload, h + 1, chunk);
+                    if (++ra->got == nfrags) {
+                        ra->active = 0;
+                        done = 1;
+                    }
+                } else {
+                    ra->got = -1;              /* gap: wait for next seq */
+                }
+            }
+
+            fq[(x->fill.cached + i) & x->fill.mask] =
+                d->addr & ~(uint64_t)(XSK_FRAME_SIZE - 1);
+        }
+
+        /* Every chunk taken off RX goes back to the kernel at once */
+        cons_release(&x->rx, i);
+        prod_submit(&x->fill, i);
+        if (done) return bad ? -1 : 1;
+    }
+    return 0;
+}
+
+static int run_receiver(xsk_t *x, const char *xdp_mode, int msg_size,
+                        int frag_payload, int duration, int warmup)
+{
+    char *buf = (char *)malloc(msg_size);
+    if (!buf) { perror("malloc recv buf"); return -1; }
+
+    reasm_t ra;
+    memset(&ra, 0, sizeof(ra));
+    int rc = 1;
+
+    double t_warm = now_sec() + warmup;
+    while (now_sec() < t_warm && rc > 0)
+        rc = xsk_recv_message(x, &ra, buf, msg_size, frag_payload);
+
+    long long total_bytes = 0;
+    long      msg_count   = 0;
+    uint64_t  latency_ticks = 0;
+    long long frames0 = ra.frames, lost0 = ra.lost_msgs;
+    double    t_start = now_sec();
+
+    deadline_t dl;
+    deadline_set(&dl, duration, DEADLINE_CHECK_EVERY);
+
+    /* Time spent on a message that is later dropped is charged to the
+     * next complete one, as a retransmission would be */
+    while (rc > 0 && !deadline_passed(&dl)) {
+        uint64_t t0 = ticks_now();
+        trace_event(TR_RECV_BEGIN, 0, 0);
+        rc = xsk_recv_message(x, &ra, buf, msg_size, frag_payload);
+        trace_event(TR_RECV_END, rc > 0 ? (uint32_t)msg_size : 0, 0);
+        if (rc <= 0) break;
+
+        latency_ticks += ticks_end() - t0;
+        total_bytes   += msg_size;
+        msg_count++;
+    }
+
+    double elapsed = now_sec() - t_start;
+    double tp_gbps = elapsed > 0 ? total_bytes * 8.0 / elapsed / 1e9 : 0;
+    double avg_lat = msg_count > 0 ? ticks_to_us(latency_ticks) / msg_count : 0;
+
+    struct xdp_statistics st;
+    socklen_t slen = sizeof(st);
+    memset(&st, 0, sizeof(st));
+    getsockopt(x->fd, SOL_XDP, XDP_STATISTICS, &st, &slen);
+
+    printf("RESULT,af_xdp,%d,1,%.4f,%.2f,%lld,%ld\n",
+           msg_size, tp_gbps, avg_lat, total_bytes, msg_count);
+    printf("XDP,%d,%s,%s,%lld,%lld,%llu,%llu,%llu\n", msg_size, xdp_mode,
+           x->zerocopy ? "zerocopy" : "copy", ra.frames - frames0,
+           ra.lost_msgs - lost0, (unsigned long long)st.rx_dropped,
+           (unsigned long long)st.rx_ring_full,
+           (unsigned long long)st.rx_fill_ring_empty_descs);
+    printf("[Client] Throughput: %.4f Gbps  |  Avg latency: %.2f µs  "
+           "|  Total: %lld bytes, %ld msgs, %lld lost\n",
+           tp_gbps, avg_lat, total_bytes, msg_count, ra.lost_msgs - lost0);
+
+    free(buf);
+    return rc < 0 ? -1 : 0;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Main                                                               */
+/* ------------------------------------------------------------------ */
+
+/* MAC address and MTU of `ifname`; returns 0 on success */
+static int if_info(const char *ifname, uint8_t mac[6], int *mtu)
+{
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    struct ifreq ifr;
+    memset(&ifr, 0, sizeof(ifr));
+    snprintf(ifr.ifr_name, sizeof(ifr.ifr_name), "%s", ifname);
+
+    int rc = -1;
+    if (fd >= 0 && ioctl(fd, SIOCGIFHWADDR, &ifr) == 0) {
+        memcpy(mac, ifr.ifr_hwaddr.sa_data, 6);
+        if (ioctl(fd, SIOCGIFMTU, &ifr) == 0) {
+            *mtu = ifr.ifr_mtu;
+            rc = 0;
+        }
+    }
+    if (rc < 0) perror("ioctl SIOCGIFHWADDR/SIOCGIFMTU");
+    if (fd >= 0) close(fd);
+    return rc;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s [-i ifname] [-q queue] [-S] send <msg_size>\n"
+            "       %s [-i ifname] [-q queue] [-S] recv <msg_size> "
+            "[duration] [warmup]\n"
+            "  -i  interface (default %s)\n"
+            "  -q  queue id (default 0)\n"
+            "  -S  attach the XDP program in generic (skb) mode only\n",
+            prog, prog, DEFAULT_IFNAME);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *ifname = DEFAULT_IFNAME;
+    int queue = 0, force_skb = 0;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "i:q:Sh")) != -1) {
+        switch (opt) {
+        case 'i': ifname    = optarg;       break;
+        case 'q': queue     = atoi(optarg); break;
+        case 'S': force_skb = 1;            break;
+        default:
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (argc - optind < 2) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    int is_rx;
+    if (strcmp(argv[optind], "recv") == 0)      is_rx = 1;
+    else if (strcmp(argv[optind], "send") == 0) is_rx = 0;
+    else {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    int msg_size = atoi(argv[optind + 1]);
+    int duration = argc - optind > 2 ? atoi(argv[optind + 2]) : DEFAULT_DURATION;
+    int warmup   = argc - optind > 3 ? atoi(argv[optind + 3]) : 0;
+    if (msg_size < NUM_FIELDS || duration <= 0 || warmup < 0 ||
+        queue < 0 || queue >= XSK_MAX_QUEUES) {
+        fprintf(stderr, "Error: msg_size must be >= %d, duration > 0, "
+                "queue 0..%d\n", NUM_FIELDS, XSK_MAX_QUEUES - 1);
+        return EXIT_FAILURE;
+    }
+    /* Payload is split evenly over the fields, as in create_message() */
+    msg_size -= msg_size % NUM_FIELDS;
+
+    int ifindex = (int)if_nametoindex(ifname);
+    uint8_t mac[6];
+    int mtu = 0;
+    if (ifindex == 0) {
+        fprintf(stderr, "Error: no interface '%s'\n", ifname);
+        return EXIT_FAILURE;
+    }
+    if (if_info(ifname, mac, &mtu) < 0) return EXIT_FAILURE;
+
+    int frag_payload = mtu - (int)sizeof(frame_hdr_t) + ETH_HDR_LEN;
+    if (frag_payload > XSK_FRAME_SIZE - XSK_HEADROOM - (int)sizeof(frame_hdr_t))
+        frag_payload = XSK_FRAME_SIZE - XSK_HEADROOM - (int)sizeof(frame_hdr_t);
+    int nfrags = (msg_size + frag_payload - 1) / frag_payload;
+    if (nfrags > UINT16_MAX) {
+        fprintf(stderr, "Error: msg_size needs more than %d frames\n", UINT16_MAX);
+        return EXIT_FAILURE;
+    }
+    uint32_t nframes = round_pow2(4 * (uint32_t)nfrags > XSK_MIN_FRAMES
+                                  ? 4 * (uint32_t)nfrags : XSK_MIN_FRAMES);
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_signal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    timing_init();
+    trace_init();
+    placement_init(is_rx ? ROLE_CLIENT : ROLE_SERVER);
+    placement_pin(0);
+
+    xsk_t x;
+    if (xsk_open(&x, ifindex, queue, nframes, is_rx) < 0) {
+        xsk_close(&x);
+        return EXIT_FAILURE;
+    }
+
+    int rc;
+    if (is_rx) {
+        const char *mode = "none";
+        int link_fd = xdp_attach(ifindex, queue, x.fd, force_skb, &mode);
+        if (link_fd < 0) {
+            xsk_close(&x);
+            return EXIT_FAILURE;
+        }
+        printf("[Client] AF_XDP receive on %s queue %d (xdp %s, %s, %d-byte "
+               "fragments, %u frames)  msg=%d  dur=%ds\n", ifname, queue, mode,
+               x.zerocopy ? "zero-copy" : "copy", frag_payload, nframes,
+               msg_size, duration);
+        fflush(stdout);
+        rc = run_receiver(&x, mode, msg_size, frag_payload, duration, warmup);
+        close(link_fd);
+    } else {
+        printf("[Server] AF_XDP send on %s queue %d (%s, %d-byte fragments, "
+               "%d per message, %u frames)  msg=%d\n", ifname, queue,
+               x.zerocopy ? "zero-copy" : "copy", frag_payload, nfrags,
+               nframes, msg_size);
+        fflush(stdout);
+        rc = run_sender(&x, mac, msg_size, frag_payload);
+    }
+
+    xsk_close(&x);
+    return rc < 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -13,7 +13,10 @@
  *   the structure to match the assignment's message format.
  */
 
+#define _GNU_SOURCE
 #include "MT25042_Part_A_Common.h"
+#include "MT25042_Part_A_TcpInfo.h"
+#include "MT25042_Part_A_Placement.h"
 
 /* ------------------------------------------------------------------ */
 /*  Per-client handler thread                                          */
@@ -26,6 +29,10 @@ static void *handle_client(void *arg)
     int msg_size      = ta->msg_size;
     int tid           = ta->thread_id;
     free(ta);
+    tcpinfo_add(fd);
+
+    int cpu = placement_pin(tid);
+    if (cpu >= 0) printf("[Server T%d] Pinned to CPU %d\n", tid, cpu);
 
     printf("[Server T%d] Handling client on fd %d, msg_size=%d\n",
            tid, fd, msg_size);
@@ -78,6 +85,9 @@ int main(int argc, char *argv[])
         return EXIT_FAILURE;
     }
 
+    tcpinfo_init("server");
+    placement_init(ROLE_SERVER);
+
     int server_fd = create_tcp_socket();
 
     struct sockaddr_in addr = {
@@ -8,12 +8,17 @@
  *   for symmetry, but the key optimisation is on the send path.
  *
  * Usage: ./a2_client <server_ip> <msg_size> <num_threads> [duration_sec]
+ *                      [warmup_sec]
  *
  * AI Declaration: Reused the client template from A1 and adapted
  *   recv to use recvmsg with iovec for consistency.
  */
 
+#define _GNU_SOURCE
 #include "MT25042_Part_A_Common.h"
+#include "MT25042_Part_A_Trace.h"
+#include "MT25042_Part_A_TcpInfo.h"
+#include "MT25042_Part_A_Placement.h"
 #include <sys/uio.h>
 
 /* ------------------------------------------------------------------ */
@@ -23,6 +28,7 @@
 static void *client_thread(void *arg)
 {
     client_arg_t *ca = (client_arg_t *)arg;
+    placement_pin(ca->thread_id);
 
     int fd = create_tcp_socket();
 
@@ -37,6 +43,7 @@ static void *client_thread(void *arg)
         close(fd);
         return NULL;
     }
+    tcpinfo_add(fd);
 
     int total_msg_size = ca->msg_size;
     char *buf = (char *)malloc(total_msg_size);
@@ -46,22 +53,32 @@ static void *client_thread(void *arg)
     long      msg_count   = 0;
     double    latency_sum = 0.0;
 
+    /* Warm-up: receive without measuring so the connection and caches
+     * reach steady state before the measured window starts */
+    double t_warm = now_sec() + ca->warmup_sec;
+    while (now_sec() < t_warm) {
+        if (recv_all(fd, buf, total_msg_size, 0) <= 0) break;
+    }
+
     double t_start = now_sec();
-    double t_end   = t_start + ca->duration_sec;
 
-    while (now_sec() < t_end) {
-        struct timespec ts_begin, ts_finish;
-        clock_gettime(CLOCK_MONOTONIC, &ts_begin);
+    deadline_t dl;
+    deadline_set(&dl, ca->duration_sec, DEADLINE_CHECK_EVERY);
+    uint64_t latency_ticks = 0;
+
+    while (!deadline_passed(&dl)) {
+        uint64_t t0 = ticks_now();
+        trace_event(TR_RECV_BEGIN, 0, 0);
 
         ssize_t n = recv_all(fd, buf, total_msg_size, 0);
+        trace_event(TR_RECV_END, (uint32_t)n, n < 0 ? (uint64_t)errno : 0);
         if (n <= 0) break;
 
-        clock_gettime(CLOCK_MONOTONIC, &ts_finish);
-
-        total_bytes += n;
+        latency_ticks += ticks_end() - t0;
+        total_bytes   += n;
         msg_count++;
-        latency_sum += elapsed_us(&ts_begin, &ts_finish);
     }
+    latency_sum = ticks_to_us(latency_ticks);
 
     double elapsed = now_sec() - t_start;
     ca->total_bytes    = total_bytes;
@@ -82,7 +99,8 @@ int main(int argc, char *argv[])
 {
     if (argc < 4) {
         fprintf(stderr,
-                "Usage: %s <server_ip> <msg_size> <num_threads> [duration]\n",
+                "Usage: %s <server_ip> <msg_size> <num_threads> [duration] "
+                "[warmup]\n",
                 argv[0]);
         return EXIT_FAILURE;
     }
@@ -91,8 +109,9 @@ int main(int argc, char *argv[])
     int msg_size          = atoi(argv[2]);
     int num_threads       = atoi(argv[3]);
     int duration          = (argc >= 5) ? atoi(argv[4]) : DEFAULT_DURATION;
+    int warmup            = (argc >= 6) ? atoi(argv[5]) : 0;
 
-    if (msg_size <= 0 || num_threads <= 0 || duration <= 0) {
+    if (msg_size <= 0 || num_threads <= 0 || duration <= 0 || warmup < 0) {
         fprintf(stderr, "Error: all numeric args must be > 0\n");
         return EXIT_FAILURE;
     }
@@ -100,6 +119,11 @@ int main(int argc, char *argv[])
     printf("[Client] One-copy → %s:%d  msg=%d  threads=%d  dur=%ds\n",
            server_ip, DEFAULT_PORT, msg_size, num_threads, duration);
 
+    timing_init();
+    trace_init();
+    tcpinfo_init("client");
+    placement_init(ROLE_CLIENT);
+
     pthread_t    *tids = (pthread_t *)calloc(num_threads, sizeof(pthread_t));
     client_arg_t *args = (client_arg_t *)calloc(num_threads, sizeof(client_arg_t));
 
@@ -108,6 +132,7 @@ int main(int argc, char *argv[])
         args[i].server_port  = DEFAULT_PORT;
         args[i].msg_size     = msg_size;
         args[i].duration_sec = duration;
+        args[i].warmup_sec   = warmup;
         args[i].thread_id    = i;
         if (pthread_create(&tids[i], NULL, client_thread, &args[i]) != 0) {
             perror("pthread_create"); return EXIT_FAILURE;
@@ -135,6 +160,10 @@ int main(int argc, char *argv[])
     printf("[Client] Throughput: %.4f Gbps  |  Avg latency: %.2f µs  "
            "|  Total: %lld bytes, %ld msgs\n",
            tp_gbps, avg_lat, total_b, total_m);
+    if (g_place.policy != PLACE_NONE) {
+        char where[512];
+        printf("PLACEMENT,client,%s\n", placement_describe(where, sizeof(where)));
+    }
 
     free(tids);
     free(args);
@@ -0,0 +1,555 @@
+/**
+ * MT25042_Part_A4_Client.c
+ * Graduate Systems (CSE638) - PA02: Analysis of Network I/O primitives
+ *
+ * Client for the reconfigurable A4 server:
+ *   Same receive loop and RESULT line as the A1-A3 clients, plus the
+ *   connection-level modes that need cooperation from the receiver:
+ *     -T ktls  install the static kTLS keys after connect(); recv()
+ *              then returns decrypted data
+ *     -T user  decrypt the user-space AES-GCM records with OpenSSL
+ *     -Z       read LZ frames (server started with -Z) and decompress
+ *   -s only sets the implementation label in the RESULT line (the server
+ *   decides how it sends).
+ *
+ *   Besides RESULT (payload throughput), a WIRE line reports the
+ *   throughput on the socket, the compression ratio and the receive
+ *   threads' CPU cost per payload byte:
+ *     WIRE,<impl>,<msg_size>,<threads>,<effective_gbps>,<wire_gbps>,
+ *          <ratio>,<cost_per_byte>,<cycles|cpu_ns>
+ *   With -Z, latency is measured per frame (recv + decompress).
+ *
+ *   -D up|both (server started with the same direction) makes the client
+ *   send with the -s strategy (two_copy, one_copy, zero_copy), on the
+ *   receive thread (up) or on a second thread per connection (both).
+ *   A DIR line reports throughput per direction and the client's CPU
+ *   cost per byte for receiving and for sending:
+ *     DIR,<impl>,<msg_size>,<threads>,<down_gbps>,<up_gbps>,
+ *         <rx_cost_per_byte>,<tx_cost_per_byte>,<cycles|cpu_ns>
+ *   RESULT then carries the sum of both directions.
+ *
+ *   -P spin_us receives with non-blocking recv() and user-space spinning
+ *   for up to spin_us per wait before sleeping in epoll_wait() (-1: never
+ *   sleep; 0: always sleep, the non-blocking baseline).  -K us adds
+ *   kernel busy polling (SO_BUSY_POLL, SO_PREFER_BUSY_POLL, epoll
+ *   busy-poll parameters); see MT25042_Part_A_BusyPoll.h.  A POLL line
+ *   puts the latency next to the receive CPU spent per message:
+ *     POLL,<impl>,<msg_size>,<threads>,<spin_us>,<kernel_us>,<latency_us>,
+ *          <cost_per_msg>,<cycles|cpu_ns>,<spin_hit_pct>,<sleeps_per_msg>
+ *
+ * Usage: ./a4_client [-s strategy] [-T tls] [-Z] [-D direction] [-p port]
+ *                    [-P spin_us] [-K busy_poll_us] <server_ip> <msg_size> <num_threads> [duration_sec]
+ *                    [warmup_sec]
+ *
+ * AI Declaration: Reused the client structure from A1-A3; no new AI
+ *   prompts.
+ */
+
+#define _GNU_SOURCE
+#include "MT25042_Part_A_Strategy.h"
+#include "MT25042_Part_A_TLS.h"
+#include "MT25042_Part_A_Compress.h"
+#include "MT25042_Part_A_Receive.h"
+#include "MT25042_Part_A_TcpInfo.h"
+#include "MT25042_Part_A_Placement.h"
+#include "MT25042_Part_A_BusyPoll.h"
+#include <limits.h>
+
+/* Connection-level options shared by all client threads */
+static int g_tls       = TLS_MODE_NONE;
+static int g_compress  = 0;
+static int g_direction = DIR_DOWN;
+static int g_strategy  = STRAT_TWO_COPY;
+static int g_spin_us   = INT_MIN;      /* INT_MIN: blocking recv_all()  */
+static int g_kpoll_us  = 0;
+
+/* Per-thread arguments: the common ones plus wire-level results */
+typedef struct {
+    client_arg_t        ca;            /* receive direction             */
+    int                 fd;
+    long long           wire_bytes;
+    unsigned long long  rx_cost;       /* receive-thread CPU            */
+    const char         *cost_unit;
+    busypoll_t          bp;            /* -P: receive state + counters  */
+
+    /* send direction (up / both) */
+    long long           tx_bytes;
+    long                tx_msgs;
+    double              tx_bps;
+    double              tx_latency_us;
+    unsigned long long  tx_cost;
+} a4_arg_t;
+
+/* Buffers for one compressed frame and its decompressed payload */
+typedef struct {
+    unsigned char *comp;
+    size_t         comp_cap;
+    unsigned char *raw;
+    size_t         raw_cap;
+} frame_buf_t;
+
+/* ------------------------------------------------------------------ */
+/*  Per-thread receive loop                                            */
+/* ------------------------------------------------------------------ */
+
+static ssize_t recv_message(int fd, utls_t *ut, busypoll_t *bp, char *buf,
+                            int len)
+{
+    if (g_tls == TLS_MODE_USER)
+        return utls_recv(ut, fd, buf, (size_t)len);
+    if (g_spin_us != INT_MIN)
+        return busypoll_recv_all(bp, buf, (size_t)len);
+    return recv_all(fd, buf, len, 0);
+}
+
+/* Grows *buf to at least `need` bytes; returns 0 or -1 */
+static int reserve(unsigned char **buf, size_t *cap, size_t need)
+{
+    if (need <= *cap) return 0;
+    unsigned char *nb = (unsigned char *)realloc(*buf, need);
+    if (!nb) return -1;
+    *buf = nb;
+    *cap = need;
+    return 0;
+}
+
+/**
+ * recv_frame – reads one LZ frame and decompresses it.  Returns the
+ *              payload bytes (0 on EOF, -1 on error); *msgs and *wire get
+ *              the frame's message count and on-the-wire size.
+ */
+static ssize_t recv_frame(int fd, frame_buf_t *fb, long *msgs, long long *wire)
+{
+    unsigned char hdr[LZ_FRAME_HDR];
+    ssize_t n = recv_all(fd, (char *)hdr, LZ_FRAME_HDR, 0);
+    if (n <= 0) return n;
+
+    uint32_t raw_len  = lz_get32(hdr);
+    uint32_t comp_len = lz_get32(hdr + 4);
+    if (raw_len > LZ_FRAME_MAX || comp_len > LZ_FRAME_MAX ||
+        reserve(&fb->comp, &fb->comp_cap, comp_len) < 0 ||
+        reserve(&fb->raw, &fb->raw_cap, raw_len) < 0) {
+        fprintf(stderr, "recv_frame: bad frame (%u -> %u bytes)\n",
+                comp_len, raw_len);
+        return -1;
+    }
+
+    n = recv_all(fd, (char *)fb->comp, comp_len, 0);
+    if (n <= 0) return n;
+
+    if (lz_decompress(fb->comp, comp_len, fb->raw, raw_len) != raw_len) {
+        fprintf(stderr, "recv_frame: corrupt compressed block\n");
+        return -1;
+    }
+    *msgs = (long)lz_get32(hdr + 8);
+    *wire = LZ_FRAME_HDR + comp_len;
+    return (ssize_t)raw_len;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Per-thread send loop (up / both)                                   */
+/* ------------------------------------------------------------------ */
+
+static void *tx_loop(void *arg)
+{
+    a4_arg_t     *aa = (a4_arg_t *)arg;
+    client_arg_t *ca = &aa->ca;
+    placement_pin(g_direction == DIR_BOTH ? placement_duplex(ca->thread_id, 1)
+                                          : ca->thread_id);
+
+    sender_t s;
+    if (sender_init(&s, aa->fd, g_strategy, ca->msg_size) < 0) return NULL;
+
+    double t_warm = now_sec() + ca->warmup_sec;
+    while (now_sec() < t_warm) {
+        if (sender_send(&s) <= 0) break;
+    }
+
+    cpu_meter_t meter;
+    cpu_meter_start(&meter);
+
+    long long total_bytes = 0;
+    long      msg_count   = 0;
+    uint64_t  lat_ticks   = 0;
+    double    t_start     = now_sec();
+
+    deadline_t dl;
+    deadline_set(&dl, ca->duration_sec, DEADLINE_CHECK_EVERY);
+
+    while (!deadline_passed(&dl)) {
+        uint64_t t0 = ticks_now();
+
+        ssize_t n = sender_send(&s);
+        if (n <= 0) break;
+
+        lat_ticks   += ticks_end() - t0;
+        total_bytes += n;
+        msg_count++;
+    }
+    double latency_sum = ticks_to_us(lat_ticks);
+
+    double elapsed    = now_sec() - t_start;
+    aa->tx_cost       = cpu_meter_stop(&meter);
+    aa->cost_unit     = meter.unit;
+    aa->tx_bytes      = total_bytes;
+    aa->tx_msgs       = msg_count;
+    aa->tx_bps        = (elapsed > 0) ? (total_bytes * 8.0) / elapsed : 0;
+    aa->tx_latency_us = (msg_count > 0) ? latency_sum / msg_count : 0;
+
+    sender_free(&s);
+    return NULL;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Per-thread connection: receive loop, plus sender for up / both     */
+/* ------------------------------------------------------------------ */
+
+static void *client_thread(void *arg)
+{
+    a4_arg_t     *aa = (a4_arg_t *)arg;
+    client_arg_t *ca = &aa->ca;
+    placement_pin(g_direction == DIR_BOTH ? placement_duplex(ca->thread_id, 0)
+                                          : ca->thread_id);
+
+    int fd = create_tcp_socket();
+
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port   = htons(ca->server_port)
+    };
+    inet_pton(AF_INET, ca->server_ip, &addr.sin_addr);
+
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        perror("connect");
+        close(fd);
+        return NULL;
+    }
+
+    if (g_tls == TLS_MODE_KTLS && ktls_install(fd, 0, 0) < 0) {
+        close(fd);
+        return NULL;
+    }
+
+    aa->fd = fd;
+    tcpinfo_add(fd);
+    if (g_direction == DIR_UP) {
+        tx_loop(aa);
+        close(fd);
+        return NULL;
+    }
+
+    /* Down only (checked in main): the socket turns non-blocking */
+    aa->bp.epfd = -1;
+    if (g_spin_us != INT_MIN &&
+        busypoll_init(&aa->bp, fd, g_spin_us, g_kpoll_us) < 0) {
+        close(fd);
+        return NULL;
+    }
+
+    pthread_t tx_thread;
+    int       tx_running = (g_direction == DIR_BOTH &&
+                            pthread_create(&tx_thread, NULL, tx_loop, aa) == 0);
+
+    int total_msg_size = (ca->msg_size / NUM_FIELDS) * NUM_FIELDS;
+    char *buf = (char *)malloc(total_msg_size);
+    utls_t ut = { 0 };
+    if (!buf || (g_tls == TLS_MODE_USER &&
+                 utls_init(&ut, &tls_key_s2c, (size_t)total_msg_size) < 0)) {
+        if (!buf) perror("malloc recv buf");
+        if (tx_running) {
+            shutdown(fd, SHUT_RDWR);
+            pthread_join(tx_thread, NULL);
+        }
+        busypoll_free(&aa->bp);
+        free(buf);
+        close(fd);
+        return NULL;
+    }
+
+    frame_buf_t fb = { 0 };
+    long        frame_msgs;
+    long long   frame_wire;
+
+    long long total_bytes = 0;
+    long long wire_bytes  = 0;
+    long      msg_count   = 0;
+    long      samples     = 0;
+    uint64_t  lat_ticks   = 0;
+
+    /* Warm-up: receive without measuring */
+    double t_warm = now_sec() + ca->warmup_sec;
+    while (now_sec() < t_warm) {
+        ssize_t n = g_compress
+                    ? recv_frame(fd, &fb, &frame_msgs, &frame_wire)
+                    : recv_message(fd, &ut, &aa->bp, buf, total_msg_size);
+        if (n <= 0) break;
+    }
+
+    /* Counters cover the measured window only, like the CPU meter */
+    aa->bp.waits = aa->bp.spin_hits = aa->bp.sleeps = 0;
+
+    cpu_meter_t meter;
+    cpu_meter_start(&meter);
+
+    double t_start = now_sec();
+
+    deadline_t dl;
+    deadline_set(&dl, ca->duration_sec, DEADLINE_CHECK_EVERY);
+
+    while (!deadline_passed(&dl)) {
+        uint64_t t0 = ticks_now();
+        trace_event(TR_RECV_BEGIN, 0, 0);
+
+        frame_msgs = 1;
+        ssize_t n = g_compress
+                    ? recv_frame(fd, &fb, &frame_msgs, &frame_wire)
+                    : recv_message(fd, &ut, &aa->bp, buf, total_msg_size);
+        trace_event(TR_RECV_END, (uint32_t)n, n < 0 ? (uint64_t)errno : 0);
+        if (n <= 0) break;
+        if (!g_compress) frame_wire = n;
+
+        lat_ticks   += ticks_end() - t0;
+        total_bytes += n;
+        wire_bytes  += frame_wire;
+        msg_count   += frame_msgs;
+        samples++;
+    }
+    double latency_sum = ticks_to_us(lat_ticks);
+
+    double elapsed = now_sec() - t_start;
+    aa->rx_cost    = cpu_meter_stop(&meter);
+    aa->cost_unit  = meter.unit;
+    aa->wire_bytes = wire_bytes;
+
+    ca->total_bytes    = total_bytes;
+    ca->total_messages = msg_count;
+    ca->throughput_bps = (elapsed > 0) ? (total_bytes * 8.0) / elapsed : 0;
+    ca->avg_latency_us = (samples > 0) ? latency_sum / samples : 0;
+
+    /* The sender stops at the end of its own window */
+    if (tx_running) pthread_join(tx_thread, NULL);
+
+    free(fb.comp);
+    free(fb.raw);
+    if (g_tls == TLS_MODE_USER) utls_free(&ut);
+    busypoll_free(&aa->bp);
+    free(buf);
+    close(fd);
+    return NULL;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Main – spawn client threads, aggregate results                     */
+/* ------------------------------------------------------------------ */
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s [-s strategy] [-T tls] [-Z] [-D direction] [-p port]\n"
+            "          [-P spin_us] [-K busy_poll_us]\n"
+            "          <server_ip> <msg_size> <num_threads> [duration] "
+            "[warmup]\n"
+            "  strategy: label for the RESULT line, and the send strategy\n"
+            "            for -D up|both (default two_copy)\n"
+            "  tls:      none | ktls | user (must match the server)\n"
+            "  -Z        expect compressed frames (server -Z)\n"
+            "  -D        down | up | both (must match the server)\n"
+            "  -P        busy-poll receive: spin up to N us per wait before\n"
+            "            sleeping (-1 never sleeps, 0 always does)\n"
+            "  -K        with -P, also kernel busy polling for N us\n"
+            "            (SO_BUSY_POLL, SO_PREFER_BUSY_POLL, epoll params)\n",
+            prog);
+}
+
+int main(int argc, char *argv[])
+{
+    int port     = DEFAULT_PORT;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "s:T:ZD:p:P:K:h")) != -1) {
+        switch (opt) {
+        case 'p': port       = atoi(optarg); break;
+        case 'Z': g_compress = 1;            break;
+        case 'P': g_spin_us  = atoi(optarg); break;
+        case 'K': g_kpoll_us = atoi(optarg); break;
+        case 's':
+            g_strategy = strategy_from_name(optarg);
+            if (g_strategy < 0) {
+                fprintf(stderr, "Error: unknown strategy '%s'\n", optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        case 'D':
+            g_direction = direction_from_name(optarg);
+            if (g_direction < 0) {
+                fprintf(stderr, "Error: unknown direction '%s'\n", optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        case 'T':
+            g_tls = tls_mode_from_name(optarg);
+            if (g_tls < 0) {
+                fprintf(stderr, "Error: unknown tls mode '%s'\n", optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        default:
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (argc - optind < 3) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    const char *server_ip = argv[optind];
+    int msg_size          = atoi(argv[optind + 1]);
+    int num_threads       = atoi(argv[optind + 2]);
+    int duration          = (argc - optind >= 4) ? atoi(argv[optind + 3])
+                                                 : DEFAULT_DURATION;
+    int warmup            = (argc - optind >= 5) ? atoi(argv[optind + 4]) : 0;
+
+    if (msg_size < NUM_FIELDS || num_threads <= 0 || duration <= 0 ||
+        warmup < 0 || port <= 0) {
+        fprintf(stderr, "Error: all numeric args must be > 0\n");
+        return EXIT_FAILURE;
+    }
+
+    if (g_compress && g_tls == TLS_MODE_USER) {
+        fprintf(stderr, "Error: -Z cannot be combined with -T user\n");
+        return EXIT_FAILURE;
+    }
+    if (g_direction != DIR_DOWN &&
+        (g_compress || g_tls == TLS_MODE_USER || g_strategy == STRAT_SENDFILE)) {
+        fprintf(stderr, "Error: -D %s needs -T none|ktls, no -Z and a "
+                "two_copy/one_copy/zero_copy strategy\n",
+                direction_names[g_direction]);
+        return EXIT_FAILURE;
+    }
+
+    if (g_spin_us != INT_MIN &&
+        (g_direction != DIR_DOWN || g_compress || g_tls == TLS_MODE_USER)) {
+        fprintf(stderr, "Error: -P needs -D down, -T none|ktls and no -Z\n");
+        return EXIT_FAILURE;
+    }
+    if (g_kpoll_us < 0 || (g_kpoll_us > 0 && g_spin_us == INT_MIN)) {
+        fprintf(stderr, "Error: -K takes microseconds >= 0 and needs -P\n");
+        return EXIT_FAILURE;
+    }
+
+    /* Implementation label, e.g. "sendfile+ktls", "two_copy+lz", "one_copy+up" */
+    char label[64];
+    snprintf(label, sizeof(label), "%s%s%s%s%s%s", strategy_names[g_strategy],
+             g_tls != TLS_MODE_NONE ? "+" : "",
+             g_tls != TLS_MODE_NONE ? tls_mode_names[g_tls] : "",
+             g_compress ? "+lz" : "",
+             g_direction != DIR_DOWN ? "+" : "",
+             g_direction != DIR_DOWN ? direction_names[g_direction] : "");
+
+    printf("[Client] %s → %s:%d  msg=%d  threads=%d  dur=%ds\n",
+           label, server_ip, port, msg_size, num_threads, duration);
+
+    timing_init();
+    trace_init();
+    tcpinfo_init("client");
+    placement_init(ROLE_CLIENT);
+
+    pthread_t *tids = (pthread_t *)calloc(num_threads, sizeof(pthread_t));
+    a4_arg_t  *args = (a4_arg_t *)calloc(num_threads, sizeof(a4_arg_t));
+
+    for (int i = 0; i < num_threads; i++) {
+        args[i].ca.server_ip    = server_ip;
+        args[i].ca.server_port  = port;
+        args[i].ca.msg_size     = msg_size;
+        args[i].ca.duration_sec = duration;
+        args[i].ca.warmup_sec   = warmup;
+        args[i].ca.thread_id    = i;
+
+        if (pthread_create(&tids[i], NULL, client_thread, &args[i]) != 0) {
+            perror("pthread_create");
+            return EXIT_FAILURE;
+        }
+    }
+
+    double total_tp   = 0;
+    double total_lat  = 0;
+    long long total_b = 0;
+    long long total_w = 0;
+    long total_m      = 0;
+    unsigned long long total_cost = 0;
+    const char *unit  = "cycles";
+
+    /* Client -> server direction */
+    double    tx_tp = 0, tx_lat = 0;
+    long long tx_b  = 0;
+    long      tx_m  = 0;
+    unsigned long long tx_cost = 0;
+
+    /* Busy-poll receive */
+    long bp_waits = 0, bp_hits = 0, bp_sleeps = 0;
+
+    for (int i = 0; i < num_threads; i++) {
+        pthread_join(tids[i], NULL);
+        total_tp   += args[i].ca.throughput_bps;
+        total_lat  += args[i].ca.avg_latency_us;
+        total_b    += args[i].ca.total_bytes;
+        total_m    += args[i].ca.total_messages;
+        total_w    += args[i].wire_bytes;
+        total_cost += args[i].rx_cost;
+        tx_tp      += args[i].tx_bps;
+        tx_lat     += args[i].tx_latency_us;
+        tx_b       += args[i].tx_bytes;
+        tx_m       += args[i].tx_msgs;
+        tx_cost    += args[i].tx_cost;
+        if (args[i].cost_unit) unit = args[i].cost_unit;
+        bp_waits   += args[i].bp.waits;
+        bp_hits    += args[i].bp.spin_hits;
+        bp_sleeps  += args[i].bp.sleeps;
+    }
+
+    double avg_lat = (num_threads > 0) ? total_lat / num_threads : 0;
+    double tp_gbps = total_tp / 1e9;
+    /* Same measurement window, so wire rate scales with the byte ratio */
+    double wire_gbps = (total_b > 0) ? tp_gbps * total_w / total_b : 0;
+    double ratio     = (total_w > 0) ? (double)total_b / total_w : 0;
+    double cost_pb   = (total_b > 0) ? (double)total_cost / total_b : 0;
+    double up_gbps   = tx_tp / 1e9;
+    double tx_pb     = (tx_b > 0) ? (double)tx_cost / tx_b : 0;
+
+    /* RESULT covers both directions; latency is per received message
+     * (per sent message in upload-only runs) */
+    if (g_direction == DIR_UP)
+        avg_lat = (num_threads > 0) ? tx_lat / num_threads : 0;
+
+    printf("RESULT,%s,%d,%d,%.4f,%.2f,%lld,%ld\n",
+           label, msg_size, num_threads, tp_gbps + up_gbps, avg_lat,
+           total_b + tx_b, total_m + tx_m);
+    if (g_direction != DIR_UP)
+        printf("WIRE,%s,%d,%d,%.4f,%.4f,%.2f,%.4f,%s\n",
+               label, msg_size, num_threads, tp_gbps, wire_gbps, ratio,
+               cost_pb, unit);
+    if (g_direction != DIR_DOWN)
+        printf("DIR,%s,%d,%d,%.4f,%.4f,%.4f,%.4f,%s\n",
+               label, msg_size, num_threads, tp_gbps, up_gbps, cost_pb,
+               tx_pb, unit);
+    if (g_spin_us != INT_MIN)
+        printf("POLL,%s,%d,%d,%d,%d,%.2f,%.1f,%s,%.1f,%.3f\n",
+               label, msg_size, num_threads, g_spin_us, g_kpoll_us, avg_lat,
+               total_m > 0 ? (double)total_cost / total_m : 0.0, unit,
+               bp_waits > 0 ? 100.0 * bp_hits / bp_waits : 0.0,
+               total_m > 0 ? (double)bp_sleeps / total_m : 0.0);
+    if (g_place.policy != PLACE_NONE) {
+        char where[512];
+        printf("PLACEMENT,client,%s\n", placement_describe(where, sizeof(where)));
+    }
+
+    printf("[Client] Throughput: %.4f Gbps  |  Avg latency: %.2f µs  "
+           "|  Total: %lld bytes, %ld msgs\n",
+           tp_gbps + up_gbps, avg_lat, total_b + tx_b, total_m + tx_m);
+
+    free(tids);
+    free(args);
+    return EXIT_SUCCESS;
+}
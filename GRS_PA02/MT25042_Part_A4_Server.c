@@ -0,0 +1,519 @@
+/**
+ * MT25042_Part_A4_Server.c
+ * Graduate Systems (CSE638) - PA02: Analysis of Network I/O primitives
+ *
+ * Reconfigurable TCP server:
+ *   One long-lived process that can run any of the send strategies in
+ *   MT25042_Part_A_Strategy.h (the A1-A3 strategies plus sendfile).
+ *   Message size, strategy and socket options are changed between
+ *   experiment points over the control channel (see
+ *   MT25042_Part_A_Control.h), so a full sweep runs back-to-back on a
+ *   warm process instead of paying a restart + cold cache per point.
+ *
+ *   The server accepts clients until it receives SHUTDOWN on the control
+ *   port.  Any A1-A3 client can be used against it; the TLS modes need
+ *   the A4 client.
+ *
+ *   TLS (-T / SET tls):
+ *     ktls - kernel TLS on the accepted socket; two_copy, one_copy and
+ *            sendfile run unchanged on top of it (sendfile additionally
+ *            requests TLS_TX_ZEROCOPY_RO).  MSG_ZEROCOPY is rejected by
+ *            the TLS ULP, so zero_copy falls back to one_copy.
+ *     user - user-space AES-GCM baseline: every message is encrypted
+ *            from the heap fields into records and sent with send();
+ *            the send strategy is ignored.
+ *
+ *   Compression (-Z / SET compress, -B / SET batch):
+ *     A compressor thread per connection serializes `batch` messages,
+ *     LZ-compresses them into a frame (MT25042_Part_A_Compress.h) and
+ *     queues it; the handler only writes finished frames with send().
+ *     The strategy is therefore not used for compressed connections.
+ *     Works with kTLS, not with user-space TLS.  STATS reports payload
+ *     bytes, wire bytes and the compressor CPU cost.
+ *
+ *   Direction (-D / SET direction, -r / SET rx_mode):
+ *     down - server sends (the A1-A3 behaviour)
+ *     up   - the client sends, the handler only receives
+ *     both - full duplex: a second thread per connection receives while
+ *            the handler sends
+ *     Client data is received with recv(), bulk reads or
+ *     TCP_ZEROCOPY_RECEIVE (MT25042_Part_A_Receive.h).  Send and receive
+ *     threads are metered separately; STATS reports rx bytes and the
+ *     tx/rx CPU cost.  up/both need tls none or ktls and no compression.
+ *
+ * Usage: ./a4_server [-m msg_size] [-s strategy] [-T tls] [-Z] [-B batch]
+ *                    [-p port] [-C control_port]
+ *
+ * AI Declaration: Accept loop reused from A1-A3; no new AI prompts.
+ */
+
+#define _GNU_SOURCE
+#include "MT25042_Part_A_Control.h"
+#include "MT25042_Part_A_TcpInfo.h"
+#include "MT25042_Part_A_Placement.h"
+#include <signal.h>
+
+#define DEFAULT_MSG_SIZE   4096
+#define COUNTER_FLUSH      64          /* messages between counter flushes */
+
+static server_config_t g_cfg;
+
+/* MSG_ZEROCOPY is not accepted on a kTLS socket; use one_copy instead */
+static int ktls_strategy(int tls, int strategy, int tid)
+{
+    if (tls == TLS_MODE_KTLS && strategy == STRAT_ZERO_COPY) {
+        fprintf(stderr, "[Server T%d] zero_copy is not supported over kTLS, "
+                "using one_copy\n", tid);
+        return STRAT_ONE_COPY;
+    }
+    return strategy;
+}
+
+/* Stops a connection's compressor and folds its cost into the counters */
+static void compress_finish(lz_pipe_t *pipe, int tid)
+{
+    lz_pipe_stop(pipe);
+    atomic_fetch_add(&g_cfg.comp_cost, (long long)pipe->cost);
+
+    if (pipe->raw_bytes > 0 && pipe->wire_bytes > 0)
+        printf("[Server T%d] compress: ratio %.2f, %.3f %s/byte\n", tid,
+               (double)pipe->raw_bytes / pipe->wire_bytes,
+               (double)pipe->cost / pipe->raw_bytes, pipe->cost_unit);
+}
+
+/* ------------------------------------------------------------------ */
+/*  Receive loop for client -> server data                             */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+    int fd;
+    int mode;
+    int msg_len;
+    int tid;
+    int place;                         /* placement index, -1: inherit  */
+} rx_arg_t;
+
+/* Receives until EOF; runs on its own thread for DIR_BOTH */
+static void *rx_loop(void *arg)
+{
+    rx_arg_t  *ra = (rx_arg_t *)arg;
+    if (ra->place >= 0) placement_pin(ra->place);
+
+    receiver_t r;
+    if (receiver_init(&r, ra->fd, ra->mode, ra->msg_len) < 0) return NULL;
+
+    cpu_meter_t meter;
+    cpu_meter_start(&meter);
+
+    long long pending = 0, total = 0;
+    while (!atomic_load_explicit(&g_cfg.shutdown, memory_order_relaxed)) {
+        trace_event(TR_RECV_BEGIN, 0, 0);
+        ssize_t n = receiver_recv(&r);
+        trace_event(TR_RECV_END, (uint32_t)n, n < 0 ? (uint64_t)errno : 0);
+        if (n <= 0) break;
+        pending += n;
+        if (pending >= (long long)COUNTER_FLUSH * ra->msg_len) {
+            atomic_fetch_add(&g_cfg.bytes_received, pending);
+            total  += pending;
+            pending = 0;
+        }
+    }
+    atomic_fetch_add(&g_cfg.bytes_received, pending);
+    total += pending;
+
+    unsigned long long cost = cpu_meter_stop(&meter);
+    atomic_fetch_add(&g_cfg.rx_cost, (long long)cost);
+
+    printf("[Server T%d] received %lld bytes (%s, %ld mapped), "
+           "%.3f %s/byte\n", ra->tid, total, rx_mode_names[r.mode],
+           r.zc_bytes, total > 0 ? (double)cost / total : 0.0, meter.unit);
+    receiver_free(&r);
+    return NULL;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Placement slots                                                    */
+/* ------------------------------------------------------------------ */
+
+/* A new client takes the lowest free slot, so every experiment point
+ * starts again at 0 and a disconnect never leaves two live handlers on
+ * one slot.  -1 (unpinned) once all are taken. */
+static pthread_mutex_t g_slot_lock = PTHREAD_MUTEX_INITIALIZER;
+static unsigned char   g_slot_used[PLACE_MAX_PINNED];
+
+static int slot_acquire(void)
+{
+    int slot = -1;
+    pthread_mutex_lock(&g_slot_lock);
+    for (int i = 0; i < PLACE_MAX_PINNED && slot < 0; i++)
+        if (!g_slot_used[i]) { g_slot_used[i] = 1; slot = i; }
+    pthread_mutex_unlock(&g_slot_lock);
+    return slot;
+}
+
+/* A handler is done: free its slot and stop counting it */
+static void client_done(int slot)
+{
+    if (slot >= 0) {
+        pthread_mutex_lock(&g_slot_lock);
+        g_slot_used[slot] = 0;
+        pthread_mutex_unlock(&g_slot_lock);
+    }
+    atomic_fetch_sub(&g_cfg.clients, 1);
+}
+
+/* ------------------------------------------------------------------ */
+/*  Per-client handler thread                                          */
+/* ------------------------------------------------------------------ */
+
+static void *handle_client(void *arg)
+{
+    thread_arg_t *ta  = (thread_arg_t *)arg;
+    int fd            = ta->client_fd;
+    int tid           = ta->thread_id;
+    int slot          = ta->slot;
+    free(ta);
+
+    config_snapshot_t snap;
+    config_snapshot(&g_cfg, &snap);
+    apply_socket_options(fd, &snap);
+
+    /* TLS mode and framing are fixed for the lifetime of the connection */
+    int tls      = snap.tls;
+    int compress = snap.compress;
+    if (compress && tls == TLS_MODE_USER) {
+        fprintf(stderr, "[Server T%d] compression is not supported with "
+                "user-space TLS, sending uncompressed\n", tid);
+        compress = 0;
+    }
+
+    int dir = snap.direction;
+    if (dir != DIR_DOWN && (tls == TLS_MODE_USER || compress)) {
+        fprintf(stderr, "[Server T%d] direction %s needs tls none|ktls and "
+                "no compression\n", tid, direction_names[dir]);
+        close(fd);
+        client_done(slot);
+        return NULL;
+    }
+
+    /* Slot, not tid: every experiment point starts again at client 0 */
+    int cpu = placement_pin(dir == DIR_BOTH ? placement_duplex(slot, 0) : slot);
+
+    printf("[Server T%d] %s handler (tls=%s, compress=%d, dir=%s), fd=%d, "
+           "msg_size=%d, cpu=%d\n", tid, strategy_names[snap.strategy],
+           tls_mode_names[tls], compress, direction_names[dir], fd,
+           snap.msg_size, cpu);
+
+    if (tls == TLS_MODE_KTLS &&
+        ktls_install(fd, 1, snap.strategy == STRAT_SENDFILE) < 0) {
+        close(fd);
+        client_done(slot);
+        return NULL;
+    }
+
+    tcpinfo_add(fd);
+
+    /* Client data arrives in messages of the configured size */
+    rx_arg_t ra = {
+        .fd      = fd,
+        .mode    = snap.rx_mode,
+        .msg_len = (snap.msg_size / NUM_FIELDS) * NUM_FIELDS,
+        .tid     = tid,
+        .place   = dir == DIR_BOTH ? placement_duplex(slot, 1) : -1
+    };
+
+    if (dir == DIR_UP) {
+        rx_loop(&ra);
+        close(fd);
+        client_done(slot);
+        return NULL;
+    }
+
+    sender_t  s;
+    utls_t    ut = { 0 };
+    lz_pipe_t pipe;
+    if (sender_init(&s, fd, ktls_strategy(tls, snap.strategy, tid),
+                    snap.msg_size) < 0) {
+        close(fd);
+        client_done(slot);
+        return NULL;
+    }
+    if (tls == TLS_MODE_USER &&
+        utls_init(&ut, &tls_key_s2c, (size_t)s.msg_len) < 0) {
+        sender_free(&s);
+        close(fd);
+        client_done(slot);
+        return NULL;
+    }
+    if (compress && lz_pipe_start(&pipe, s.iov, NUM_FIELDS, snap.batch) < 0) {
+        if (tls == TLS_MODE_USER) utls_free(&ut);
+        sender_free(&s);
+        close(fd);
+        client_done(slot);
+        return NULL;
+    }
+
+    /* Full duplex: receive on a second thread while this one sends */
+    pthread_t rx_thread;
+    int       rx_running = (dir == DIR_BOTH &&
+                            pthread_create(&rx_thread, NULL, rx_loop, &ra) == 0);
+
+    long long pending_bytes = 0;
+    long long pending_wire  = 0;
+    long      pending_msgs  = 0;
+
+    cpu_meter_t meter;
+    cpu_meter_start(&meter);
+
+    while (!atomic_load_explicit(&g_cfg.shutdown, memory_order_relaxed)) {
+        /* Switch to the new configuration at a message boundary */
+        if (config_changed(&g_cfg, &snap)) {
+            /* The compressor reads the message fields: stop it first */
+            if (compress) compress_finish(&pipe, tid);
+            sender_free(&s);
+            config_snapshot(&g_cfg, &snap);
+            apply_socket_options(fd, &snap);
+            if (sender_init(&s, fd, ktls_strategy(tls, snap.strategy, tid),
+                            snap.msg_size) < 0) {
+                compress = 0;
+                break;
+            }
+            if (compress &&
+                lz_pipe_start(&pipe, s.iov, NUM_FIELDS, snap.batch) < 0) {
+                compress = 0;
+                break;
+            }
+            if (tls == TLS_MODE_USER) {
+                /* Keep the record sequence: the client is still in step */
+                uint64_t seq = ut.seq;
+                utls_free(&ut);
+                if (utls_init(&ut, &tls_key_s2c, (size_t)s.msg_len) < 0)
+                    break;
+                ut.seq = seq;
+            }
+        }
+
+        ssize_t n;
+        long    payload = 0;
+        long    msgs    = 1;
+        if (compress) {
+            lz_frame_t *f = lz_pipe_next(&pipe);
+            n = send_all(fd, f->buf, f->len, 0);
+            lz_pipe_release(&pipe);
+            payload = (long)(pipe.msg_len * pipe.batch);
+            msgs    = pipe.batch;
+        } else if (tls == TLS_MODE_USER) {
+            n = payload = utls_send_iov(&ut, fd, s.iov, NUM_FIELDS);
+        } else {
+            n = payload = sender_send(&s);
+        }
+        if (n <= 0) break;
+
+        pending_bytes += payload;
+        pending_wire  += n;
+        pending_msgs  += msgs;
+        /* Batch the shared-counter updates to keep them off the hot path */
+        if (pending_msgs >= COUNTER_FLUSH) {
+            atomic_fetch_add(&g_cfg.bytes_sent, pending_bytes);
+            atomic_fetch_add(&g_cfg.wire_bytes, pending_wire);
+            atomic_fetch_add(&g_cfg.msgs_sent, pending_msgs);
+            pending_bytes = 0;
+            pending_wire  = 0;
+            pending_msgs  = 0;
+        }
+    }
+
+    atomic_fetch_add(&g_cfg.bytes_sent, pending_bytes);
+    atomic_fetch_add(&g_cfg.wire_bytes, pending_wire);
+    atomic_fetch_add(&g_cfg.msgs_sent, pending_msgs);
+    atomic_fetch_add(&g_cfg.tx_cost, (long long)cpu_meter_stop(&meter));
+
+    if (rx_running) {
+        /* The peer is gone or we are shutting down: stop the receiver */
+        shutdown(fd, SHUT_RDWR);
+        pthread_join(rx_thread, NULL);
+    }
+
+    printf("[Server T%d] Client disconnected (%ld sendmsg calls)\n",
+           tid, s.sends);
+    if (compress) compress_finish(&pipe, tid);
+    if (tls == TLS_MODE_USER) utls_free(&ut);
+    sender_free(&s);
+    close(fd);
+    client_done(slot);
+    return NULL;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Main – start control thread, accept until SHUTDOWN                 */
+/* ------------------------------------------------------------------ */
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s [-m msg_size] [-s strategy] [-T tls] [-Z] [-B batch]\n"
+            "          [-D direction] [-r rx_mode] [-p port] [-C control_port]\n"
+            "  strategy: two_copy | one_copy | zero_copy | sendfile "
+            "(default two_copy)\n"
+            "  tls:      none | ktls | user (default none)\n"
+            "  -Z        compress messages in frames of -B messages "
+            "(default 1)\n"
+            "  direction: down | up | both (default down)\n"
+            "  rx_mode:   recv | bulk | zerocopy_rx (default recv)\n",
+            prog);
+}
+
+int main(int argc, char *argv[])
+{
+    int msg_size     = DEFAULT_MSG_SIZE;
+    int strategy     = STRAT_TWO_COPY;
+    int port         = DEFAULT_PORT;
+    int control_port = CONTROL_PORT;
+    int tls          = TLS_MODE_NONE;
+    int compress     = 0;
+    int batch        = 1;
+    int direction    = DIR_DOWN;
+    int rx_mode      = RX_RECV;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "m:s:T:ZB:D:r:p:C:h")) != -1) {
+        switch (opt) {
+        case 'm': msg_size     = atoi(optarg); break;
+        case 'Z': compress     = 1;            break;
+        case 'B': batch        = atoi(optarg); break;
+        case 'p': port         = atoi(optarg); break;
+        case 'C': control_port = atoi(optarg); break;
+        case 's':
+            strategy = strategy_from_name(optarg);
+            if (strategy < 0) {
+                fprintf(stderr, "Error: unknown strategy '%s'\n", optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        case 'T':
+            tls = tls_mode_from_name(optarg);
+            if (tls < 0) {
+                fprintf(stderr, "Error: unknown tls mode '%s'\n", optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        case 'D':
+            direction = direction_from_name(optarg);
+            if (direction < 0) {
+                fprintf(stderr, "Error: unknown direction '%s'\n", optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        case 'r':
+            rx_mode = rx_mode_from_name(optarg);
+            if (rx_mode < 0) {
+                fprintf(stderr, "Error: unknown rx_mode '%s'\n", optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        default:
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (msg_size < NUM_FIELDS || port <= 0 || control_port <= 0 || batch <= 0) {
+        fprintf(stderr, "Error: msg_size must be >= %d, ports and batch > 0\n",
+                NUM_FIELDS);
+        return EXIT_FAILURE;
+    }
+
+    /* Clients come and go; a write to a closed peer must not kill us */
+    signal(SIGPIPE, SIG_IGN);
+    trace_init();
+    tcpinfo_init("server");
+    placement_init(ROLE_SERVER);
+
+    atomic_store(&g_cfg.msg_size, msg_size);
+    atomic_store(&g_cfg.strategy, strategy);
+    atomic_store(&g_cfg.tls, tls);
+    atomic_store(&g_cfg.compress, compress);
+    atomic_store(&g_cfg.batch, batch);
+    atomic_store(&g_cfg.direction, direction);
+    atomic_store(&g_cfg.rx_mode, rx_mode);
+    g_cfg.control_port = control_port;
+
+    /* The cost unit depends on the host, not the connection: probe it
+     * once here instead of publishing it from every handler */
+    cpu_meter_t probe;
+    cpu_meter_start(&probe);
+    cpu_meter_stop(&probe);
+    g_cfg.cost_unit = probe.unit;
+
+    int server_fd = create_tcp_socket();
+    g_cfg.listen_fd = server_fd;
+
+    struct sockaddr_in addr = {
+        .sin_family      = AF_INET,
+        .sin_port        = htons(port),
+        .sin_addr.s_addr = INADDR_ANY
+    };
+
+    if (bind(server_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        perror("bind");
+        return EXIT_FAILURE;
+    }
+    if (listen(server_fd, BACKLOG) < 0) {
+        perror("listen");
+        return EXIT_FAILURE;
+    }
+
+    pthread_t ctl;
+    if (pthread_create(&ctl, NULL, control_thread, &g_cfg) != 0) {
+        perror("pthread_create control");
+        return EXIT_FAILURE;
+    }
+    pthread_detach(ctl);
+
+    printf("[Server] Reconfigurable server on port %d "
+           "(msg_size=%d, strategy=%s, tls=%s, compress=%d, dir=%s, "
+           "rx_mode=%s, control=%d)\n",
+           port, msg_size, strategy_names[strategy], tls_mode_names[tls],
+           compress, direction_names[direction], rx_mode_names[rx_mode],
+           control_port);
+
+    int tcount = 0;
+
+    while (!atomic_load(&g_cfg.shutdown)) {
+        struct sockaddr_in cli_addr;
+        socklen_t cli_len = sizeof(cli_addr);
+        int cfd = accept(server_fd, (struct sockaddr *)&cli_addr, &cli_len);
+        if (cfd < 0) {
+            if (atomic_load(&g_cfg.shutdown)) break;
+            perror("accept");
+            continue;
+        }
+
+        printf("[Server] Accepted client %d from %s:%d\n",
+               tcount, inet_ntoa(cli_addr.sin_addr), ntohs(cli_addr.sin_port));
+
+        thread_arg_t *ta = (thread_arg_t *)malloc(sizeof(thread_arg_t));
+        ta->client_fd = cfd;
+        ta->msg_size  = 0;               /* taken from g_cfg instead */
+        ta->thread_id = tcount;
+        ta->slot      = slot_acquire();
+        atomic_fetch_add(&g_cfg.clients, 1);
+
+        atomic_fetch_add(&g_cfg.connections, 1);
+
+        pthread_t th;
+        if (pthread_create(&th, NULL, handle_client, ta) != 0) {
+            perror("pthread_create");
+            client_done(ta->slot);
+            free(ta);
+            close(cfd);
+            continue;
+        }
+        pthread_detach(th);
+        tcount++;
+    }
+
+    close(server_fd);
+    printf("[Server] Shutdown complete (%d clients served)\n", tcount);
+    return EXIT_SUCCESS;
+}
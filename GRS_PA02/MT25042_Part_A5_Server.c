@@ -0,0 +1,425 @@
+/**
+ * MT25042_Part_A5_Server.c
+ * Graduate Systems (CSE638) - PA02: Analysis of Network I/O primitives
+ *
+ * Pub/sub fan-out server:
+ *   A single producer publishes a stream of messages into a ring of
+ *   RING_SLOTS buffers allocated (and mlock()ed) once.  Every connected
+ *   subscriber has a sender thread that sends each published buffer to
+ *   its socket, so the payload exists once in memory no matter how many
+ *   subscribers there are (A1-A3 build one message_t per client).
+ *
+ *   With zero_copy the same pages are handed to every socket with
+ *   MSG_ZEROCOPY.  A slot carries a reference per subscriber; a
+ *   subscriber drops its reference only when the error queue confirms
+ *   the completion of the send covering that message, and the producer
+ *   reuses a slot only when the last reference is gone.  With one_copy
+ *   the reference is dropped as soon as sendmsg() returns.
+ *
+ *   The producer stamps a sequence number and publish time into the
+ *   first 16 bytes of every message.  A sampler records how far the
+ *   slowest subscriber lags behind the producer (messages published but
+ *   not yet sent by it, and the age of the oldest such message).
+ *
+ *   Subscribers are ordinary clients (a1_client ... a4_client) run with
+ *   the same msg_size; they see a normal message stream that ends when
+ *   the server closes the connection.
+ *
+ * Output:
+ *   FANOUT,<strategy>,<msg_size>,<subs>,<aggregate_gbps>,<slowest_gbps>,
+ *          <max_lag_msgs>,<avg_lag_msgs>,<max_lag_us>,<payload_kb>
+ *
+ * Usage: ./a5_server [-s zero_copy|one_copy] [-p port]
+ *                    <msg_size> <num_subscribers> [duration_sec]
+ *
+ * AI Declaration: Reused zc_drain()/sendmsg_all() from the strategy
+ *   header; no new AI prompts.
+ */
+
+#define _GNU_SOURCE
+#include "MT25042_Part_A_Strategy.h"
+#include <poll.h>
+#include <signal.h>
+
+#define RING_SLOTS         64          /* messages in flight            */
+#define LAG_SAMPLE_US      1000        /* lag sampler period            */
+#define COMPLETION_WAIT_MS 1           /* poll() for error-queue events */
+
+/* ------------------------------------------------------------------ */
+/*  Broker state                                                       */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+    char   *buf;                       /* msg_len bytes inside the pool */
+    double  published;                 /* now_sec() at publish          */
+    int     refs;                      /* subscribers still using it    */
+} slot_t;
+
+typedef struct {
+    int        fd;
+    int        id;
+    pthread_t  thread;
+    int        active;
+    long       next;                   /* next sequence to send         */
+    long       released;               /* sequences below are released  */
+    long       zc_last[RING_SLOTS];    /* last zerocopy send id per seq */
+    sender_t   s;                      /* send/completion counters only */
+    long long  bytes;
+    double     t_start;
+    double     t_end;
+} subscriber_t;
+
+typedef struct {
+    pthread_mutex_t  lock;
+    pthread_cond_t   published;        /* head advanced / stop          */
+    pthread_cond_t   freed;            /* a slot's last reference gone  */
+    slot_t           slots[RING_SLOTS];
+    char            *pool;
+    size_t           pool_len;
+    long             head;             /* next sequence to publish      */
+    int              msg_len;
+    int              strategy;
+    int              n_active;
+    int              stop;
+} broker_t;
+
+static broker_t g_broker;
+
+/* Drops one reference on `seq`; caller holds the lock */
+static void release_seq(broker_t *b, long seq)
+{
+    slot_t *sl = &b->slots[seq % RING_SLOTS];
+    if (--sl->refs == 0)
+        pthread_cond_signal(&b->freed);
+}
+
+/*
+ * Releases every sent message whose send has completed; lock held.
+ * TCP completes zerocopy sends in order, so `zc_completed` acknowledged
+ * ids means ids 0 .. zc_completed-1 are done.
+ */
+static void release_completed(broker_t *b, subscriber_t *sub)
+{
+    while (sub->released < sub->next &&
+           (b->strategy != STRAT_ZERO_COPY ||
+            sub->zc_last[sub->released % RING_SLOTS] < sub->s.zc_completed))
+        release_seq(b, sub->released++);
+}
+
+/* ------------------------------------------------------------------ */
+/*  Subscriber sender thread                                           */
+/* ------------------------------------------------------------------ */
+
+static void *subscriber_thread(void *arg)
+{
+    subscriber_t *sub = (subscriber_t *)arg;
+    broker_t     *b   = &g_broker;
+    int flags = (b->strategy == STRAT_ZERO_COPY) ? MSG_ZEROCOPY : 0;
+
+    sub->t_start = now_sec();
+    pthread_mutex_lock(&b->lock);
+    while (!b->stop) {
+        if (sub->next < b->head) {
+            long    seq = sub->next;
+            slot_t *sl  = &b->slots[seq % RING_SLOTS];
+            pthread_mutex_unlock(&b->lock);
+
+            struct iovec iov = { .iov_base = sl->buf, .iov_len = b->msg_len };
+            ssize_t n = sendmsg_all(sub->fd, &iov, 1, flags, &sub->s);
+
+            pthread_mutex_lock(&b->lock);
+            if (n <= 0) break;
+            sub->bytes += n;
+            /* Zerocopy ids count successful sendmsg() calls from 0 */
+            sub->zc_last[seq % RING_SLOTS] = sub->s.sends - 1;
+            sub->next++;
+        } else if (sub->released < sub->next) {
+            /* Caught up, but still holding pages: wait for completions */
+            pthread_mutex_unlock(&b->lock);
+            struct pollfd pfd = { .fd = sub->fd, .events = 0 };
+            poll(&pfd, 1, COMPLETION_WAIT_MS);
+            pthread_mutex_lock(&b->lock);
+        } else {
+            pthread_cond_wait(&b->published, &b->lock);
+            continue;
+        }
+
+        if (flags) {
+            pthread_mutex_unlock(&b->lock);
+            zc_drain(sub->fd, &sub->s.zc_completed, &sub->s.zc_copied);
+            pthread_mutex_lock(&b->lock);
+        }
+        release_completed(b, sub);
+    }
+
+    /*
+     * Leaving: give back every reference this subscriber holds.  Pages of
+     * a zerocopy send still in flight on a socket we are about to close
+     * may be overwritten; only that dead connection could observe it.
+     */
+    sub->t_end  = now_sec();
+    sub->active = 0;
+    for (long seq = sub->released; seq < b->head; seq++)
+        release_seq(b, seq);
+    sub->released = b->head;
+    b->n_active--;
+    pthread_cond_signal(&b->freed);
+    pthread_mutex_unlock(&b->lock);
+    return NULL;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Producer thread                                                    */
+/* ------------------------------------------------------------------ */
+
+static void *producer_thread(void *arg)
+{
+    broker_t *b = (broker_t *)arg;
+
+    pthread_mutex_lock(&b->lock);
+    while (!b->stop && b->n_active > 0) {
+        slot_t *sl = &b->slots[b->head % RING_SLOTS];
+        /* Back-pressure: the slowest subscriber still holds this slot */
+        while (!b->stop && sl->refs > 0)
+            pthread_cond_wait(&b->freed, &b->lock);
+        if (b->stop) break;
+        pthread_mutex_unlock(&b->lock);
+
+        /* Nobody references the slot: safe to write the next message */
+        double t   = now_sec();
+        long   seq = b->head;
+        memcpy(sl->buf, &seq, sizeof(seq));
+        memcpy(sl->buf + sizeof(seq), &t, sizeof(t));
+
+        pthread_mutex_lock(&b->lock);
+        sl->refs      = b->n_active;
+        sl->published = t;
+        b->head++;
+        pthread_cond_broadcast(&b->published);
+    }
+    pthread_mutex_unlock(&b->lock);
+    return NULL;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Setup                                                              */
+/* ------------------------------------------------------------------ */
+
+/* One pool for all slots, filled from a serialized message_t */
+static int broker_init(broker_t *b, int msg_size, int strategy)
+{
+    memset(b, 0, sizeof(*b));
+    pthread_mutex_init(&b->lock, NULL);
+    pthread_cond_init(&b->published, NULL);
+    pthread_cond_init(&b->freed, NULL);
+    b->strategy = strategy;
+
+    message_t *msg = create_message(msg_size);
+    if (!msg) return -1;
+    int len = 0;
+    char *flat = serialize_message(msg, &len);
+    free_message(msg);
+    if (!flat) return -1;
+    if (len < (int)(sizeof(long) + sizeof(double))) {
+        fprintf(stderr, "Error: msg_size too small for the sequence stamp\n");
+        free(flat);
+        return -1;
+    }
+    b->msg_len = len;
+
+    b->pool_len = (size_t)len * RING_SLOTS;
+    b->pool = mmap(NULL, b->pool_len, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (b->pool == MAP_FAILED) { perror("mmap pool"); free(flat); return -1; }
+    if (mlock(b->pool, b->pool_len) < 0)
+        perror("mlock pool (continuing unpinned)");
+
+    for (int i = 0; i < RING_SLOTS; i++) {
+        b->slots[i].buf = b->pool + (size_t)i * len;
+        memcpy(b->slots[i].buf, flat, len);
+    }
+    free(flat);
+    return 0;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Main – accept subscribers, publish, sample lag                     */
+/* ------------------------------------------------------------------ */
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s [-s zero_copy|one_copy] [-p port]\n"
+            "          <msg_size> <num_subscribers> [duration_sec]\n",
+            prog);
+}
+
+int main(int argc, char *argv[])
+{
+    int strategy = STRAT_ZERO_COPY;
+    int port     = DEFAULT_PORT;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "s:p:h")) != -1) {
+        switch (opt) {
+        case 'p': port = atoi(optarg); break;
+        case 's':
+            strategy = strategy_from_name(optarg);
+            if (strategy != STRAT_ZERO_COPY && strategy != STRAT_ONE_COPY) {
+                fprintf(stderr, "Error: strategy must be zero_copy or "
+                        "one_copy\n");
+                return EXIT_FAILURE;
+            }
+            break;
+        default:
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (argc - optind < 2) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    int msg_size = atoi(argv[optind]);
+    int num_subs = atoi(argv[optind + 1]);
+    int duration = (argc - optind >= 3) ? atoi(argv[optind + 2])
+                                        : DEFAULT_DURATION;
+
+    if (msg_size < NUM_FIELDS || num_subs <= 0 || duration <= 0 || port <= 0) {
+        fprintf(stderr, "Error: all numeric args must be > 0\n");
+        return EXIT_FAILURE;
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+    trace_init();
+
+    broker_t *b = &g_broker;
+    if (broker_init(b, msg_size, strategy) < 0) return EXIT_FAILURE;
+
+    int server_fd = create_tcp_socket();
+    struct sockaddr_in addr = {
+        .sin_family      = AF_INET,
+        .sin_port        = htons(port),
+        .sin_addr.s_addr = INADDR_ANY
+    };
+    if (bind(server_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        perror("bind");
+        return EXIT_FAILURE;
+    }
+    if (listen(server_fd, BACKLOG) < 0) {
+        perror("listen");
+        return EXIT_FAILURE;
+    }
+
+    printf("[Server] Fan-out (%s) on port %d, msg_size=%d, waiting for "
+           "%d subscribers...\n", strategy_names[strategy], port,
+           b->msg_len, num_subs);
+
+    subscriber_t *subs = (subscriber_t *)calloc(num_subs, sizeof(subscriber_t));
+
+    /* Everyone subscribes before the first message is published */
+    for (int i = 0; i < num_subs; i++) {
+        int cfd = accept(server_fd, NULL, NULL);
+        if (cfd < 0) { perror("accept"); i--; continue; }
+
+        if (strategy == STRAT_ZERO_COPY) {
+            int one = 1;
+            if (setsockopt(cfd, SOL_SOCKET, SO_ZEROCOPY, &one, sizeof(one)) < 0)
+                perror("setsockopt SO_ZEROCOPY");
+        }
+        subs[i].fd     = cfd;
+        subs[i].id     = i;
+        subs[i].active = 1;
+        subs[i].s.fd   = cfd;
+        b->n_active++;
+        printf("[Server] Subscriber %d connected\n", i);
+    }
+
+    for (int i = 0; i < num_subs; i++) {
+        if (pthread_create(&subs[i].thread, NULL, subscriber_thread,
+                           &subs[i]) != 0) {
+            perror("pthread_create");
+            return EXIT_FAILURE;
+        }
+    }
+
+    pthread_t producer;
+    double t_start = now_sec();
+    if (pthread_create(&producer, NULL, producer_thread, b) != 0) {
+        perror("pthread_create producer");
+        return EXIT_FAILURE;
+    }
+
+    /* Sample the slowest subscriber's lag until the run ends */
+    long   max_lag = 0, lag_samples = 0;
+    double lag_sum = 0, max_lag_us = 0;
+    double t_end   = t_start + duration;
+
+    while (now_sec() < t_end) {
+        usleep(LAG_SAMPLE_US);
+
+        pthread_mutex_lock(&b->lock);
+        if (b->n_active == 0) { pthread_mutex_unlock(&b->lock); break; }
+        long slowest = b->head;
+        for (int i = 0; i < num_subs; i++)
+            if (subs[i].active && subs[i].next < slowest)
+                slowest = subs[i].next;
+        long   lag    = b->head - slowest;
+        double lag_us = (lag > 0)
+                        ? (now_sec() - b->slots[slowest % RING_SLOTS].published)
+                          * 1e6
+                        : 0;
+        pthread_mutex_unlock(&b->lock);
+
+        if (lag > max_lag)       max_lag    = lag;
+        if (lag_us > max_lag_us) max_lag_us = lag_us;
+        lag_sum += lag;
+        lag_samples++;
+    }
+
+    /* Stop: wake every waiter and unblock sends stuck on a full socket */
+    pthread_mutex_lock(&b->lock);
+    b->stop = 1;
+    pthread_cond_broadcast(&b->published);
+    pthread_cond_broadcast(&b->freed);
+    pthread_mutex_unlock(&b->lock);
+    for (int i = 0; i < num_subs; i++) shutdown(subs[i].fd, SHUT_RDWR);
+
+    pthread_join(producer, NULL);
+
+    long long total_bytes = 0;
+    double    slowest_bps = -1;
+    long      copied = 0, completed = 0;
+    for (int i = 0; i < num_subs; i++) {
+        pthread_join(subs[i].thread, NULL);
+        double el  = subs[i].t_end - subs[i].t_start;
+        double bps = (el > 0) ? subs[i].bytes * 8.0 / el : 0;
+        if (slowest_bps < 0 || bps < slowest_bps) slowest_bps = bps;
+        total_bytes += subs[i].bytes;
+        completed   += subs[i].s.zc_completed;
+        copied      += subs[i].s.zc_copied;
+        close(subs[i].fd);
+    }
+    double elapsed  = now_sec() - t_start;
+    double agg_gbps = (elapsed > 0) ? total_bytes * 8.0 / elapsed / 1e9 : 0;
+
+    printf("FANOUT,%s,%d,%d,%.4f,%.4f,%ld,%.2f,%.1f,%zu\n",
+           strategy_names[strategy], msg_size, num_subs, agg_gbps,
+           slowest_bps / 1e9, max_lag,
+           lag_samples ? lag_sum / lag_samples : 0.0, max_lag_us,
+           b->pool_len / 1024);
+
+    printf("[Server] Published %ld msgs to %d subscribers: %.4f Gbps "
+           "aggregate, slowest lag %ld msgs / %.1f µs", b->head, num_subs,
+           agg_gbps, max_lag, max_lag_us);
+    if (strategy == STRAT_ZERO_COPY)
+        printf(", %ld/%ld completions copied", copied, completed);
+    printf("\n");
+
+    munmap(b->pool, b->pool_len);
+    free(subs);
+    close(server_fd);
+    return EXIT_SUCCESS;
+}
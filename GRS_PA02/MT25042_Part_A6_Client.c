@@ -0,0 +1,262 @@
+/**
+ * MT25042_Part_A6_Client.c
+ * Graduate Systems (CSE638) - PA02: Analysis of Network I/O primitives
+ *
+ * Connection-churn client for a6_server:
+ *   Each thread repeatedly opens a connection, sends a one-byte request,
+ *   reads the whole reply and closes.  The time from the start of
+ *   connect() to the first reply byte is recorded for every connection.
+ *
+ *   -f sends the request with sendto(MSG_FASTOPEN), so after the first
+ *   connection (which fetches the TFO cookie) the request travels in the
+ *   SYN.  Needs bit 0x1 in net.ipv4.tcp_fastopen (the default).
+ *
+ * Output:
+ *   CHURN,<mode>,<msg_size>,<threads>,<conn_per_sec>,<p50_us>,<p90_us>,
+ *         <p99_us>,<p999_us>,<max_us>,<failures>
+ *
+ * Usage: ./a6_client [-f] [-l label] [-p port]
+ *                    <server_ip> <msg_size> <num_threads> [duration_sec]
+ *                    [warmup_sec]
+ *
+ * AI Declaration: This code structure was generated with AI assistance.
+ */
+
+#define _GNU_SOURCE
+#include "MT25042_Part_A_Common.h"
+
+static int g_fastopen = 0;
+
+typedef struct {
+    client_arg_t  ca;
+    double       *lat_us;              /* connect -> first byte, per conn */
+    long          n_lat;
+    long          cap_lat;
+    long          failures;
+} churn_arg_t;
+
+/* ------------------------------------------------------------------ */
+/*  One connection                                                     */
+/* ------------------------------------------------------------------ */
+
+/*
+ * Connects, requests, reads the reply and closes.  Returns the
+ * connect-to-first-byte time in microseconds, or -1 on failure.
+ */
+static double one_exchange(const struct sockaddr_in *addr, char *buf,
+                           int msg_len)
+{
+    struct timespec ts_begin, ts_first;
+    char req = 'R';
+
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts_begin);
+
+    if (g_fastopen) {
+        /* connect() + send() in one call; the byte rides in the SYN */
+        if (sendto(fd, &req, 1, MSG_FASTOPEN | MSG_NOSIGNAL,
+                   (const struct sockaddr *)addr, sizeof(*addr)) != 1) {
+            close(fd);
+            return -1;
+        }
+    } else {
+        if (connect(fd, (const struct sockaddr *)addr, sizeof(*addr)) < 0 ||
+            send(fd, &req, 1, MSG_NOSIGNAL) != 1) {
+            close(fd);
+            return -1;
+        }
+    }
+
+    ssize_t n = recv(fd, buf, msg_len, 0);
+    if (n <= 0) { close(fd); return -1; }
+    clock_gettime(CLOCK_MONOTONIC, &ts_first);
+
+    /* Rest of the reply */
+    if (n < msg_len && recv_all(fd, buf + n, msg_len - (int)n, 0) <= 0) {
+        close(fd);
+        return -1;
+    }
+
+    close(fd);
+    return elapsed_us(&ts_begin, &ts_first);
+}
+
+/* ------------------------------------------------------------------ */
+/*  Per-thread loop                                                    */
+/* ------------------------------------------------------------------ */
+
+static void *client_thread(void *arg)
+{
+    churn_arg_t  *ta = (churn_arg_t *)arg;
+    client_arg_t *ca = &ta->ca;
+
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port   = htons(ca->server_port)
+    };
+    inet_pton(AF_INET, ca->server_ip, &addr.sin_addr);
+
+    int   msg_len = (ca->msg_size / NUM_FIELDS) * NUM_FIELDS;
+    char *buf     = (char *)malloc(msg_len);
+    if (!buf) { perror("malloc"); return NULL; }
+
+    /* Warm-up: also fetches the TFO cookie */
+    double t_warm = now_sec() + ca->warmup_sec;
+    while (now_sec() < t_warm)
+        one_exchange(&addr, buf, msg_len);
+
+    double t_start = now_sec();
+    double t_end   = t_start + ca->duration_sec;
+
+    while (now_sec() < t_end) {
+        double us = one_exchange(&addr, buf, msg_len);
+        if (us < 0) {
+            ta->failures++;
+            if (errno == EADDRNOTAVAIL) usleep(1000);  /* ports exhausted */
+            continue;
+        }
+        if (ta->n_lat == ta->cap_lat) {
+            /* On failure keep what was recorded and stop */
+            long    cap = ta->cap_lat ? ta->cap_lat * 2 : 4096;
+            double *lat = (double *)realloc(ta->lat_us, cap * sizeof(double));
+            if (!lat) { perror("realloc"); break; }
+            ta->lat_us  = lat;
+            ta->cap_lat = cap;
+        }
+        ta->lat_us[ta->n_lat++] = us;
+    }
+
+    double elapsed = now_sec() - t_start;
+    ca->total_messages = ta->n_lat;
+    ca->total_bytes    = (long long)ta->n_lat * msg_len;
+    ca->throughput_bps = (elapsed > 0) ? ta->n_lat / elapsed : 0;
+
+    free(buf);
+    return NULL;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Main – spawn client threads, merge latencies                       */
+/* ------------------------------------------------------------------ */
+
+static int cmp_double(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/* Nearest-rank percentile of a sorted array */
+static double percentile(const double *v, long n, double p)
+{
+    if (n == 0) return 0;
+    long idx = (long)(p / 100.0 * n + 0.5) - 1;
+    if (idx < 0)  idx = 0;
+    if (idx >= n) idx = n - 1;
+    return v[idx];
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s [-f] [-l label] [-p port]\n"
+            "          <server_ip> <msg_size> <num_threads> [duration] "
+            "[warmup]\n"
+            "  -f  TCP Fast Open (request sent in the SYN)\n"
+            "  -l  label for the CHURN line (default: plain or tfo)\n",
+            prog);
+}
+
+int main(int argc, char *argv[])
+{
+    int         port  = DEFAULT_PORT;
+    const char *label = NULL;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "fl:p:h")) != -1) {
+        switch (opt) {
+        case 'f': g_fastopen = 1;            break;
+        case 'l': label      = optarg;       break;
+        case 'p': port       = atoi(optarg); break;
+        default:
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (argc - optind < 3) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    const char *server_ip = argv[optind];
+    int msg_size          = atoi(argv[optind + 1]);
+    int num_threads       = atoi(argv[optind + 2]);
+    int duration          = (argc - optind >= 4) ? atoi(argv[optind + 3])
+                                                 : DEFAULT_DURATION;
+    int warmup            = (argc - optind >= 5) ? atoi(argv[optind + 4]) : 0;
+
+    if (msg_size < NUM_FIELDS || num_threads <= 0 || duration <= 0 ||
+        warmup < 0 || port <= 0) {
+        fprintf(stderr, "Error: all numeric args must be > 0\n");
+        return EXIT_FAILURE;
+    }
+    if (!label) label = g_fastopen ? "tfo" : "plain";
+
+    printf("[Client] churn (%s) → %s:%d  msg=%d  threads=%d  dur=%ds\n",
+           label, server_ip, port, msg_size, num_threads, duration);
+
+    pthread_t   *tids = (pthread_t *)calloc(num_threads, sizeof(pthread_t));
+    churn_arg_t *args = (churn_arg_t *)calloc(num_threads, sizeof(churn_arg_t));
+
+    for (int i = 0; i < num_threads; i++) {
+        args[i].ca.server_ip    = server_ip;
+        args[i].ca.server_port  = port;
+        args[i].ca.msg_size     = msg_size;
+        args[i].ca.duration_sec = duration;
+        args[i].ca.warmup_sec   = warmup;
+        args[i].ca.thread_id    = i;
+
+        if (pthread_create(&tids[i], NULL, client_thread, &args[i]) != 0) {
+            perror("pthread_create");
+            return EXIT_FAILURE;
+        }
+    }
+
+    long   total    = 0;
+    long   failures = 0;
+    double conn_ps  = 0;
+    for (int i = 0; i < num_threads; i++) {
+        pthread_join(tids[i], NULL);
+        total    += args[i].n_lat;
+        failures += args[i].failures;
+        conn_ps  += args[i].ca.throughput_bps;   /* connections/s here */
+    }
+
+    double *all = (double *)malloc((total ? total : 1) * sizeof(double));
+    long    k   = 0;
+    for (int i = 0; i < num_threads; i++) {
+        if (args[i].n_lat > 0)
+            memcpy(all + k, args[i].lat_us, args[i].n_lat * sizeof(double));
+        k += args[i].n_lat;
+        free(args[i].lat_us);
+    }
+    qsort(all, total, sizeof(double), cmp_double);
+
+    printf("CHURN,%s,%d,%d,%.1f,%.2f,%.2f,%.2f,%.2f,%.2f,%ld\n",
+           label, msg_size, num_threads, conn_ps,
+           percentile(all, total, 50), percentile(all, total, 90),
+           percentile(all, total, 99), percentile(all, total, 99.9),
+           total ? all[total - 1] : 0.0, failures);
+
+    printf("[Client] %.1f conn/s  |  first byte p50 %.2f µs, p99 %.2f µs  "
+           "|  %ld connections, %ld failed\n",
+           conn_ps, percentile(all, total, 50), percentile(all, total, 99),
+           total, failures);
+
+    free(all);
+    free(tids);
+    free(args);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,310 @@
+/**
+ * MT25042_Part_A6_Server.c
+ * Graduate Systems (CSE638) - PA02: Analysis of Network I/O primitives
+ *
+ * Connection-churn server:
+ *   Every connection carries exactly one exchange: the client sends a
+ *   one-byte request, the server answers with one serialized message and
+ *   closes.  Paired with a6_client this measures how fast new
+ *   connections are set up and served, instead of steady-state streaming.
+ *
+ *   Accept paths (switchable):
+ *     default  blocking accept() + one pthread per connection, i.e. the
+ *              A1-A3 accept loop under churn
+ *     -n       accept4(SOCK_NONBLOCK) drained from an epoll loop; a single
+ *              thread serves every connection without blocking
+ *   Listener options:
+ *     -d sec   TCP_DEFER_ACCEPT: accept() only returns once the request
+ *              byte has arrived
+ *     -f qlen  TCP_FASTOPEN: the request may ride in the SYN (needs bit
+ *              0x2 in net.ipv4.tcp_fastopen)
+ *
+ *   Runs until SIGINT/SIGTERM, then prints the number of connections
+ *   served and the accept rate.
+ *
+ * Usage: ./a6_server [-n] [-d defer_sec] [-f fastopen_qlen] [-p port]
+ *                    <msg_size>
+ *
+ * AI Declaration: This code structure was generated with AI assistance.
+ */
+
+#define _GNU_SOURCE
+#include "MT25042_Part_A_Common.h"
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <stdatomic.h>
+
+#define MAX_EVENTS         256
+
+static volatile sig_atomic_t g_stop = 0;
+
+static char        *g_msg;             /* serialized reply, shared     */
+static int          g_msg_len;
+static atomic_long  g_served;
+static atomic_long  g_failed;
+
+static void on_signal(int sig)
+{
+    (void)sig;
+    g_stop = 1;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Thread-per-connection path                                         */
+/* ------------------------------------------------------------------ */
+
+static void *handle_client(void *arg)
+{
+    int  fd = (int)(long)arg;
+    char req;
+
+    /* One request byte in, one message out, close */
+    if (recv_all(fd, &req, 1, 0) == 1 &&
+        send_all(fd, g_msg, g_msg_len, MSG_NOSIGNAL) == g_msg_len)
+        atomic_fetch_add(&g_served, 1);
+    else
+        atomic_fetch_add(&g_failed, 1);
+
+    close(fd);
+    return NULL;
+}
+
+static void serve_threaded(int lfd)
+{
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+    while (!g_stop) {
+        int cfd = accept(lfd, NULL, NULL);
+        if (cfd < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EMFILE || errno == ENFILE) { usleep(1000); continue; }
+            perror("accept");
+            continue;
+        }
+
+        pthread_t th;
+        if (pthread_create(&th, &attr, handle_client, (void *)(long)cfd) != 0) {
+            perror("pthread_create");
+            atomic_fetch_add(&g_failed, 1);
+            close(cfd);
+        }
+    }
+    pthread_attr_destroy(&attr);
+}
+
+/* ------------------------------------------------------------------ */
+/*  Non-blocking accept4 + epoll path                                  */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+    int fd;
+    int got_request;
+    int sent;                          /* reply bytes written so far   */
+} conn_t;
+
+/*
+ * Advances one connection as far as it can go without blocking.
+ * Returns 1 when the connection is finished (and closed), 0 if it must
+ * wait for `*want` (EPOLLIN or EPOLLOUT).
+ */
+static int conn_progress(conn_t *c, uint32_t *want)
+{
+    if (!c->got_request) {
+        char req;
+        ssize_t n = recv(c->fd, &req, 1, 0);
+        if (n < 0 && (errno == EAGAIN || errno == EINTR)) {
+            *want = EPOLLIN;
+            return 0;
+        }
+        if (n != 1) goto fail;
+        c->got_request = 1;
+    }
+
+    while (c->sent < g_msg_len) {
+        ssize_t n = send(c->fd, g_msg + c->sent, g_msg_len - c->sent,
+                         MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN) { *want = EPOLLOUT; return 0; }
+            goto fail;
+        }
+        c->sent += (int)n;
+    }
+
+    atomic_fetch_add(&g_served, 1);
+    close(c->fd);
+    return 1;
+
+fail:
+    atomic_fetch_add(&g_failed, 1);
+    close(c->fd);
+    return 1;
+}
+
+static void serve_epoll(int lfd)
+{
+    int ep = epoll_create1(EPOLL_CLOEXEC);
+    if (ep < 0) { perror("epoll_create1"); return; }
+
+    fcntl(lfd, F_SETFL, fcntl(lfd, F_GETFL) | O_NONBLOCK);
+    struct epoll_event ev = { .events = EPOLLIN, .data.ptr = NULL };
+    epoll_ctl(ep, EPOLL_CTL_ADD, lfd, &ev);
+
+    struct epoll_event events[MAX_EVENTS];
+
+    while (!g_stop) {
+        int n = epoll_wait(ep, events, MAX_EVENTS, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            perror("epoll_wait");
+            break;
+        }
+
+        for (int i = 0; i < n; i++) {
+            conn_t  *c    = (conn_t *)events[i].data.ptr;
+            uint32_t want = 0;
+
+            if (c == NULL) {
+                /* Listener: drain the accept queue */
+                while (1) {
+                    int cfd = accept4(lfd, NULL, NULL,
+                                      SOCK_NONBLOCK | SOCK_CLOEXEC);
+                    if (cfd < 0) {
+                        if (errno != EAGAIN && errno != EINTR &&
+                            errno != ECONNABORTED)
+                            perror("accept4");
+                        break;
+                    }
+                    conn_t *nc = (conn_t *)calloc(1, sizeof(conn_t));
+                    if (!nc) {
+                        perror("calloc conn");
+                        close(cfd);
+                        continue;
+                    }
+                    nc->fd = cfd;
+                    /* With DEFER_ACCEPT / TFO the request is usually here */
+                    if (conn_progress(nc, &want)) { free(nc); continue; }
+                    struct epoll_event cev = { .events = want, .data.ptr = nc };
+                    epoll_ctl(ep, EPOLL_CTL_ADD, cfd, &cev);
+                }
+                continue;
+            }
+
+            if (conn_progress(c, &want)) {
+                free(c);               /* close() removed it from epoll */
+                continue;
+            }
+            struct epoll_event cev = { .events = want, .data.ptr = c };
+            epoll_ctl(ep, EPOLL_CTL_MOD, c->fd, &cev);
+        }
+    }
+    close(ep);
+}
+
+/* ------------------------------------------------------------------ */
+/*  Main                                                               */
+/* ------------------------------------------------------------------ */
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s [-n] [-d defer_sec] [-f fastopen_qlen] [-p port] "
+            "<msg_size>\n"
+            "  -n  accept4(SOCK_NONBLOCK) + epoll instead of thread per "
+            "connection\n"
+            "  -d  TCP_DEFER_ACCEPT timeout in seconds\n"
+            "  -f  TCP_FASTOPEN queue length\n",
+            prog);
+}
+
+int main(int argc, char *argv[])
+{
+    int nonblock = 0;
+    int defer    = 0;
+    int fastopen = 0;
+    int port     = DEFAULT_PORT;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "nd:f:p:h")) != -1) {
+        switch (opt) {
+        case 'n': nonblock = 1;            break;
+        case 'd': defer    = atoi(optarg); break;
+        case 'f': fastopen = atoi(optarg); break;
+        case 'p': port     = atoi(optarg); break;
+        default:
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (argc - optind < 1) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    int msg_size = atoi(argv[optind]);
+    if (msg_size < NUM_FIELDS || port <= 0 || defer < 0 || fastopen < 0) {
+        fprintf(stderr, "Error: msg_size must be >= %d, options >= 0\n",
+                NUM_FIELDS);
+        return EXIT_FAILURE;
+    }
+
+    message_t *msg = create_message(msg_size);
+    g_msg = serialize_message(msg, &g_msg_len);
+    free_message(msg);
+    if (!g_msg) return EXIT_FAILURE;
+
+    /* No SA_RESTART: SIGINT must interrupt accept()/epoll_wait() */
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_signal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    int lfd = create_tcp_socket();
+    struct sockaddr_in addr = {
+        .sin_family      = AF_INET,
+        .sin_port        = htons(port),
+        .sin_addr.s_addr = INADDR_ANY
+    };
+    if (bind(lfd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        perror("bind");
+        return EXIT_FAILURE;
+    }
+
+    if (defer > 0 &&
+        setsockopt(lfd, IPPROTO_TCP, TCP_DEFER_ACCEPT,
+                   &defer, sizeof(defer)) < 0)
+        perror("setsockopt TCP_DEFER_ACCEPT");
+    if (fastopen > 0 &&
+        setsockopt(lfd, IPPROTO_TCP, TCP_FASTOPEN,
+                   &fastopen, sizeof(fastopen)) < 0)
+        perror("setsockopt TCP_FASTOPEN");
+
+    /* Churn needs a deep accept queue; the kernel caps it at somaxconn */
+    if (listen(lfd, 4096) < 0) {
+        perror("listen");
+        return EXIT_FAILURE;
+    }
+
+    printf("[Server] Churn server on port %d (msg_size=%d, %s, defer=%d, "
+           "fastopen=%d)\n", port, g_msg_len,
+           nonblock ? "accept4+epoll" : "accept+thread", defer, fastopen);
+
+    double t_start = now_sec();
+    if (nonblock) serve_epoll(lfd);
+    else          serve_threaded(lfd);
+    double elapsed = now_sec() - t_start;
+
+    long served = atomic_load(&g_served);
+    printf("[Server] Served %ld connections (%ld failed) in %.1f s: "
+           "%.0f conn/s\n", served, atomic_load(&g_failed), elapsed,
+           elapsed > 0 ? served / elapsed : 0.0);
+
+    close(lfd);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,339 @@
+/**
+ * MT25042_Part_A7_Client.c
+ * Graduate Systems (CSE638) - PA02: Analysis of Network I/O primitives
+ *
+ * Striped-stream client for a7_server:
+ *   Opens K connections for ONE logical stream and runs one receiver
+ *   thread per connection, each pinned to its own CPU.  Every message
+ *   carries a session-wide sequence number; receivers read the payload
+ *   straight into slot (seq % W) of a W-message reorder window and the
+ *   stream is delivered in sequence order from there.  A receiver whose
+ *   message is W or more ahead of the next one to deliver waits, which
+ *   bounds the reorder memory (TCP flow control then slows that stripe).
+ *
+ *   Goodput counts in-order delivered bytes only.  The reorder buffer is
+ *   reported as the peak and average number of messages (and KB) held
+ *   because an earlier sequence number had not arrived yet.
+ *
+ * Output:
+ *   STRIPE,<label>,<msg_size>,<streams>,<goodput_gbps>,<peak_reorder_kb>,
+ *          <avg_reorder_msgs>,<window_kb>,<out_of_order_pct>
+ *
+ * Usage: ./a7_client [-c first_cpu] [-W window_msgs] [-l label] [-p port]
+ *                    <server_ip> <msg_size> <streams> [duration_sec]
+ *                    [warmup_sec]
+ *
+ * AI Declaration: This code structure was generated with AI assistance.
+ */
+
+#define _GNU_SOURCE
+#include "MT25042_Part_A_Stripe.h"
+
+#define DEFAULT_WINDOW     64          /* reorder slots (messages)     */
+
+/* ------------------------------------------------------------------ */
+/*  Reorder window                                                     */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+    pthread_mutex_t  lock;
+    pthread_cond_t   space;            /* `next` advanced              */
+    uint64_t         next;             /* next sequence to deliver     */
+    uint32_t         window;
+    size_t           slot_len;
+    char            *slots;            /* window * slot_len bytes      */
+    uint32_t        *ready;            /* payload length, 0 = empty    */
+    int              stop;
+
+    /* Statistics (under lock) */
+    long long        delivered_bytes;
+    long long        delivered_msgs;
+    long long        arrivals;
+    long long        out_of_order;     /* arrived ahead of `next`      */
+    long             held;             /* messages waiting in window   */
+    long             peak_held;
+    long double      held_sum;         /* sum of `held` per arrival    */
+} reorder_t;
+
+static int reorder_init(reorder_t *r, uint32_t window, size_t slot_len)
+{
+    memset(r, 0, sizeof(*r));
+    pthread_mutex_init(&r->lock, NULL);
+    pthread_cond_init(&r->space, NULL);
+    r->window   = window;
+    r->slot_len = slot_len;
+    r->slots    = (char *)malloc((size_t)window * slot_len);
+    r->ready    = (uint32_t *)calloc(window, sizeof(uint32_t));
+    if (!r->slots || !r->ready) { perror("malloc reorder window"); return -1; }
+    return 0;
+}
+
+static void reorder_free(reorder_t *r)
+{
+    free(r->slots);
+    free(r->ready);
+    pthread_mutex_destroy(&r->lock);
+    pthread_cond_destroy(&r->space);
+}
+
+/* Waits until `seq` fits in the window; returns its slot or NULL on stop */
+static char *reorder_reserve(reorder_t *r, uint64_t seq)
+{
+    pthread_mutex_lock(&r->lock);
+    while (!r->stop && seq >= r->next + r->window)
+        pthread_cond_wait(&r->space, &r->lock);
+    int stop = r->stop;
+    pthread_mutex_unlock(&r->lock);
+    return stop ? NULL : r->slots + (seq % r->window) * r->slot_len;
+}
+
+/*
+ * Marks `seq` as received and delivers every message that is now in
+ * order.  Delivery here is the consumer of the stream: it only counts
+ * bytes, the payload is already in place.
+ */
+static void reorder_complete(reorder_t *r, uint64_t seq, uint32_t len)
+{
+    pthread_mutex_lock(&r->lock);
+    r->ready[seq % r->window] = len;
+    r->arrivals++;
+    r->held++;
+    if (seq != r->next) r->out_of_order++;
+
+    int advanced = 0;
+    uint32_t l;
+    while ((l = r->ready[r->next % r->window]) != 0) {
+        r->ready[r->next % r->window] = 0;
+        r->delivered_bytes += l;
+        r->delivered_msgs++;
+        r->held--;
+        r->next++;
+        advanced = 1;
+    }
+
+    if (r->held > r->peak_held) r->peak_held = r->held;
+    r->held_sum += r->held;
+    if (advanced) pthread_cond_broadcast(&r->space);
+    pthread_mutex_unlock(&r->lock);
+}
+
+/* ------------------------------------------------------------------ */
+/*  Per-stripe receiver                                                */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+    reorder_t *r;
+    int        fd;
+    int        stripe;
+    int        cpu;
+    long       msgs;
+} stripe_rx_t;
+
+static void *stripe_receiver(void *arg)
+{
+    stripe_rx_t *sr = (stripe_rx_t *)arg;
+    reorder_t   *r  = sr->r;
+
+    pin_thread_to_cpu(sr->cpu);
+
+    while (1) {
+        stripe_hdr_t hdr;
+        if (recv_all(sr->fd, &hdr, sizeof(hdr), 0) != (ssize_t)sizeof(hdr))
+            break;
+        stripe_hdr_unpack(&hdr);
+        if (hdr.len == 0 || hdr.len > r->slot_len) {
+            fprintf(stderr, "[Client] stripe %d: bad length %u\n",
+                    sr->stripe, hdr.len);
+            break;
+        }
+
+        char *slot = reorder_reserve(r, hdr.seq);
+        if (!slot) break;
+        if (recv_all(sr->fd, slot, hdr.len, 0) != (ssize_t)hdr.len) break;
+
+        reorder_complete(r, hdr.seq, hdr.len);
+        sr->msgs++;
+    }
+    return NULL;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Main                                                               */
+/* ------------------------------------------------------------------ */
+
+static int connect_stripe(const char *ip, int port, uint32_t session,
+                          int stripe, int streams, int msg_size)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) { perror("socket"); return -1; }
+
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port   = htons(port)
+    };
+    inet_pton(AF_INET, ip, &addr.sin_addr);
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        perror("connect");
+        close(fd);
+        return -1;
+    }
+
+    stripe_hello_t h;
+    stripe_hello_pack(&h, session, (uint32_t)stripe, (uint32_t)streams,
+                      (uint32_t)msg_size);
+    if (send_all(fd, &h, sizeof(h), MSG_NOSIGNAL) != (ssize_t)sizeof(h)) {
+        perror("send hello");
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/* Snapshot of the delivered counters */
+static void reorder_snapshot(reorder_t *r, long long *bytes, long long *arr,
+                             long long *ooo, long double *held_sum)
+{
+    pthread_mutex_lock(&r->lock);
+    *bytes    = r->delivered_bytes;
+    *arr      = r->arrivals;
+    *ooo      = r->out_of_order;
+    *held_sum = r->held_sum;
+    pthread_mutex_unlock(&r->lock);
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s [-c first_cpu] [-W window_msgs] [-l label] [-p port]\n"
+            "          <server_ip> <msg_size> <streams> [duration] [warmup]\n"
+            "  -c  receiver i is pinned to cpu first_cpu+i (default 0)\n"
+            "  -W  reorder window in messages (default %d)\n"
+            "  -l  label for the STRIPE line (default striped)\n",
+            prog, DEFAULT_WINDOW);
+}
+
+int main(int argc, char *argv[])
+{
+    int         port      = DEFAULT_PORT;
+    int         first_cpu = 0;
+    int         window    = DEFAULT_WINDOW;
+    const char *label     = "striped";
+
+    int opt;
+    while ((opt = getopt(argc, argv, "c:W:l:p:h")) != -1) {
+        switch (opt) {
+        case 'c': first_cpu = atoi(optarg); break;
+        case 'W': window    = atoi(optarg); break;
+        case 'l': label     = optarg;       break;
+        case 'p': port      = atoi(optarg); break;
+        default:
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (argc - optind < 3) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    const char *server_ip = argv[optind];
+    int msg_size          = atoi(argv[optind + 1]);
+    int streams           = atoi(argv[optind + 2]);
+    int duration          = (argc - optind >= 4) ? atoi(argv[optind + 3])
+                                                 : DEFAULT_DURATION;
+    int warmup            = (argc - optind >= 5) ? atoi(argv[optind + 4]) : 0;
+
+    if (msg_size < NUM_FIELDS || msg_size > MAX_MSG_SIZE || streams <= 0 ||
+        streams > STRIPE_MAX || duration <= 0 || warmup < 0 || window <= 0 ||
+        first_cpu < 0) {
+        fprintf(stderr, "Error: invalid arguments (msg_size %d..%d, "
+                "streams 1..%d)\n", NUM_FIELDS, MAX_MSG_SIZE, STRIPE_MAX);
+        return EXIT_FAILURE;
+    }
+
+    /* Payload length as serialize_message() produces it */
+    message_t *probe     = create_message(msg_size);
+    int        probe_len = 0;
+    char      *probe_buf = serialize_message(probe, &probe_len);
+    free_message(probe);
+    if (!probe_buf) return EXIT_FAILURE;
+    free(probe_buf);
+
+    reorder_t r;
+    if (reorder_init(&r, (uint32_t)window, (size_t)probe_len) < 0)
+        return EXIT_FAILURE;
+
+    printf("[Client] striped → %s:%d  msg=%d  streams=%d  window=%d  "
+           "dur=%ds\n", server_ip, port, probe_len, streams, window,
+           duration);
+
+    srand((unsigned)(time(NULL) ^ getpid()));
+    uint32_t    session = (uint32_t)rand();
+    long        ncpu    = sysconf(_SC_NPROCESSORS_ONLN);
+    pthread_t   tids[STRIPE_MAX];
+    stripe_rx_t args[STRIPE_MAX];
+    memset(args, 0, sizeof(args));
+
+    for (int i = 0; i < streams; i++) {
+        args[i].fd = connect_stripe(server_ip, port, session, i, streams,
+                                    msg_size);
+        if (args[i].fd < 0) return EXIT_FAILURE;
+    }
+    for (int i = 0; i < streams; i++) {
+        args[i].r      = &r;
+        args[i].stripe = i;
+        args[i].cpu    = (int)((first_cpu + i) % (ncpu > 0 ? ncpu : 1));
+        if (pthread_create(&tids[i], NULL, stripe_receiver, &args[i]) != 0) {
+            perror("pthread_create");
+            return EXIT_FAILURE;
+        }
+    }
+
+    /* Measure between the end of the warm-up and the end of the run */
+    long long   b0, b1, a0, a1, o0, o1;
+    long double h0, h1;
+    if (warmup > 0) sleep(warmup);
+    pthread_mutex_lock(&r.lock);
+    r.peak_held = r.held;
+    pthread_mutex_unlock(&r.lock);
+    reorder_snapshot(&r, &b0, &a0, &o0, &h0);
+    double t_start = now_sec();
+
+    sleep(duration);
+
+    reorder_snapshot(&r, &b1, &a1, &o1, &h1);
+    double elapsed = now_sec() - t_start;
+
+    pthread_mutex_lock(&r.lock);
+    r.stop = 1;
+    long peak = r.peak_held;
+    pthread_cond_broadcast(&r.space);
+    pthread_mutex_unlock(&r.lock);
+    for (int i = 0; i < streams; i++) shutdown(args[i].fd, SHUT_RDWR);
+    for (int i = 0; i < streams; i++) {
+        pthread_join(tids[i], NULL);
+        close(args[i].fd);
+    }
+
+    long long arrivals = a1 - a0;
+    double goodput  = (elapsed > 0) ? (b1 - b0) * 8.0 / elapsed / 1e9 : 0;
+    double avg_held = arrivals ? (double)((h1 - h0) / arrivals) : 0;
+    double ooo_pct  = arrivals ? 100.0 * (o1 - o0) / arrivals : 0;
+    double peak_kb  = peak * (double)probe_len / 1024.0;
+    double win_kb   = window * (double)probe_len / 1024.0;
+
+    printf("STRIPE,%s,%d,%d,%.4f,%.1f,%.2f,%.1f,%.2f\n",
+           label, msg_size, streams, goodput, peak_kb, avg_held, win_kb,
+           ooo_pct);
+
+    printf("[Client] Goodput: %.4f Gbps  |  reorder peak %ld msgs "
+           "(%.1f KB of %.1f KB), avg %.2f msgs  |  %.2f%% out of order\n",
+           goodput, peak, peak_kb, win_kb, avg_held, ooo_pct);
+    for (int i = 0; i < streams; i++)
+        printf("[Client]   stripe %d (cpu %d): %ld messages\n",
+               i, args[i].cpu, args[i].msgs);
+
+    reorder_free(&r);
+    return EXIT_SUCCESS;
+}
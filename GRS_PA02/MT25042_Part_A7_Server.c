@@ -0,0 +1,286 @@
+/**
+ * MT25042_Part_A7_Server.c
+ * Graduate Systems (CSE638) - PA02: Analysis of Network I/O primitives
+ *
+ * Striped-stream server:
+ *   One logical stream of messages is carried over K TCP connections
+ *   (stripes) instead of one, so a single transfer is no longer limited
+ *   by one core's send path.  The client opens the K connections and
+ *   announces itself on each with a stripe_hello_t; once all K have
+ *   arrived the server starts one sender thread per stripe, pinned to
+ *   its own CPU.  Hellos are read with a short receive timeout, and a
+ *   session that has not gathered all its stripes within
+ *   PENDING_TIMEOUT seconds is dropped.
+ *
+ *   Senders take the next sequence number from a shared atomic counter
+ *   and send [stripe_hdr_t][payload] with sendmsg() (A2 style, no
+ *   user-space copy).  A stripe that gets ahead simply takes more
+ *   sequence numbers, so the split follows each connection's pace; the
+ *   client puts the messages back in order by sequence number.
+ *
+ * Usage: ./a7_server [-c first_cpu] [-p port]
+ *
+ * AI Declaration: This code structure was generated with AI assistance.
+ */
+
+#define _GNU_SOURCE
+#include "MT25042_Part_A_Stripe.h"
+#include <signal.h>
+#include <stdatomic.h>
+#include <sys/time.h>
+#include <sys/uio.h>
+
+#define MAX_SESSIONS       16          /* sessions still gathering     */
+#define PENDING_TIMEOUT    10.0        /* s a session may gather for   */
+#define HELLO_TIMEOUT      2           /* s to wait for a stripe hello */
+
+typedef struct session {
+    uint32_t          id;
+    uint32_t          streams;
+    uint32_t          msg_size;
+    uint32_t          joined;
+    double            created;         /* now_sec() of the first stripe */
+    int               fds[STRIPE_MAX];
+    char             *payload;         /* serialized message, shared   */
+    int               payload_len;
+    _Atomic uint64_t  next_seq;
+    atomic_int        done;
+} session_t;
+
+typedef struct {
+    session_t *s;
+    int        stripe;
+    int        cpu;
+} stripe_arg_t;
+
+static int g_first_cpu = 0;
+
+/* ------------------------------------------------------------------ */
+/*  Per-stripe sender                                                  */
+/* ------------------------------------------------------------------ */
+
+static void *stripe_sender(void *arg)
+{
+    stripe_arg_t *sa = (stripe_arg_t *)arg;
+    session_t    *s  = sa->s;
+    int           fd = s->fds[sa->stripe];
+
+    pin_thread_to_cpu(sa->cpu);
+
+    stripe_hdr_t hdr;
+    long         sent_msgs = 0;
+
+    while (!atomic_load_explicit(&s->done, memory_order_relaxed)) {
+        uint64_t seq = atomic_fetch_add_explicit(&s->next_seq, 1,
+                                                 memory_order_relaxed);
+        stripe_hdr_pack(&hdr, seq, (uint32_t)s->payload_len, sa->stripe);
+
+        struct iovec iov[2] = {
+            { .iov_base = &hdr,       .iov_len = sizeof(hdr) },
+            { .iov_base = s->payload, .iov_len = (size_t)s->payload_len }
+        };
+        if (sendv_all(fd, iov, 2) < 0) break;
+        sent_msgs++;
+    }
+
+    /* One stripe failing (client gone) ends the whole session */
+    atomic_store(&s->done, 1);
+    shutdown(fd, SHUT_RDWR);
+    printf("[Server] session %u stripe %d (cpu %d): %ld messages\n",
+           s->id, sa->stripe, sa->cpu, sent_msgs);
+    return NULL;
+}
+
+static void *session_thread(void *arg)
+{
+    session_t    *s = (session_t *)arg;
+    pthread_t     th[STRIPE_MAX];
+    stripe_arg_t  sa[STRIPE_MAX];
+    long          ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+
+    printf("[Server] session %u: %u stripes, msg_size=%d\n",
+           s->id, s->streams, s->payload_len);
+
+    for (uint32_t i = 0; i < s->streams; i++) {
+        sa[i].s      = s;
+        sa[i].stripe = (int)i;
+        sa[i].cpu    = (int)((g_first_cpu + i) % (ncpu > 0 ? ncpu : 1));
+        if (pthread_create(&th[i], NULL, stripe_sender, &sa[i]) != 0) {
+            perror("pthread_create");
+            atomic_store(&s->done, 1);
+            s->streams = i;
+            break;
+        }
+    }
+    for (uint32_t i = 0; i < s->streams; i++) pthread_join(th[i], NULL);
+
+    for (uint32_t i = 0; i < s->joined; i++) close(s->fds[i]);
+    free(s->payload);
+    free(s);
+    return NULL;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Main – accept stripes and group them into sessions                 */
+/* ------------------------------------------------------------------ */
+
+static session_t *find_session(session_t **pending, uint32_t id)
+{
+    for (int i = 0; i < MAX_SESSIONS; i++)
+        if (pending[i] && pending[i]->id == id) return pending[i];
+    return NULL;
+}
+
+static session_t *new_session(session_t **pending, const stripe_hello_t *h)
+{
+    int slot = -1;
+    for (int i = 0; i < MAX_SESSIONS && slot < 0; i++)
+        if (!pending[i]) slot = i;
+    if (slot < 0) return NULL;
+
+    session_t *s = (session_t *)calloc(1, sizeof(session_t));
+    if (!s) return NULL;
+    s->id       = h->session;
+    s->streams  = h->streams;
+    s->msg_size = h->msg_size;
+    s->created  = now_sec();
+
+    message_t *msg = create_message((int)h->msg_size);
+    if (msg) {
+        s->payload = serialize_message(msg, &s->payload_len);
+        free_message(msg);
+    }
+    if (!s->payload) { free(s); return NULL; }
+
+    pending[slot] = s;
+    return s;
+}
+
+static void drop_session(session_t **pending, session_t *s)
+{
+    for (int i = 0; i < MAX_SESSIONS; i++)
+        if (pending[i] == s) pending[i] = NULL;
+}
+
+/* Frees sessions whose client never opened all its stripes, so they do
+ * not hold a pending slot (and their connections) forever */
+static void expire_sessions(session_t **pending)
+{
+    double now = now_sec();
+    for (int i = 0; i < MAX_SESSIONS; i++) {
+        session_t *s = pending[i];
+        if (!s || now - s->created < PENDING_TIMEOUT) continue;
+
+        fprintf(stderr, "[Server] session %u: %u/%u stripes after %.0f s, "
+                "dropped\n", s->id, s->joined, s->streams, PENDING_TIMEOUT);
+        for (uint32_t k = 0; k < s->streams; k++)
+            if (s->fds[k] > 0) close(s->fds[k]);
+        free(s->payload);
+        free(s);
+        pending[i] = NULL;
+    }
+}
+
+/* Reads a stripe hello without letting a silent peer stall the accept
+ * loop; the timeout is cleared again for the sender */
+static int recv_hello(int cfd, stripe_hello_t *h)
+{
+    struct timeval tv = { .tv_sec = HELLO_TIMEOUT, .tv_usec = 0 };
+    setsockopt(cfd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    int ok = recv_all(cfd, h, sizeof(*h), 0) == (ssize_t)sizeof(*h) &&
+             stripe_hello_unpack(h) == 0;
+    tv.tv_sec = 0;
+    setsockopt(cfd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    return ok ? 0 : -1;
+}
+
+int main(int argc, char *argv[])
+{
+    int port = DEFAULT_PORT;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "c:p:h")) != -1) {
+        switch (opt) {
+        case 'c': g_first_cpu = atoi(optarg); break;
+        case 'p': port        = atoi(optarg); break;
+        default:
+            fprintf(stderr, "Usage: %s [-c first_cpu] [-p port]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (port <= 0 || g_first_cpu < 0) {
+        fprintf(stderr, "Error: port must be > 0, first_cpu >= 0\n");
+        return EXIT_FAILURE;
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+
+    int server_fd = create_tcp_socket();
+    struct sockaddr_in addr = {
+        .sin_family      = AF_INET,
+        .sin_port        = htons(port),
+        .sin_addr.s_addr = INADDR_ANY
+    };
+    if (bind(server_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        perror("bind");
+        return EXIT_FAILURE;
+    }
+    if (listen(server_fd, BACKLOG) < 0) {
+        perror("listen");
+        return EXIT_FAILURE;
+    }
+
+    printf("[Server] Striped-stream server on port %d (first cpu %d)\n",
+           port, g_first_cpu);
+
+    session_t *pending[MAX_SESSIONS] = { 0 };
+
+    while (1) {
+        int cfd = accept(server_fd, NULL, NULL);
+        if (cfd < 0) {
+            if (errno == EINTR) continue;
+            perror("accept");
+            continue;
+        }
+
+        expire_sessions(pending);
+
+        stripe_hello_t h;
+        if (recv_hello(cfd, &h) < 0) {
+            fprintf(stderr, "[Server] bad stripe hello\n");
+            close(cfd);
+            continue;
+        }
+
+        session_t *s = find_session(pending, h.session);
+        if (!s && !(s = new_session(pending, &h))) {
+            fprintf(stderr, "[Server] cannot start session %u\n", h.session);
+            close(cfd);
+            continue;
+        }
+        if (h.streams != s->streams || h.stripe >= s->streams ||
+            s->fds[h.stripe] > 0) {
+            fprintf(stderr, "[Server] session %u: inconsistent stripe %u\n",
+                    h.session, h.stripe);
+            close(cfd);
+            continue;
+        }
+        s->fds[h.stripe] = cfd;
+        if (++s->joined < s->streams) continue;
+
+        /* All stripes are here: hand the session to its own thread */
+        drop_session(pending, s);
+        pthread_t th;
+        if (pthread_create(&th, NULL, session_thread, s) != 0) {
+            perror("pthread_create");
+            for (uint32_t i = 0; i < s->joined; i++) close(s->fds[i]);
+            free(s->payload);
+            free(s);
+            continue;
+        }
+        pthread_detach(th);
+    }
+
+    close(server_fd);
+    return EXIT_SUCCESS;
+}
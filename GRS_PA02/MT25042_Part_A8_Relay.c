@@ -0,0 +1,449 @@
+/**
+ * MT25042_Part_A8_Relay.c
+ * Graduate Systems (CSE638) - PA02: Analysis of Network I/O primitives
+ *
+ * L4 relay between the clients and any A1-A6 server:
+ *   Every accepted connection is paired with a new connection to the
+ *   upstream server and bytes are forwarded both ways until either side
+ *   closes.  Two forwarding paths:
+ *     splice  socket → pipe → socket with splice(); pages move between
+ *             the socket buffers by reference, never through user space
+ *     copy    recv() into a user buffer, send() it out (two copies)
+ *
+ *   Each of the -t worker threads has its own SO_REUSEPORT listener and
+ *   epoll loop and owns the pairs it accepted.  Interest is level
+ *   triggered and follows the state of each direction: EPOLLIN on a
+ *   source while its pipe/buffer is empty, EPOLLOUT on a destination
+ *   while data is waiting for it.  The upstream connect() is blocking;
+ *   only the data path is measured.
+ *
+ *   On SIGINT/SIGTERM the relay prints the bytes forwarded, the rate
+ *   between the first and the last forwarded byte, and the CPU time
+ *   spent (getrusage) per forwarded gigabit.  The latency the hop adds
+ *   is the difference between a client's numbers with and without the
+ *   relay in the path (README).
+ *
+ * Output:
+ *   RELAY,<mode>,<workers>,<pairs>,<gbytes>,<gbps>,<cpu_sec>,
+ *         <cpu_sec_per_gbit>
+ *
+ * Usage: ./a8_relay [-m splice|copy] [-t workers] [-l listen_port]
+ *                   <upstream_ip> <upstream_port>
+ *
+ * AI Declaration: This code structure was generated with AI assistance;
+ *   the splice() loop follows the splice(2) man page.
+ */
+
+#define _GNU_SOURCE
+#include "MT25042_Part_A_Common.h"
+#include <fcntl.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+
+#define RELAY_PORT         9880
+#define MAX_EVENTS         256
+#define MAX_WORKERS        64
+#define PIPE_SIZE          (1024 * 1024)   /* F_SETPIPE_SZ per direction */
+#define COPY_BUF           (256 * 1024)
+
+typedef enum { MODE_SPLICE = 0, MODE_COPY } relay_mode_t;
+static const char *const mode_names[] = { "splice", "copy" };
+
+/* One direction of a pair: bytes read from `from`, written to `to` */
+typedef struct {
+    int     from, to;
+    int     pipe[2];                   /* splice mode                  */
+    char   *buf;                       /* copy mode                    */
+    size_t  off;                       /* copy mode: first unsent byte */
+    size_t  pending;                   /* read but not yet written     */
+    int     eof;                       /* `from` reached EOF           */
+    int     done;                      /* EOF seen and all written     */
+} half_t;
+
+typedef struct pair pair_t;
+
+/* epoll data points at one endpoint of a pair */
+typedef struct {
+    pair_t  *pair;
+    int      fd;
+    uint32_t events;                   /* current interest set         */
+} endpoint_t;
+
+struct pair {
+    endpoint_t ep[2];                  /* 0 = client, 1 = upstream     */
+    half_t     h[2];                   /* 0: client→up, 1: up→client   */
+    int        closed;                 /* fds closed, free after batch */
+    pair_t    *next_dead;
+};
+
+typedef struct {
+    int         id;
+    int         lfd;
+    int         ep;
+    long        pairs;
+    long long   bytes;
+    double      first_byte;            /* now_sec() of first / last    */
+    double      last_byte;
+} worker_t;
+
+static relay_mode_t          g_mode = MODE_SPLICE;
+static struct sockaddr_in    g_upstream;
+static volatile sig_atomic_t g_stop = 0;
+
+static void on_signal(int sig)
+{
+    (void)sig;
+    g_stop = 1;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Forwarding                                                         */
+/* ------------------------------------------------------------------ */
+
+/*
+ * Moves as much as possible from h->from to h->to without blocking.
+ * Returns bytes written to h->to, or -1 if the pair must be closed.
+ */
+static long long pump(half_t *h)
+{
+    long long moved = 0;
+
+    while (!h->done) {
+        if (h->pending == 0 && !h->eof) {
+            ssize_t n;
+            if (g_mode == MODE_SPLICE)
+                n = splice(h->from, NULL, h->pipe[1], NULL, PIPE_SIZE,
+                           SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+            else
+                n = recv(h->from, h->buf, COPY_BUF, MSG_DONTWAIT);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                if (errno == EAGAIN) break;
+                return -1;
+            }
+            if (n == 0) h->eof = 1;
+            h->pending = (size_t)n;
+            h->off     = 0;
+        }
+
+        if (h->pending > 0) {
+            ssize_t n;
+            if (g_mode == MODE_SPLICE)
+                n = splice(h->pipe[0], NULL, h->to, NULL, h->pending,
+                           SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+            else
+                n = send(h->to, h->buf + h->off, h->pending,
+                         MSG_DONTWAIT | MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                if (errno == EAGAIN) break;
+                return -1;
+            }
+            h->pending -= (size_t)n;
+            h->off     += (size_t)n;
+            moved      += n;
+            if (h->pending > 0) break;     /* destination is full */
+        }
+
+        if (h->eof && h->pending == 0) {
+            shutdown(h->to, SHUT_WR);      /* pass the half-close on */
+            h->done = 1;
+        }
+    }
+    return moved;
+}
+
+/* Interest of endpoint i: read if its outgoing half is empty, write if
+ * its incoming half has data waiting */
+static void update_interest(worker_t *w, pair_t *p, int i)
+{
+    half_t  *out = &p->h[i], *in = &p->h[1 - i];
+    uint32_t ev  = 0;
+    if (!out->eof && out->pending == 0) ev |= EPOLLIN;
+    if (in->pending > 0)                ev |= EPOLLOUT;
+
+    if (ev != p->ep[i].events) {
+        struct epoll_event e = { .events = ev, .data.ptr = &p->ep[i] };
+        epoll_ctl(w->ep, EPOLL_CTL_MOD, p->ep[i].fd, &e);
+        p->ep[i].events = ev;
+    }
+}
+
+/*
+ * Closes the pair's fds now but only queues the memory: the other
+ * endpoint may still have an event further down the current batch.
+ */
+static void pair_close(pair_t *p, pair_t **dead)
+{
+    for (int i = 0; i < 2; i++) {
+        close(p->ep[i].fd);            /* also leaves the epoll set */
+        if (g_mode == MODE_SPLICE) {
+            close(p->h[i].pipe[0]);
+            close(p->h[i].pipe[1]);
+        }
+        free(p->h[i].buf);
+    }
+    p->closed    = 1;
+    p->next_dead = *dead;
+    *dead        = p;
+}
+
+static pair_t *pair_open(worker_t *w, int cfd)
+{
+    int ufd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (ufd < 0 ||
+        connect(ufd, (struct sockaddr *)&g_upstream, sizeof(g_upstream)) < 0) {
+        perror("connect upstream");
+        if (ufd >= 0) close(ufd);
+        return NULL;
+    }
+
+    pair_t *p = (pair_t *)calloc(1, sizeof(pair_t));
+    if (!p) { close(ufd); return NULL; }
+    int fds[2] = { cfd, ufd };
+    int one = 1;
+
+    for (int i = 0; i < 2; i++) {
+        fcntl(fds[i], F_SETFL, fcntl(fds[i], F_GETFL) | O_NONBLOCK);
+        setsockopt(fds[i], IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        p->ep[i].pair = p;
+        p->ep[i].fd   = fds[i];
+        p->h[i].from  = fds[i];
+        p->h[i].to    = fds[1 - i];
+        p->h[i].pipe[0] = p->h[i].pipe[1] = -1;
+
+        if (g_mode == MODE_SPLICE) {
+            if (pipe2(p->h[i].pipe, O_NONBLOCK | O_CLOEXEC) < 0) {
+                perror("pipe2");
+                goto fail;
+            }
+            fcntl(p->h[i].pipe[1], F_SETPIPE_SZ, PIPE_SIZE);
+        } else if (!(p->h[i].buf = (char *)malloc(COPY_BUF))) {
+            goto fail;
+        }
+    }
+
+    for (int i = 0; i < 2; i++) {
+        p->ep[i].events = EPOLLIN;
+        struct epoll_event e = { .events = EPOLLIN, .data.ptr = &p->ep[i] };
+        epoll_ctl(w->ep, EPOLL_CTL_ADD, fds[i], &e);
+    }
+    w->pairs++;
+    return p;
+
+fail:
+    for (int i = 0; i < 2; i++) {
+        if (p->h[i].pipe[0] >= 0) { close(p->h[i].pipe[0]); close(p->h[i].pipe[1]); }
+        free(p->h[i].buf);
+    }
+    free(p);
+    close(ufd);
+    return NULL;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Worker: one listener + one epoll loop                              */
+/* ------------------------------------------------------------------ */
+
+static void *worker_loop(void *arg)
+{
+    worker_t *w = (worker_t *)arg;
+    struct epoll_event events[MAX_EVENTS];
+
+    while (!g_stop) {
+        int n = epoll_wait(w->ep, events, MAX_EVENTS, 200);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            perror("epoll_wait");
+            break;
+        }
+
+        pair_t *dead = NULL;
+        for (int i = 0; i < n; i++) {
+            endpoint_t *e = (endpoint_t *)events[i].data.ptr;
+
+            if (e == NULL) {
+                int cfd;
+                while ((cfd = accept4(w->lfd, NULL, NULL, SOCK_CLOEXEC)) >= 0)
+                    if (!pair_open(w, cfd)) close(cfd);
+                continue;
+            }
+
+            pair_t *p = e->pair;
+            if (p->closed) continue;
+
+            long long moved = 0;
+            int       failed = 0;
+            for (int d = 0; d < 2 && !failed; d++) {
+                long long m = pump(&p->h[d]);
+                if (m < 0) failed = 1;
+                else       moved += m;
+            }
+            if (events[i].events & (EPOLLERR | EPOLLHUP) &&
+                !(events[i].events & EPOLLIN))
+                failed = 1;
+
+            if (moved > 0) {
+                double t = now_sec();
+                if (w->bytes == 0) w->first_byte = t;
+                w->last_byte = t;
+                w->bytes    += moved;
+            }
+
+            if (failed || (p->h[0].done && p->h[1].done)) {
+                pair_close(p, &dead);
+                continue;
+            }
+            update_interest(w, p, 0);
+            update_interest(w, p, 1);
+        }
+
+        while (dead) {
+            pair_t *next = dead->next_dead;
+            free(dead);
+            dead = next;
+        }
+    }
+    return NULL;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Main                                                               */
+/* ------------------------------------------------------------------ */
+
+static int open_listener(int port)
+{
+    int fd  = create_tcp_socket();
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one));
+
+    struct sockaddr_in addr = {
+        .sin_family      = AF_INET,
+        .sin_port        = htons(port),
+        .sin_addr.s_addr = INADDR_ANY
+    };
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+        listen(fd, BACKLOG) < 0) {
+        perror("bind/listen");
+        close(fd);
+        return -1;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    return fd;
+}
+
+static double cpu_seconds(void)
+{
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_utime.tv_sec + ru.ru_stime.tv_sec +
+           (ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) / 1e6;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s [-m splice|copy] [-t workers] [-l listen_port] "
+            "<upstream_ip> <upstream_port>\n"
+            "  -m  forwarding path (default splice)\n"
+            "  -t  worker threads, each with its own listener (default 1)\n"
+            "  -l  port to accept clients on (default %d)\n",
+            prog, RELAY_PORT);
+}
+
+int main(int argc, char *argv[])
+{
+    int listen_port = RELAY_PORT;
+    int nworkers    = 1;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "m:t:l:h")) != -1) {
+        switch (opt) {
+        case 'm':
+            if      (strcmp(optarg, "splice") == 0) g_mode = MODE_SPLICE;
+            else if (strcmp(optarg, "copy") == 0)   g_mode = MODE_COPY;
+            else { usage(argv[0]); return EXIT_FAILURE; }
+            break;
+        case 't': nworkers    = atoi(optarg); break;
+        case 'l': listen_port = atoi(optarg); break;
+        default:
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (argc - optind < 2 || nworkers <= 0 || nworkers > MAX_WORKERS ||
+        listen_port <= 0) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    g_upstream.sin_family = AF_INET;
+    g_upstream.sin_port   = htons(atoi(argv[optind + 1]));
+    if (inet_pton(AF_INET, argv[optind], &g_upstream.sin_addr) != 1) {
+        fprintf(stderr, "Error: bad upstream address '%s'\n", argv[optind]);
+        return EXIT_FAILURE;
+    }
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_signal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    static worker_t workers[MAX_WORKERS];
+    pthread_t       tids[MAX_WORKERS];
+
+    for (int i = 0; i < nworkers; i++) {
+        worker_t *w = &workers[i];
+        w->id  = i;
+        w->lfd = open_listener(listen_port);
+        w->ep  = epoll_create1(EPOLL_CLOEXEC);
+        if (w->lfd < 0 || w->ep < 0) return EXIT_FAILURE;
+
+        struct epoll_event e = { .events = EPOLLIN, .data.ptr = NULL };
+        epoll_ctl(w->ep, EPOLL_CTL_ADD, w->lfd, &e);
+    }
+
+    printf("[Relay] %s relay :%d → %s:%s, %d worker(s)\n",
+           mode_names[g_mode], listen_port, argv[optind], argv[optind + 1],
+           nworkers);
+
+    double cpu0 = cpu_seconds();
+    for (int i = 0; i < nworkers; i++) {
+        if (pthread_create(&tids[i], NULL, worker_loop, &workers[i]) != 0) {
+            perror("pthread_create");
+            return EXIT_FAILURE;
+        }
+    }
+    for (int i = 0; i < nworkers; i++) pthread_join(tids[i], NULL);
+    double cpu = cpu_seconds() - cpu0;
+
+    long long bytes = 0;
+    long      pairs = 0;
+    double    first = 0, last = 0;
+    for (int i = 0; i < nworkers; i++) {
+        worker_t *w = &workers[i];
+        bytes += w->bytes;
+        pairs += w->pairs;
+        if (w->bytes && (first == 0 || w->first_byte < first))
+            first = w->first_byte;
+        if (w->last_byte > last) last = w->last_byte;
+        close(w->lfd);
+        close(w->ep);
+    }
+
+    double active = last - first;
+    double gbits  = bytes * 8.0 / 1e9;
+    double gbps   = active > 0 ? gbits / active : 0;
+
+    printf("RELAY,%s,%d,%ld,%.3f,%.4f,%.3f,%.4f\n",
+           mode_names[g_mode], nworkers, pairs, bytes / 1e9, gbps, cpu,
+           gbits > 0 ? cpu / gbits : 0.0);
+    printf("[Relay] %ld pairs, %.3f GB forwarded at %.4f Gbps  |  "
+           "%.3f CPU s, %.4f CPU s per Gbit (= cores per Gbps)\n",
+           pairs, bytes / 1e9, gbps, cpu, gbits > 0 ? cpu / gbits : 0.0);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,311 @@
+/**
+ * MT25042_Part_A9_Prefork.c
+ * Graduate Systems (CSE638) - PA02: Analysis of Network I/O primitives
+ *
+ * Pre-forked multi-process server:
+ *   The process counterpart of the thread-per-connection servers (the
+ *   PA01 fork vs. thread comparison, applied to the send path).  N worker
+ *   processes are forked up front; each accepts one connection at a time
+ *   and streams messages to it with any strategy from
+ *   MT25042_Part_A_Strategy.h until the client disconnects.  Every worker
+ *   has its own heap, allocator arenas and page tables, so what the
+ *   threads share inside one address space is not shared here.
+ *
+ *   Listener (-R):
+ *     default  the parent's listen socket is inherited; idle workers
+ *              block in accept() on it and the kernel wakes one per
+ *              connection
+ *     -R       every worker binds its own SO_REUSEPORT socket and the
+ *              kernel hashes connections across them.  A connection
+ *              hashed to a busy worker waits until that worker's
+ *              current client leaves, so use it with P > clients.
+ *
+ *   Counters live in a MAP_SHARED slot per worker (cache-line sized, one
+ *   writer each) and are flushed every COUNTER_FLUSH messages.  On
+ *   SIGINT/SIGTERM the parent stops the workers and prints a line per
+ *   worker (connections, bytes, CPU cost per byte, minor faults,
+ *   involuntary context switches) and the aggregate:
+ *     PREFORK,<strategy>,<msg_size>,<procs>,<inherit|reuseport>,<conns>,
+ *             <gbps>,<cost_per_byte>,<cycles|cpu_ns>
+ *   Any A1-A3 client (or a4_client -p) can drive it.
+ *
+ * Usage: ./a9_server [-s strategy] [-P procs] [-R] [-p port] <msg_size>
+ *
+ * AI Declaration: This code structure was generated with AI assistance;
+ *   send loop reused from the A4 server.
+ */
+
+#define _GNU_SOURCE
+#include "MT25042_Part_A_Strategy.h"
+#include "MT25042_Part_A_TcpInfo.h"
+#include "MT25042_Part_A_Placement.h"
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#define MAX_PROCS          256
+#define DEFAULT_PROCS      4
+#define COUNTER_FLUSH      64          /* messages between counter flushes */
+
+/* One per worker, written only by that worker */
+typedef struct {
+    _Atomic long long bytes;
+    _Atomic long long msgs;
+    _Atomic long long cost;            /* cycles or CPU ns while sending  */
+    _Atomic long      conns;
+    _Atomic uint64_t  first_ns;        /* mono_ns() of first / last byte  */
+    _Atomic uint64_t  last_ns;
+    long              minflt;          /* getrusage() at worker exit      */
+    long              nivcsw;
+    int               pid;
+    int               cpu;             /* PA02_PLACEMENT pin, -1 = none   */
+    int               cycles;          /* cost unit: 1 cycles, 0 cpu_ns   */
+} __attribute__((aligned(64))) worker_slot_t;
+
+static volatile sig_atomic_t g_stop = 0;
+
+static void on_signal(int sig)
+{
+    (void)sig;
+    g_stop = 1;
+}
+
+/* do_listen = 0 only binds: reserves the port without joining the group */
+static int open_listener(int port, int reuseport, int do_listen)
+{
+    int fd = create_tcp_socket();
+    int one = 1;
+    if (reuseport &&
+        setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one)) < 0) {
+        perror("setsockopt SO_REUSEPORT");
+        close(fd);
+        return -1;
+    }
+
+    struct sockaddr_in addr = {
+        .sin_family      = AF_INET,
+        .sin_port        = htons(port),
+        .sin_addr.s_addr = INADDR_ANY
+    };
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+        (do_listen && listen(fd, BACKLOG) < 0)) {
+        perror("bind/listen");
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Worker process                                                     */
+/* ------------------------------------------------------------------ */
+
+static void serve_connection(int cfd, int strategy, int msg_size,
+                             worker_slot_t *slot)
+{
+    sender_t s;
+    if (sender_init(&s, cfd, strategy, msg_size) < 0) return;
+    tcpinfo_add(cfd);
+
+    cpu_meter_t meter;
+    cpu_meter_start(&meter);
+    slot->cycles = strcmp(meter.unit, "cycles") == 0;
+
+    long long bytes = 0, msgs = 0;
+    while (!g_stop) {
+        ssize_t n = sender_send(&s);
+        if (n <= 0) break;
+        bytes += n;
+        if (++msgs % COUNTER_FLUSH == 0) {
+            uint64_t t = mono_ns();
+            if (atomic_load_explicit(&slot->first_ns, memory_order_relaxed) == 0)
+                atomic_store_explicit(&slot->first_ns, t, memory_order_relaxed);
+            atomic_store_explicit(&slot->last_ns, t, memory_order_relaxed);
+            atomic_fetch_add_explicit(&slot->bytes, bytes, memory_order_relaxed);
+            atomic_fetch_add_explicit(&slot->msgs, msgs, memory_order_relaxed);
+            bytes = msgs = 0;
+        }
+    }
+
+    if (bytes > 0) {
+        if (atomic_load(&slot->first_ns) == 0)
+            atomic_store(&slot->first_ns, mono_ns());
+        atomic_store(&slot->last_ns, mono_ns());
+    }
+    atomic_fetch_add(&slot->bytes, bytes);
+    atomic_fetch_add(&slot->msgs, msgs);
+    atomic_fetch_add(&slot->cost, (long long)cpu_meter_stop(&meter));
+    sender_free(&s);
+}
+
+static void worker_main(int idx, int lfd, int port, int reuseport,
+                        int strategy, int msg_size, worker_slot_t *slot)
+{
+    /* Threads do not survive fork(): start per-process helpers here */
+    trace_init();
+    tcpinfo_init("server");
+    placement_init(ROLE_SERVER);
+    slot->cpu = placement_pin(idx);
+
+    if (reuseport) lfd = open_listener(port, 1, 1);
+    if (lfd < 0) _exit(EXIT_FAILURE);
+    slot->pid = (int)getpid();
+
+    while (!g_stop) {
+        int cfd = accept(lfd, NULL, NULL);
+        if (cfd < 0) {
+            if (errno == EINTR) continue;
+            perror("accept");
+            break;
+        }
+        atomic_fetch_add(&slot->conns, 1);
+        serve_connection(cfd, strategy, msg_size, slot);
+        close(cfd);
+    }
+
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    slot->minflt = ru.ru_minflt;
+    slot->nivcsw = ru.ru_nivcsw;
+    exit(EXIT_SUCCESS);                /* runs the trace atexit hook */
+}
+
+/* ------------------------------------------------------------------ */
+/*  Main                                                               */
+/* ------------------------------------------------------------------ */
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s [-s strategy] [-P procs] [-R] [-p port] <msg_size>\n"
+            "  -s  two_copy | one_copy | zero_copy | sendfile "
+            "(default two_copy)\n"
+            "  -P  worker processes (default %d)\n"
+            "  -R  one SO_REUSEPORT listener per worker instead of an "
+            "inherited one\n",
+            prog, DEFAULT_PROCS);
+}
+
+int main(int argc, char *argv[])
+{
+    int strategy  = STRAT_TWO_COPY;
+    int procs     = DEFAULT_PROCS;
+    int reuseport = 0;
+    int port      = DEFAULT_PORT;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "s:P:Rp:h")) != -1) {
+        switch (opt) {
+        case 'P': procs     = atoi(optarg); break;
+        case 'R': reuseport = 1;            break;
+        case 'p': port      = atoi(optarg); break;
+        case 's':
+            strategy = strategy_from_name(optarg);
+            if (strategy < 0) {
+                fprintf(stderr, "Error: unknown strategy '%s'\n", optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        default:
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (argc - optind < 1) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    int msg_size = atoi(argv[optind]);
+    if (msg_size < NUM_FIELDS || procs <= 0 || procs > MAX_PROCS ||
+        port <= 0) {
+        fprintf(stderr, "Error: msg_size must be >= %d, procs 1..%d\n",
+                NUM_FIELDS, MAX_PROCS);
+        return EXIT_FAILURE;
+    }
+
+    worker_slot_t *slots = (worker_slot_t *)mmap(NULL,
+                                                 procs * sizeof(worker_slot_t),
+                                                 PROT_READ | PROT_WRITE,
+                                                 MAP_SHARED | MAP_ANONYMOUS,
+                                                 -1, 0);
+    if (slots == MAP_FAILED) {
+        perror("mmap stats");
+        return EXIT_FAILURE;
+    }
+
+    /* No SA_RESTART: SIGINT/SIGTERM must interrupt accept() and send() */
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_signal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    /* With -R the parent only binds: a listening socket of its own would
+     * get a share of the connections and never accept them */
+    int lfd = open_listener(port, reuseport, !reuseport);
+    if (lfd < 0) return EXIT_FAILURE;
+
+    printf("[Server] Prefork server on port %d (msg_size=%d, %s, %d procs, "
+           "%s listener)\n", port, msg_size, strategy_names[strategy], procs,
+           reuseport ? "reuseport" : "inherited");
+    fflush(stdout);
+
+    pid_t pids[MAX_PROCS];
+    for (int i = 0; i < procs; i++) {
+        pids[i] = fork();
+        if (pids[i] < 0) {
+            perror("fork");
+            procs = i;
+            g_stop = 1;
+            break;
+        }
+        if (pids[i] == 0) {
+            if (reuseport) close(lfd);
+            worker_main(i, lfd, port, reuseport, strategy, msg_size,
+                        &slots[i]);
+        }
+    }
+
+    while (!g_stop) pause();
+
+    for (int i = 0; i < procs; i++) kill(pids[i], SIGTERM);
+    for (int i = 0; i < procs; i++) waitpid(pids[i], NULL, 0);
+    close(lfd);
+
+    long long bytes = 0, cost = 0;
+    long      conns = 0;
+    uint64_t  first = 0, last = 0;
+    int       cycles = 1;
+    for (int i = 0; i < procs; i++) {
+        worker_slot_t *w = &slots[i];
+        long long b = atomic_load(&w->bytes), c = atomic_load(&w->cost);
+        printf("[Server W%d] pid %d, cpu %d: %ld conns, %.3f GB, %.3f %s/byte, "
+               "%ld minor faults, %ld invol. switches\n", i, w->pid, w->cpu,
+               atomic_load(&w->conns), b / 1e9, b > 0 ? (double)c / b : 0.0,
+               w->cycles ? "cycles" : "cpu_ns", w->minflt, w->nivcsw);
+
+        bytes += b;
+        cost  += c;
+        conns += atomic_load(&w->conns);
+        if (atomic_load(&w->conns) > 0 && !w->cycles) cycles = 0;
+
+        uint64_t f = atomic_load(&w->first_ns), l = atomic_load(&w->last_ns);
+        if (f && (first == 0 || f < first)) first = f;
+        if (l > last) last = l;
+    }
+
+    double secs = last > first ? (last - first) / 1e9 : 0;
+    printf("PREFORK,%s,%d,%d,%s,%ld,%.4f,%.3f,%s\n",
+           strategy_names[strategy], msg_size, procs,
+           reuseport ? "reuseport" : "inherit", conns,
+           secs > 0 ? bytes * 8.0 / secs / 1e9 : 0.0,
+           bytes > 0 ? (double)cost / bytes : 0.0,
+           cycles ? "cycles" : "cpu_ns");
+
+    munmap(slots, procs * sizeof(worker_slot_t));
+    return EXIT_SUCCESS;
+}
@@ -5,7 +5,8 @@
  * Common definitions shared across all socket implementations:
  *   - Message structure with 8 dynamically allocated string fields
  *   - Serialization / deserialization helpers
- *   - Timing utilities for throughput & latency measurement
+ *   - Timing utilities for throughput & latency measurement (including
+ *     a TSC-based timer for the per-message loops)
  *   - Network configuration constants
  *
  * AI Declaration: Used ChatGPT to clarify the sendmsg() iovec layout
@@ -27,6 +28,15 @@
 #include <sys/types.h>
 #include <netinet/in.h>
 #include <netinet/tcp.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include <stdint.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#include <cpuid.h>
+#define HAVE_TSC           1
+#endif
 
 /* ------------------------------------------------------------------ */
 /*  Constants                                                          */
@@ -36,6 +46,7 @@
 #define DEFAULT_DURATION   10          /* seconds each client sends   */
 #define NUM_FIELDS         8           /* string fields per message   */
 #define BACKLOG            64          /* listen() backlog            */
+#define MAX_MSG_SIZE       (64 << 20)  /* largest size a peer may ask for */
 
 /* ------------------------------------------------------------------ */
 /*  Message structure – 8 heap-allocated string fields                 */
@@ -54,6 +65,8 @@ typedef struct {
     int  client_fd;
     int  msg_size;                     /* total message size in bytes */
     int  thread_id;
+    int  slot;                         /* placement index (A4: clients
+                                          connected before this one)   */
 } thread_arg_t;
 
 /* ------------------------------------------------------------------ */
@@ -65,6 +78,7 @@ typedef struct {
     int         server_port;
     int         msg_size;
     int         duration_sec;
+    int         warmup_sec;            /* unmeasured lead-in          */
     int         thread_id;
     /* results written back by the thread */
     double      throughput_bps;
@@ -90,6 +104,172 @@ static inline double elapsed_us(struct timespec *start, struct timespec *end)
            (end->tv_nsec - start->tv_nsec) / 1e3;
 }
 
+/* ------------------------------------------------------------------ */
+/*  Low-overhead timer for the per-message hot loops                   */
+/*                                                                     */
+/*  Three clock_gettime() calls per message are measurable for small   */
+/*  messages.  When the CPU has an invariant TSC (CPUID 0x80000007     */
+/*  EDX[8]) ticks are raw rdtsc/rdtscp values, converted with a factor */
+/*  calibrated once against CLOCK_MONOTONIC.  Otherwise (or with       */
+/*  PA02_NO_TSC set in the environment) a tick is one nanosecond of    */
+/*  vDSO clock_gettime().  Call timing_init() before the first use.    */
+/* ------------------------------------------------------------------ */
+
+#define TSC_CALIBRATE_NS      20000000ULL  /* 20 ms calibration window */
+#define DEADLINE_CHECK_EVERY  64           /* messages between checks  */
+
+typedef struct {
+    int    use_tsc;
+    double ns_per_tick;
+} tick_clock_t;
+
+static tick_clock_t   g_ticks = { 0, 1.0 };
+static pthread_once_t g_ticks_once = PTHREAD_ONCE_INIT;
+
+static inline uint64_t mono_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static inline int tsc_invariant(void)
+{
+#ifdef HAVE_TSC
+    unsigned a, b, c, d;
+    if (!__get_cpuid(0x80000000, &a, &b, &c, &d) || a < 0x80000007)
+        return 0;
+    __get_cpuid(0x80000007, &a, &b, &c, &d);
+    return (d >> 8) & 1;
+#else
+    return 0;
+#endif
+}
+
+static inline void timing_calibrate(void)
+{
+#ifdef HAVE_TSC
+    if (!tsc_invariant() || getenv("PA02_NO_TSC")) return;
+
+    /* Spin rather than sleep so the core stays at a steady frequency */
+    uint64_t n0 = mono_ns(), t0 = __rdtsc();
+    while (mono_ns() - n0 < TSC_CALIBRATE_NS)
+        ;
+    uint64_t n1 = mono_ns(), t1 = __rdtsc();
+
+    if (t1 > t0) {
+        g_ticks.ns_per_tick = (double)(n1 - n0) / (double)(t1 - t0);
+        g_ticks.use_tsc     = 1;
+    }
+#endif
+}
+
+static inline void timing_init(void)
+{
+    pthread_once(&g_ticks_once, timing_calibrate);
+}
+
+static inline const char *timing_source(void)
+{
+    return g_ticks.use_tsc ? "tsc" : "clock_gettime";
+}
+
+/* Start of a timed region */
+static inline uint64_t ticks_now(void)
+{
+#ifdef HAVE_TSC
+    if (g_ticks.use_tsc) return __rdtsc();
+#endif
+    return mono_ns();
+}
+
+/* End of a timed region: rdtscp waits for the preceding instructions */
+static inline uint64_t ticks_end(void)
+{
+#ifdef HAVE_TSC
+    if (g_ticks.use_tsc) {
+        unsigned aux;
+        return __rdtscp(&aux);
+    }
+#endif
+    return mono_ns();
+}
+
+static inline double ticks_to_us(uint64_t ticks)
+{
+    return (double)ticks * g_ticks.ns_per_tick / 1e3;
+}
+
+/* Loop deadline that reads the clock only every `every` iterations */
+typedef struct {
+    uint64_t end;
+    unsigned every;
+    unsigned count;
+} deadline_t;
+
+static inline void deadline_set(deadline_t *d, double seconds, unsigned every)
+{
+    d->end   = ticks_now() + (uint64_t)(seconds * 1e9 / g_ticks.ns_per_tick);
+    d->every = every ? every : 1;
+    d->count = 0;
+}
+
+static inline int deadline_passed(deadline_t *d)
+{
+    if (++d->count < d->every) return 0;
+    d->count = 0;
+    return ticks_now() >= d->end;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Per-thread CPU cost                                                */
+/*                                                                     */
+/*  Counts CPU cycles of the calling thread with perf_event_open().    */
+/*  Where the PMU is unavailable (VMs, perf_event_paranoid) it falls   */
+/*  back to thread CPU time, and `unit` says which one was measured.   */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+    int                 fd;            /* perf fd, -1 = CPU-time fallback */
+    const char         *unit;          /* "cycles" or "cpu_ns"            */
+    unsigned long long  start;
+} cpu_meter_t;
+
+static inline unsigned long long cpu_meter_now(const cpu_meter_t *m)
+{
+    if (m->fd >= 0) {
+        unsigned long long v = 0;
+        if (read(m->fd, &v, sizeof(v)) == sizeof(v)) return v;
+        return 0;
+    }
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/* Must be called on the thread being measured */
+static inline void cpu_meter_start(cpu_meter_t *m)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size   = sizeof(attr);
+    attr.type   = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_CPU_CYCLES;
+
+    m->fd    = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    m->unit  = (m->fd >= 0) ? "cycles" : "cpu_ns";
+    m->start = cpu_meter_now(m);
+}
+
+/* Cycles (or CPU ns) consumed by the thread since cpu_meter_start() */
+static inline unsigned long long cpu_meter_stop(cpu_meter_t *m)
+{
+    unsigned long long used = cpu_meter_now(m) - m->start;
+    if (m->fd >= 0) close(m->fd);
+    m->fd = -1;
+    return used;
+}
+
 /* ------------------------------------------------------------------ */
 /*  Message allocation & initialisation                                */
 /* ------------------------------------------------------------------ */
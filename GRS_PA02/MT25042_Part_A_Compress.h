@@ -0,0 +1,386 @@
+/**
+ * MT25042_Part_A_Compress.h
+ * Graduate Systems (CSE638) - PA02: Analysis of Network I/O primitives
+ *
+ * Optional compression stage for the A4 send path:
+ *   - lz_compress / lz_decompress: a small LZ77 codec writing the LZ4
+ *     block format (token, literals, 16-bit offset, match length), so
+ *     its speed/ratio trade-off is that of the LZ4 fast mode.  It is
+ *     kept in-tree to avoid a new library dependency.
+ *   - lz_pipe_t: a compressor thread that serializes `batch` messages,
+ *     compresses them and queues the resulting frames in a small ring.
+ *     The handler thread only pops finished frames and writes them, so
+ *     compression overlaps with the socket writes instead of adding to
+ *     them.
+ *
+ * Frame on the wire (little endian header, then the compressed block):
+ *   u32 raw_len   bytes after decompression
+ *   u32 comp_len  bytes of compressed payload that follow
+ *   u32 count     messages in the frame
+ *
+ * AI Declaration: Codec written from the public LZ4 block format
+ *   description; no AI prompts.
+ */
+
+#ifndef MT25042_PART_A_COMPRESS_H
+#define MT25042_PART_A_COMPRESS_H
+
+#include "MT25042_Part_A_Common.h"
+#include <stdint.h>
+#include <sys/uio.h>
+
+/* ------------------------------------------------------------------ */
+/*  Codec                                                              */
+/* ------------------------------------------------------------------ */
+
+#define LZ_HASH_BITS       12
+#define LZ_MIN_MATCH       4
+#define LZ_MFLIMIT         12          /* no match may start after end-12 */
+#define LZ_LAST_LITERALS   5           /* ... or extend into the last 5   */
+#define LZ_MAX_OFFSET      65535
+
+/* Worst-case compressed size of `n` input bytes */
+static inline size_t lz_bound(size_t n)
+{
+    return n + n / 255 + 16;
+}
+
+static inline uint32_t lz_read32(const unsigned char *p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint32_t lz_hash(uint32_t v)
+{
+    return (v * 2654435761u) >> (32 - LZ_HASH_BITS);
+}
+
+/* Writes a length continuation (the part above 15) as 255-byte runs */
+static inline unsigned char *lz_put_len(unsigned char *op, size_t len)
+{
+    while (len >= 255) { *op++ = 255; len -= 255; }
+    *op++ = (unsigned char)len;
+    return op;
+}
+
+/* Emits one sequence: `lit` literals from `anchor`, then an optional match */
+static inline unsigned char *lz_emit(unsigned char *op,
+                                     const unsigned char *anchor, size_t lit,
+                                     size_t offset, size_t mlen, int has_match)
+{
+    unsigned char *token = op++;
+
+    if (lit >= 15) {
+        *token = 15 << 4;
+        op = lz_put_len(op, lit - 15);
+    } else {
+        *token = (unsigned char)(lit << 4);
+    }
+    memcpy(op, anchor, lit);
+    op += lit;
+
+    if (!has_match) return op;
+
+    *op++ = (unsigned char)(offset & 0xff);
+    *op++ = (unsigned char)(offset >> 8);
+    if (mlen >= 15) {
+        *token |= 15;
+        op = lz_put_len(op, mlen - 15);
+    } else {
+        *token |= (unsigned char)mlen;
+    }
+    return op;
+}
+
+/**
+ * lz_compress – compresses `n` bytes of `src` into `dst`, which must hold
+ *               lz_bound(n) bytes.  Returns the compressed size.
+ */
+static inline size_t lz_compress(const unsigned char *src, size_t n,
+                                 unsigned char *dst)
+{
+    uint32_t table[1 << LZ_HASH_BITS];          /* position + 1, 0 = empty */
+    memset(table, 0, sizeof(table));
+
+    const unsigned char *ip      = src;
+    const unsigned char *anchor  = src;
+    const unsigned char *end     = src + n;
+    const unsigned char *mflimit = (n > LZ_MFLIMIT) ? end - LZ_MFLIMIT : src;
+    const unsigned char *mlimit  = (n > LZ_LAST_LITERALS) ? end - LZ_LAST_LITERALS
+                                                           : src;
+    unsigned char       *op      = dst;
+
+    while (ip < mflimit) {
+        uint32_t seq = lz_read32(ip);
+        uint32_t h   = lz_hash(seq);
+        uint32_t cand = table[h];
+        table[h] = (uint32_t)(ip - src) + 1;
+
+        const unsigned char *ref = cand ? src + cand - 1 : NULL;
+        if (!ref || ip - ref > LZ_MAX_OFFSET || lz_read32(ref) != seq) {
+            ip++;
+            continue;
+        }
+
+        /* Extend the match as far as the tail rule allows */
+        const unsigned char *mp = ip + LZ_MIN_MATCH;
+        const unsigned char *rp = ref + LZ_MIN_MATCH;
+        while (mp < mlimit && *mp == *rp) { mp++; rp++; }
+
+        op = lz_emit(op, anchor, (size_t)(ip - anchor), (size_t)(ip - ref),
+                     (size_t)(mp - ip) - LZ_MIN_MATCH, 1);
+        ip = anchor = mp;
+    }
+
+    /* Final literal-only sequence */
+    op = lz_emit(op, anchor, (size_t)(end - anchor), 0, 0, 0);
+    return (size_t)(op - dst);
+}
+
+/**
+ * lz_decompress – expands `n` bytes of `src` into at most `cap` bytes of
+ *                 `dst`.  Returns the decompressed size, or -1 if the
+ *                 block is malformed.
+ */
+static inline ssize_t lz_decompress(const unsigned char *src, size_t n,
+                                    unsigned char *dst, size_t cap)
+{
+    const unsigned char *ip   = src;
+    const unsigned char *iend = src + n;
+    unsigned char       *op   = dst;
+    unsigned char       *oend = dst + cap;
+
+    while (ip < iend) {
+        unsigned token = *ip++;
+
+        size_t lit = token >> 4;
+        if (lit == 15) {
+            unsigned char b;
+            do {
+                if (ip >= iend) return -1;
+                b = *ip++;
+                lit += b;
+            } while (b == 255);
+        }
+        if (lit > (size_t)(iend - ip) || lit > (size_t)(oend - op)) return -1;
+        memcpy(op, ip, lit);
+        ip += lit;
+        op += lit;
+
+        if (ip == iend) break;               /* last sequence has no match */
+
+        if (iend - ip < 2) return -1;
+        size_t offset = (size_t)ip[0] | ((size_t)ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > (size_t)(op - dst)) return -1;
+
+        size_t mlen = token & 15;
+        if (mlen == 15) {
+            unsigned char b;
+            do {
+                if (ip >= iend) return -1;
+                b = *ip++;
+                mlen += b;
+            } while (b == 255);
+        }
+        mlen += LZ_MIN_MATCH;
+        if (mlen > (size_t)(oend - op)) return -1;
+
+        const unsigned char *ref = op - offset;
+        if (offset == 1) {
+            memset(op, *ref, mlen);          /* run of one byte */
+        } else if (offset >= mlen) {
+            memcpy(op, ref, mlen);
+        } else {
+            for (size_t i = 0; i < mlen; i++) op[i] = ref[i];
+        }
+        op += mlen;
+    }
+    return (ssize_t)(op - dst);
+}
+
+/* ------------------------------------------------------------------ */
+/*  Framing                                                            */
+/* ------------------------------------------------------------------ */
+
+#define LZ_FRAME_HDR       12
+#define LZ_FRAME_MAX       (64u << 20) /* sanity limit on either length */
+
+static inline void lz_put32(unsigned char *p, uint32_t v)
+{
+    p[0] = (unsigned char)v;
+    p[1] = (unsigned char)(v >> 8);
+    p[2] = (unsigned char)(v >> 16);
+    p[3] = (unsigned char)(v >> 24);
+}
+
+static inline uint32_t lz_get32(const unsigned char *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/* ------------------------------------------------------------------ */
+/*  Compression pipeline – one compressor thread per connection        */
+/* ------------------------------------------------------------------ */
+
+#define LZ_PIPE_DEPTH      4           /* frames queued ahead of send()  */
+
+typedef struct {
+    unsigned char *buf;                /* header + compressed block      */
+    size_t         len;
+} lz_frame_t;
+
+typedef struct {
+    /* input, fixed while the thread runs */
+    const struct iovec *iov;           /* message fields                 */
+    int                 iovcnt;
+    size_t              msg_len;
+    int                 batch;         /* messages per frame             */
+
+    pthread_t           thread;
+    pthread_mutex_t     lock;
+    pthread_cond_t      not_empty;
+    pthread_cond_t      not_full;
+    lz_frame_t          ring[LZ_PIPE_DEPTH];
+    unsigned            head;          /* next frame to send             */
+    unsigned            tail;          /* next slot to fill              */
+    int                 stop;
+
+    unsigned char      *staging;       /* serialized batch               */
+
+    /* results, valid after lz_pipe_stop() */
+    unsigned long long  raw_bytes;
+    unsigned long long  wire_bytes;
+    unsigned long long  cost;          /* compressor CPU, in cost_unit   */
+    const char         *cost_unit;
+} lz_pipe_t;
+
+static inline void *lz_pipe_thread(void *arg)
+{
+    lz_pipe_t *p   = (lz_pipe_t *)arg;
+    size_t     raw = p->msg_len * (size_t)p->batch;
+
+    cpu_meter_t meter;
+    cpu_meter_start(&meter);
+
+    pthread_mutex_lock(&p->lock);
+    while (!p->stop) {
+        while (!p->stop && p->tail - p->head == LZ_PIPE_DEPTH)
+            pthread_cond_wait(&p->not_full, &p->lock);
+        if (p->stop) break;
+        lz_frame_t *f = &p->ring[p->tail % LZ_PIPE_DEPTH];
+        pthread_mutex_unlock(&p->lock);
+
+        /* Serialize the batch (the copy two_copy would do) and compress */
+        size_t off = 0;
+        for (int b = 0; b < p->batch; b++)
+            for (int i = 0; i < p->iovcnt; i++) {
+                memcpy(p->staging + off, p->iov[i].iov_base, p->iov[i].iov_len);
+                off += p->iov[i].iov_len;
+            }
+        size_t clen = lz_compress(p->staging, raw, f->buf + LZ_FRAME_HDR);
+        lz_put32(f->buf,     (uint32_t)raw);
+        lz_put32(f->buf + 4, (uint32_t)clen);
+        lz_put32(f->buf + 8, (uint32_t)p->batch);
+        f->len = LZ_FRAME_HDR + clen;
+
+        p->raw_bytes  += raw;
+        p->wire_bytes += f->len;
+
+        pthread_mutex_lock(&p->lock);
+        p->tail++;
+        pthread_cond_signal(&p->not_empty);
+    }
+    pthread_mutex_unlock(&p->lock);
+
+    p->cost      = cpu_meter_stop(&meter);
+    p->cost_unit = meter.unit;
+    return NULL;
+}
+
+/**
+ * lz_pipe_start – starts compressing frames of `batch` copies of the
+ *                 message described by `iov`.  Returns 0 or -1.
+ */
+static inline int lz_pipe_start(lz_pipe_t *p, const struct iovec *iov,
+                                int iovcnt, int batch)
+{
+    memset(p, 0, sizeof(*p));
+    p->iov    = iov;
+    p->iovcnt = iovcnt;
+    p->batch  = batch > 0 ? batch : 1;
+    for (int i = 0; i < iovcnt; i++) p->msg_len += iov[i].iov_len;
+
+    size_t raw = p->msg_len * (size_t)p->batch;
+    if (raw > LZ_FRAME_MAX) {
+        fprintf(stderr, "lz_pipe: frame of %zu bytes too large\n", raw);
+        return -1;
+    }
+
+    p->staging = (unsigned char *)malloc(raw);
+    for (int i = 0; i < LZ_PIPE_DEPTH; i++)
+        p->ring[i].buf = (unsigned char *)malloc(LZ_FRAME_HDR + lz_bound(raw));
+
+    pthread_mutex_init(&p->lock, NULL);
+    pthread_cond_init(&p->not_empty, NULL);
+    pthread_cond_init(&p->not_full, NULL);
+
+    int ok = p->staging != NULL;
+    for (int i = 0; i < LZ_PIPE_DEPTH; i++) ok = ok && p->ring[i].buf;
+    if (!ok || pthread_create(&p->thread, NULL, lz_pipe_thread, p) != 0) {
+        perror("lz_pipe_start");
+        for (int i = 0; i < LZ_PIPE_DEPTH; i++) free(p->ring[i].buf);
+        free(p->staging);
+        pthread_mutex_destroy(&p->lock);
+        pthread_cond_destroy(&p->not_empty);
+        pthread_cond_destroy(&p->not_full);
+        return -1;
+    }
+    return 0;
+}
+
+/* Blocks until the next compressed frame is ready */
+static inline lz_frame_t *lz_pipe_next(lz_pipe_t *p)
+{
+    pthread_mutex_lock(&p->lock);
+    while (p->head == p->tail)
+        pthread_cond_wait(&p->not_empty, &p->lock);
+    lz_frame_t *f = &p->ring[p->head % LZ_PIPE_DEPTH];
+    pthread_mutex_unlock(&p->lock);
+    return f;
+}
+
+/* Returns the frame from lz_pipe_next() to the compressor */
+static inline void lz_pipe_release(lz_pipe_t *p)
+{
+    pthread_mutex_lock(&p->lock);
+    p->head++;
+    pthread_cond_signal(&p->not_full);
+    pthread_mutex_unlock(&p->lock);
+}
+
+static inline void lz_pipe_stop(lz_pipe_t *p)
+{
+    pthread_mutex_lock(&p->lock);
+    p->stop = 1;
+    pthread_cond_broadcast(&p->not_full);
+    pthread_mutex_unlock(&p->lock);
+    pthread_join(p->thread, NULL);
+
+    /* Frames compressed but never sent do not count as wire traffic */
+    for (unsigned i = p->head; i != p->tail; i++) {
+        p->raw_bytes  -= p->msg_len * (size_t)p->batch;
+        p->wire_bytes -= p->ring[i % LZ_PIPE_DEPTH].len;
+    }
+
+    for (int i = 0; i < LZ_PIPE_DEPTH; i++) free(p->ring[i].buf);
+    free(p->staging);
+    pthread_mutex_destroy(&p->lock);
+    pthread_cond_destroy(&p->not_empty);
+    pthread_cond_destroy(&p->not_full);
+}
+
+#endif /* MT25042_PART_A_COMPRESS_H */
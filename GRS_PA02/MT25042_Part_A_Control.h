@@ -0,0 +1,360 @@
+/**
+ * MT25042_Part_A_Control.h
+ * Graduate Systems (CSE638) - PA02: Analysis of Network I/O primitives
+ *
+ * Control channel for the reconfigurable A4 server.  A line-based text
+ * protocol on a separate TCP port lets the experiment script change the
+ * message size, send strategy and socket options, and reset counters,
+ * between runs without restarting the server process.
+ *
+ * Protocol (one command per line, one reply line per command):
+ *   SET msg_size <bytes>          -> OK | ERR <reason>
+ *   SET strategy <name>           -> OK | ERR <reason>
+ *   SET sndbuf <bytes>            -> OK        (0 = kernel default)
+ *   SET nodelay <0|1>             -> OK
+ *   SET tls <none|ktls|user>      -> OK        (new connections only)
+ *   SET compress <0|1>            -> OK        (new connections only)
+ *   SET batch <n>                 -> OK        (messages per compressed frame)
+ *   SET direction <down|up|both>  -> OK        (new connections only)
+ *   SET rx_mode <recv|bulk|zerocopy_rx> -> OK  (new connections only)
+ *   GET                           -> CONFIG msg_size=.. strategy=.. ...
+ *   STATS                         -> STATS bytes=.. msgs=.. clients=.. ...
+ *   RESET                         -> OK        (zero all counters)
+ *   QUIT                          -> closes this control connection
+ *   SHUTDOWN                      -> OK, then the server exits
+ *
+ * Handlers pick up a new configuration at the next message boundary by
+ * comparing their copy of `generation` with the shared one.  The TLS
+ * mode, compression framing, direction and receive mode are fixed once
+ * a connection carries data, so they only affect connections accepted
+ * after the change.
+ *
+ * AI Declaration: This code structure was generated with AI assistance.
+ */
+
+#ifndef MT25042_PART_A_CONTROL_H
+#define MT25042_PART_A_CONTROL_H
+
+#include "MT25042_Part_A_Strategy.h"
+#include "MT25042_Part_A_TLS.h"
+#include "MT25042_Part_A_Compress.h"
+#include "MT25042_Part_A_Receive.h"
+#include <stdatomic.h>
+
+/* ------------------------------------------------------------------ */
+/*  Constants                                                          */
+/* ------------------------------------------------------------------ */
+
+#define CONTROL_PORT       (DEFAULT_PORT + 1)
+#define CONTROL_LINE_MAX   256
+
+/* ------------------------------------------------------------------ */
+/*  Shared server configuration + counters                             */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+    /* settings, written only by the control thread */
+    atomic_int       msg_size;
+    atomic_int       strategy;
+    atomic_int       sndbuf;           /* SO_SNDBUF, 0 = leave default */
+    atomic_int       nodelay;          /* TCP_NODELAY                  */
+    atomic_int       tls;              /* tls_mode_t for new clients   */
+    atomic_int       compress;         /* LZ frames for new clients    */
+    atomic_int       batch;            /* messages per frame           */
+    atomic_int       direction;        /* direction_t for new clients  */
+    atomic_int       rx_mode;          /* rx_mode_t for client data    */
+    atomic_uint      generation;       /* bumped on every SET          */
+
+    /* counters, updated by handler threads */
+    atomic_llong     bytes_sent;       /* payload (before compression) */
+    atomic_llong     wire_bytes;       /* bytes written to the socket  */
+    atomic_llong     comp_cost;        /* compressor cycles (or ns)    */
+    atomic_long      msgs_sent;
+    atomic_llong     bytes_received;   /* client -> server payload     */
+    atomic_llong     tx_cost;          /* send-thread cycles (or ns)   */
+    atomic_llong     rx_cost;          /* receive-thread cycles        */
+    const char      *cost_unit;        /* "cycles" / "cpu_ns"          */
+    atomic_int       clients;          /* currently connected          */
+    atomic_long      connections;      /* accepted since last RESET    */
+
+    atomic_int       shutdown;
+    int              control_port;
+    int              listen_fd;        /* data socket, woken on SHUTDOWN */
+} server_config_t;
+
+/* A handler's private snapshot of the configuration */
+typedef struct {
+    int      msg_size;
+    int      strategy;
+    int      sndbuf;
+    int      nodelay;
+    int      tls;
+    int      compress;
+    int      batch;
+    int      direction;
+    int      rx_mode;
+    unsigned generation;
+} config_snapshot_t;
+
+static inline void config_snapshot(server_config_t *cfg, config_snapshot_t *s)
+{
+    /* Read generation first: a SET racing with us bumps it again */
+    s->generation = atomic_load(&cfg->generation);
+    s->msg_size   = atomic_load(&cfg->msg_size);
+    s->strategy   = atomic_load(&cfg->strategy);
+    s->sndbuf     = atomic_load(&cfg->sndbuf);
+    s->nodelay    = atomic_load(&cfg->nodelay);
+    s->tls        = atomic_load(&cfg->tls);
+    s->compress   = atomic_load(&cfg->compress);
+    s->batch      = atomic_load(&cfg->batch);
+    s->direction  = atomic_load(&cfg->direction);
+    s->rx_mode    = atomic_load(&cfg->rx_mode);
+}
+
+static inline int config_changed(server_config_t *cfg,
+                                 const config_snapshot_t *s)
+{
+    return atomic_load_explicit(&cfg->generation, memory_order_relaxed)
+           != s->generation;
+}
+
+/* Applies the snapshot's socket options to a connected socket */
+static inline void apply_socket_options(int fd, const config_snapshot_t *s)
+{
+    if (s->sndbuf > 0 &&
+        setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &s->sndbuf, sizeof(s->sndbuf)) < 0)
+        perror("setsockopt SO_SNDBUF");
+    if (setsockopt(fd, IPPROTO_TCP, TCP_NODELAY,
+                   &s->nodelay, sizeof(s->nodelay)) < 0)
+        perror("setsockopt TCP_NODELAY");
+}
+
+static inline void config_reset_counters(server_config_t *cfg)
+{
+    atomic_store(&cfg->bytes_sent, 0);
+    atomic_store(&cfg->wire_bytes, 0);
+    atomic_store(&cfg->comp_cost, 0);
+    atomic_store(&cfg->bytes_received, 0);
+    atomic_store(&cfg->tx_cost, 0);
+    atomic_store(&cfg->rx_cost, 0);
+    atomic_store(&cfg->msgs_sent, 0);
+    atomic_store(&cfg->connections, 0);
+}
+
+/* ------------------------------------------------------------------ */
+/*  Command interpreter                                                */
+/* ------------------------------------------------------------------ */
+
+/**
+ * control_execute – runs one command line and writes the reply (without
+ *                   trailing newline) into `reply`.  Returns 0 to keep
+ *                   the connection open, 1 to close it.
+ */
+static inline int control_execute(server_config_t *cfg, char *line,
+                                  char *reply, size_t rlen)
+{
+    char *save = NULL;
+    char *cmd  = strtok_r(line, " \t\r\n", &save);
+    if (!cmd) { snprintf(reply, rlen, "ERR empty command"); return 0; }
+
+    if (strcmp(cmd, "SET") == 0) {
+        char *key = strtok_r(NULL, " \t\r\n", &save);
+        char *val = strtok_r(NULL, " \t\r\n", &save);
+        if (!key || !val) {
+            snprintf(reply, rlen, "ERR usage: SET <key> <value>");
+            return 0;
+        }
+        if (strcmp(key, "msg_size") == 0) {
+            int v = atoi(val);
+            if (v < NUM_FIELDS) {
+                snprintf(reply, rlen, "ERR msg_size must be >= %d", NUM_FIELDS);
+                return 0;
+            }
+            atomic_store(&cfg->msg_size, v);
+        } else if (strcmp(key, "strategy") == 0) {
+            int v = strategy_from_name(val);
+            if (v < 0) {
+                snprintf(reply, rlen, "ERR unknown strategy '%s'", val);
+                return 0;
+            }
+            atomic_store(&cfg->strategy, v);
+        } else if (strcmp(key, "sndbuf") == 0) {
+            atomic_store(&cfg->sndbuf, atoi(val) > 0 ? atoi(val) : 0);
+        } else if (strcmp(key, "nodelay") == 0) {
+            atomic_store(&cfg->nodelay, atoi(val) ? 1 : 0);
+        } else if (strcmp(key, "tls") == 0) {
+            int v = tls_mode_from_name(val);
+            if (v < 0) {
+                snprintf(reply, rlen, "ERR unknown tls mode '%s'", val);
+                return 0;
+            }
+            atomic_store(&cfg->tls, v);
+        } else if (strcmp(key, "compress") == 0) {
+            atomic_store(&cfg->compress, atoi(val) ? 1 : 0);
+        } else if (strcmp(key, "batch") == 0) {
+            atomic_store(&cfg->batch, atoi(val) > 0 ? atoi(val) : 1);
+        } else if (strcmp(key, "direction") == 0) {
+            int v = direction_from_name(val);
+            if (v < 0) {
+                snprintf(reply, rlen, "ERR unknown direction '%s'", val);
+                return 0;
+            }
+            atomic_store(&cfg->direction, v);
+        } else if (strcmp(key, "rx_mode") == 0) {
+            int v = rx_mode_from_name(val);
+            if (v < 0) {
+                snprintf(reply, rlen, "ERR unknown rx_mode '%s'", val);
+                return 0;
+            }
+            atomic_store(&cfg->rx_mode, v);
+        } else {
+            snprintf(reply, rlen, "ERR unknown key '%s'", key);
+            return 0;
+        }
+        atomic_fetch_add(&cfg->generation, 1);
+        snprintf(reply, rlen, "OK");
+    } else if (strcmp(cmd, "GET") == 0) {
+        snprintf(reply, rlen,
+                 "CONFIG msg_size=%d strategy=%s sndbuf=%d nodelay=%d tls=%s "
+                 "compress=%d batch=%d direction=%s rx_mode=%s",
+                 atomic_load(&cfg->msg_size),
+                 strategy_names[atomic_load(&cfg->strategy)],
+                 atomic_load(&cfg->sndbuf), atomic_load(&cfg->nodelay),
+                 tls_mode_names[atomic_load(&cfg->tls)],
+                 atomic_load(&cfg->compress), atomic_load(&cfg->batch),
+                 direction_names[atomic_load(&cfg->direction)],
+                 rx_mode_names[atomic_load(&cfg->rx_mode)]);
+    } else if (strcmp(cmd, "STATS") == 0) {
+        snprintf(reply, rlen,
+                 "STATS bytes=%lld msgs=%ld clients=%d connections=%ld "
+                 "wire=%lld comp_cost=%lld rx=%lld tx_cost=%lld rx_cost=%lld "
+                 "unit=%s",
+                 atomic_load(&cfg->bytes_sent), atomic_load(&cfg->msgs_sent),
+                 atomic_load(&cfg->clients), atomic_load(&cfg->connections),
+                 atomic_load(&cfg->wire_bytes), atomic_load(&cfg->comp_cost),
+                 atomic_load(&cfg->bytes_received), atomic_load(&cfg->tx_cost),
+                 atomic_load(&cfg->rx_cost),
+                 cfg->cost_unit ? cfg->cost_unit : "cycles");
+    } else if (strcmp(cmd, "RESET") == 0) {
+        config_reset_counters(cfg);
+        snprintf(reply, rlen, "OK");
+    } else if (strcmp(cmd, "QUIT") == 0) {
+        snprintf(reply, rlen, "BYE");
+        return 1;
+    } else if (strcmp(cmd, "SHUTDOWN") == 0) {
+        atomic_store(&cfg->shutdown, 1);
+        /* Unblock the accept() loop in main() */
+        shutdown(cfg->listen_fd, SHUT_RDWR);
+        snprintf(reply, rlen, "OK");
+        return 1;
+    } else {
+        snprintf(reply, rlen, "ERR unknown command '%s'", cmd);
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Control thread – serves one control connection at a time           */
+/* ------------------------------------------------------------------ */
+
+static inline void control_serve(server_config_t *cfg, int fd)
+{
+    char line[CONTROL_LINE_MAX];
+    char reply[CONTROL_LINE_MAX];
+    size_t used = 0;
+
+    while (!atomic_load(&cfg->shutdown)) {
+        ssize_t n = recv(fd, line + used, sizeof(line) - 1 - used, 0);
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR) continue;
+            return;
+        }
+        used += (size_t)n;
+        line[used] = '\0';
+
+        /* Execute every complete line in the buffer */
+        char *start = line;
+        char *nl;
+        while ((nl = strchr(start, '\n')) != NULL) {
+            *nl = '\0';
+            int done = control_execute(cfg, start, reply, sizeof(reply) - 1);
+            strcat(reply, "\n");
+            send_all(fd, reply, strlen(reply), MSG_NOSIGNAL);
+            if (done) return;
+            start = nl + 1;
+        }
+
+        used = strlen(start);
+        memmove(line, start, used + 1);
+        if (used == sizeof(line) - 1) used = 0;   /* over-long line: drop */
+    }
+}
+
+static inline void *control_thread(void *arg)
+{
+    server_config_t *cfg = (server_config_t *)arg;
+
+    int lfd = create_tcp_socket();
+    struct sockaddr_in addr = {
+        .sin_family      = AF_INET,
+        .sin_port        = htons(cfg->control_port),
+        .sin_addr.s_addr = INADDR_ANY
+    };
+    if (bind(lfd, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+        listen(lfd, 4) < 0) {
+        perror("control bind/listen");
+        close(lfd);
+        return NULL;
+    }
+    printf("[Control] Listening on port %d\n", cfg->control_port);
+
+    while (!atomic_load(&cfg->shutdown)) {
+        int cfd = accept(lfd, NULL, NULL);
+        if (cfd < 0) {
+            if (errno == EINTR) continue;
+            perror("control accept");
+            continue;
+        }
+        control_serve(cfg, cfd);
+        close(cfd);
+    }
+
+    close(lfd);
+    return NULL;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Client side – used by tools that drive a running server            */
+/* ------------------------------------------------------------------ */
+
+/**
+ * control_request – sends one command on an open control connection and
+ *                   reads the single reply line into `reply` (newline
+ *                   stripped).  Returns 0 for an OK/data reply, -1 on an
+ *                   ERR reply or a broken connection.
+ */
+static inline int control_request(int fd, const char *cmd,
+                                  char *reply, size_t rlen)
+{
+    char   line[CONTROL_LINE_MAX];
+    size_t len = strlen(cmd);
+    if (len + 2 > sizeof(line)) return -1;
+    memcpy(line, cmd, len);
+    line[len++] = '\n';
+    if (send_all(fd, line, len, MSG_NOSIGNAL) <= 0) return -1;
+
+    size_t got = 0;
+    while (got < rlen - 1) {
+        ssize_t n = recv(fd, reply + got, 1, 0);
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR) continue;
+            return -1;
+        }
+        if (reply[got] == '\n') break;
+        got++;
+    }
+    reply[got] = '\0';
+    return strncmp(reply, "ERR", 3) == 0 ? -1 : 0;
+}
+
+#endif /* MT25042_PART_A_CONTROL_H */
@@ -0,0 +1,367 @@
+/**
+ * MT25042_Part_A_Placement.h
+ * Graduate Systems (CSE638) - PA02: Analysis of Network I/O primitives
+ *
+ * Topology-aware thread placement:
+ *   Set PA02_PLACEMENT=<policy> for the server and the client, call
+ *   placement_init(role) in main() and placement_pin(i) at the start of
+ *   server handler i / client thread i.  Handler i and client thread i
+ *   are the two ends of connection i, so the pair-based policies decide
+ *   what the sender and the receiver of a connection share.  The pairing
+ *   is approximate: the server numbers connections in accept order
+ *   (lowest free slot), which matches the client's thread order only
+ *   when the threads connect in order.  With traffic in both directions
+ *   a connection is two pairs, see placement_duplex().
+ *     compact       all threads packed in topology order, the two ends
+ *                   of a pair on consecutive CPUs (SMT siblings if any,
+ *                   else neighbouring cores of one package)
+ *     scatter       every thread on its own physical core, alternating
+ *                   packages; SMT siblings are only used once all cores
+ *                   are taken
+ *     same_core     pair i on the two hardware threads of core i (the
+ *                   same CPU without SMT): shared L1/L2
+ *     cross_socket  server threads on package 0, client threads on
+ *                   package 1: nothing shared below memory (falls back
+ *                   to separate cores on a single-package machine)
+ *     list:<cpus>   thread i on the i-th CPU of a list such as 0,2,4-7
+ *                   (one list per process)
+ *   Unset or "none" leaves placement to the scheduler.
+ *
+ *   The topology comes from /sys/devices/system/cpu (online CPUs,
+ *   physical_package_id, core_id), restricted to the process's
+ *   affinity mask.  Indices past the CPU count wrap around.
+ *
+ *   Includers must define _GNU_SOURCE (CPU_SET, pthread_setaffinity_np).
+ *
+ * AI Declaration: This code structure was generated with AI assistance.
+ */
+
+#ifndef MT25042_PART_A_PLACEMENT_H
+#define MT25042_PART_A_PLACEMENT_H
+
+#include "MT25042_Part_A_Common.h"
+#include <sched.h>
+
+#ifndef PLACEMENT_SYSFS
+#define PLACEMENT_SYSFS    "/sys/devices/system/cpu"
+#endif
+#define PLACE_MAX_CPUS     1024
+#define PLACE_MAX_PINNED   256         /* thread → CPU map kept for reports */
+
+typedef enum {
+    PLACE_NONE = 0,
+    PLACE_COMPACT,
+    PLACE_SCATTER,
+    PLACE_SAME_CORE,
+    PLACE_CROSS_SOCKET,
+    PLACE_LIST,
+    PLACE_COUNT
+} place_policy_t;
+
+static const char *const place_names[PLACE_COUNT] = {
+    "none", "compact", "scatter", "same_core", "cross_socket", "list"
+};
+
+typedef enum { ROLE_SERVER = 0, ROLE_CLIENT = 1 } place_role_t;
+
+typedef struct {
+    int cpu;
+    int pkg;                           /* physical_package_id           */
+    int core;                          /* core_id (unique per package)  */
+    int smt;                           /* rank among the core's siblings */
+    int rank;                          /* rank of the core in its package */
+} cpu_topo_t;
+
+typedef struct {
+    int             policy;
+    int             role;
+    char            spec[128];         /* PA02_PLACEMENT as given       */
+    cpu_topo_t      cpus[PLACE_MAX_CPUS];      /* compact order         */
+    cpu_topo_t      spread[PLACE_MAX_CPUS];    /* scatter order         */
+    int             ncpus;
+    int             list[PLACE_MAX_CPUS];
+    int             nlist;
+    pthread_mutex_t lock;
+    short           pinned[PLACE_MAX_PINNED];   /* -1 = not pinned      */
+    int             npinned;
+} placement_t;
+
+static placement_t g_place = { .lock = PTHREAD_MUTEX_INITIALIZER };
+
+/* ------------------------------------------------------------------ */
+/*  Topology                                                           */
+/* ------------------------------------------------------------------ */
+
+/* Parses a CPU list such as "0-3,8,10-11".  Returns entries stored. */
+static inline int parse_cpu_list(const char *s, int *out, int max)
+{
+    int n = 0;
+    while (*s && n < max) {
+        char *end;
+        long a = strtol(s, &end, 10);
+        if (end == s) break;
+        long b = a;
+        if (*end == '-') {
+            s = end + 1;
+            b = strtol(s, &end, 10);
+            if (end == s) break;
+        }
+        for (long c = a; c <= b && n < max; c++) out[n++] = (int)c;
+        s = end;
+        if (*s == ',') s++;
+    }
+    return n;
+}
+
+static inline int read_sysfs_int(int cpu, const char *name)
+{
+    char path[256];
+    snprintf(path, sizeof(path), PLACEMENT_SYSFS "/cpu%d/topology/%s",
+             cpu, name);
+    FILE *f = fopen(path, "r");
+    if (!f) return -1;
+    int v = -1;
+    if (fscanf(f, "%d", &v) != 1) v = -1;
+    fclose(f);
+    return v;
+}
+
+static inline int topo_cmp_compact(const void *x, const void *y)
+{
+    const cpu_topo_t *a = (const cpu_topo_t *)x, *b = (const cpu_topo_t *)y;
+    if (a->pkg  != b->pkg)  return a->pkg  - b->pkg;
+    if (a->core != b->core) return a->core - b->core;
+    return a->smt - b->smt;
+}
+
+/* Online CPUs in our affinity mask, sorted package → core → sibling */
+static inline int topology_load(cpu_topo_t *cpus, int max)
+{
+    char line[4096] = "";
+    FILE *f = fopen(PLACEMENT_SYSFS "/online", "r");
+    if (f) {
+        if (!fgets(line, sizeof(line), f)) line[0] = '\0';
+        fclose(f);
+    }
+    int online[PLACE_MAX_CPUS];
+    int nonline = parse_cpu_list(line, online, PLACE_MAX_CPUS);
+
+    cpu_set_t allowed;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) < 0) CPU_ZERO(&allowed);
+
+    int n = 0;
+    for (int i = 0; i < nonline && n < max; i++) {
+        int c = online[i];
+        if (c >= CPU_SETSIZE || !CPU_ISSET(c, &allowed)) continue;
+        cpus[n].cpu  = c;
+        cpus[n].pkg  = read_sysfs_int(c, "physical_package_id");
+        cpus[n].core = read_sysfs_int(c, "core_id");
+        if (cpus[n].pkg  < 0) cpus[n].pkg  = 0;
+        if (cpus[n].core < 0) cpus[n].core = c;
+        n++;
+    }
+
+    /* Sibling rank: CPUs of one core in CPU-number order */
+    for (int i = 0; i < n; i++) {
+        cpus[i].smt = 0;
+        for (int j = 0; j < i; j++)
+            if (cpus[j].pkg == cpus[i].pkg && cpus[j].core == cpus[i].core)
+                cpus[i].smt++;
+    }
+    qsort(cpus, n, sizeof(cpu_topo_t), topo_cmp_compact);
+
+    /* Core rank: position among the package's cores (core_id has gaps) */
+    for (int i = 0; i < n; i++) {
+        cpus[i].rank = 0;
+        if (i == 0) continue;
+        cpus[i].rank = cpus[i - 1].rank;
+        if (cpus[i].pkg != cpus[i - 1].pkg)        cpus[i].rank = 0;
+        else if (cpus[i].core != cpus[i - 1].core) cpus[i].rank++;
+    }
+    return n;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Policies                                                           */
+/* ------------------------------------------------------------------ */
+
+/* Spreading order: sibling level first, then core rank, then package */
+static inline int topo_cmp_scatter(const void *x, const void *y)
+{
+    const cpu_topo_t *a = (const cpu_topo_t *)x, *b = (const cpu_topo_t *)y;
+    if (a->smt  != b->smt)  return a->smt  - b->smt;
+    if (a->rank != b->rank) return a->rank - b->rank;
+    return a->pkg - b->pkg;
+}
+
+/* The k-th physical core of package `pkg` (CPU of its sibling `smt`) */
+static inline int core_cpu(int pkg, int k, int smt)
+{
+    int ncores = 0;
+    for (int j = 0; j < g_place.ncpus; j++) {
+        const cpu_topo_t *c = &g_place.cpus[j];
+        if ((pkg < 0 || c->pkg == pkg) && c->smt == 0) ncores++;
+    }
+    if (ncores == 0) return -1;
+    k %= ncores;
+
+    /* cpus[] is sorted package → core → sibling */
+    for (int j = 0; j < g_place.ncpus; j++) {
+        const cpu_topo_t *c = &g_place.cpus[j];
+        if ((pkg >= 0 && c->pkg != pkg) || c->smt != 0) continue;
+        if (k-- > 0) continue;
+
+        /* Requested sibling, or the core itself without SMT */
+        int cpu = c->cpu;
+        for (int s = j; s < g_place.ncpus && g_place.cpus[s].core == c->core &&
+                        g_place.cpus[s].pkg == c->pkg; s++)
+            if (g_place.cpus[s].smt == smt) cpu = g_place.cpus[s].cpu;
+        return cpu;
+    }
+    return -1;
+}
+
+static inline int placement_npkgs(void)
+{
+    int n = 0;
+    for (int j = 0; j < g_place.ncpus; j++)
+        if (j == 0 || g_place.cpus[j].pkg != g_place.cpus[j - 1].pkg) n++;
+    return n;
+}
+
+/* CPU for thread `idx` of this process's role, or -1 for no pinning */
+static inline int placement_cpu(int idx)
+{
+    int n = g_place.ncpus, r = g_place.role;
+    if (g_place.policy == PLACE_NONE || idx < 0) return -1;
+    if (g_place.policy == PLACE_LIST)
+        return g_place.nlist > 0 ? g_place.list[idx % g_place.nlist] : -1;
+    if (n == 0) return -1;
+
+    switch (g_place.policy) {
+    case PLACE_COMPACT:
+        return g_place.cpus[(2 * idx + r) % n].cpu;
+    case PLACE_SCATTER:
+        return g_place.spread[(2 * idx + r) % n].cpu;
+    case PLACE_SAME_CORE:
+        return core_cpu(-1, idx, r);
+    case PLACE_CROSS_SOCKET:
+        if (placement_npkgs() >= 2)
+            return core_cpu(g_place.cpus[r ? n - 1 : 0].pkg, idx, 0);
+        return g_place.spread[(2 * idx + r) % n].cpu;
+    }
+    return -1;
+}
+
+/* ------------------------------------------------------------------ */
+/*  API                                                                */
+/* ------------------------------------------------------------------ */
+
+static inline int pin_thread_to_cpu(int cpu)
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (rc != 0)
+        fprintf(stderr, "pthread_setaffinity_np(cpu %d): %s\n",
+                cpu, strerror(rc));
+    return rc == 0 ? 0 : -1;
+}
+
+/**
+ * placement_init – reads PA02_PLACEMENT and the topology.  `role` picks
+ *                  the server or the client end of each pair.
+ */
+static inline void placement_init(place_role_t role)
+{
+    const char *spec = getenv("PA02_PLACEMENT");
+    g_place.role = role;
+    for (int i = 0; i < PLACE_MAX_PINNED; i++) g_place.pinned[i] = -1;
+    if (!spec || !*spec || strcmp(spec, "none") == 0) return;
+
+    snprintf(g_place.spec, sizeof(g_place.spec), "%s", spec);
+    if (strncmp(spec, "list:", 5) == 0) {
+        g_place.policy = PLACE_LIST;
+        g_place.nlist  = parse_cpu_list(spec + 5, g_place.list, PLACE_MAX_CPUS);
+    } else {
+        for (int p = PLACE_COMPACT; p < PLACE_LIST; p++)
+            if (strcmp(spec, place_names[p]) == 0) g_place.policy = p;
+        if (g_place.policy == PLACE_NONE) {
+            fprintf(stderr, "[placement] unknown policy '%s' (compact, "
+                    "scatter, same_core, cross_socket, list:<cpus>); "
+                    "not pinning\n", spec);
+            return;
+        }
+    }
+
+    g_place.ncpus = topology_load(g_place.cpus, PLACE_MAX_CPUS);
+    memcpy(g_place.spread, g_place.cpus, g_place.ncpus * sizeof(cpu_topo_t));
+    qsort(g_place.spread, g_place.ncpus, sizeof(cpu_topo_t), topo_cmp_scatter);
+    int npkgs = placement_npkgs(), ncores = 0, smt = 0;
+    for (int j = 0; j < g_place.ncpus; j++) {
+        if (g_place.cpus[j].smt == 0) ncores++;
+        else smt = 1;
+    }
+    fprintf(stderr, "[placement] %s for %s threads: %d CPUs, %d cores, "
+            "%d package(s)\n", g_place.spec,
+            role == ROLE_SERVER ? "server" : "client",
+            g_place.ncpus, ncores, npkgs);
+    if (g_place.policy == PLACE_CROSS_SOCKET && npkgs < 2)
+        fprintf(stderr, "[placement] single package: cross_socket uses "
+                "separate cores instead\n");
+    if (g_place.policy == PLACE_SAME_CORE && !smt)
+        fprintf(stderr, "[placement] no SMT: same_core puts both ends on "
+                "the same CPU\n");
+}
+
+/* Placement index of one direction of connection `conn` when data flows
+ * both ways: 2*conn is server -> client (server sender, client receiver),
+ * 2*conn+1 is client -> server, so the four threads get four slots */
+static inline int placement_duplex(int conn, int upstream)
+{
+    return conn < 0 ? -1 : 2 * conn + upstream;
+}
+
+/* Pins the calling thread for slot `idx`.  Returns the CPU, or -1. */
+static inline int placement_pin(int idx)
+{
+    int cpu = placement_cpu(idx);
+    if (cpu < 0 || pin_thread_to_cpu(cpu) < 0) return -1;
+
+    if (idx < PLACE_MAX_PINNED) {
+        pthread_mutex_lock(&g_place.lock);
+        g_place.pinned[idx] = (short)cpu;
+        if (idx >= g_place.npinned) g_place.npinned = idx + 1;
+        pthread_mutex_unlock(&g_place.lock);
+    }
+    return cpu;
+}
+
+/**
+ * placement_describe – "none" or "<policy>[cpu,cpu,...]" listing the
+ *                      CPU of every pinned slot ('-' if not pinned), for
+ *                      result lines and logs.
+ */
+static inline const char *placement_describe(char *buf, size_t len)
+{
+    if (g_place.policy == PLACE_NONE) {
+        snprintf(buf, len, "none");
+        return buf;
+    }
+    size_t off = (size_t)snprintf(buf, len, "%s[",
+                                  place_names[g_place.policy]);
+    pthread_mutex_lock(&g_place.lock);
+    for (int i = 0; i < g_place.npinned && off < len; i++) {
+        if (g_place.pinned[i] >= 0)
+            off += (size_t)snprintf(buf + off, len - off, "%s%d",
+                                    i ? " " : "", g_place.pinned[i]);
+        else
+            off += (size_t)snprintf(buf + off, len - off, "%s-", i ? " " : "");
+    }
+    pthread_mutex_unlock(&g_place.lock);
+    if (off < len) snprintf(buf + off, len - off, "]");
+    return buf;
+}
+
+#endif /* MT25042_PART_A_PLACEMENT_H */
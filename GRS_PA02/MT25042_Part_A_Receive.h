@@ -0,0 +1,183 @@
+/**
+ * MT25042_Part_A_Receive.h
+ * Graduate Systems (CSE638) - PA02: Analysis of Network I/O primitives
+ *
+ * Traffic direction of an A4 connection and the server's receive paths
+ * for client-to-server data:
+ *   - recv       : recv() exactly one message at a time (mirror of the
+ *                  A1-A3 client loop)
+ *   - bulk       : recv() into a large buffer, ignoring message
+ *                  boundaries (streaming ingest)
+ *   - zerocopy_rx: TCP_ZEROCOPY_RECEIVE maps whole received pages into a
+ *                  region mmap()ed on the socket; the unaligned
+ *                  remainder the kernel reports in recv_skip_hint is read
+ *                  with recv().  Falls back to bulk if the socket does
+ *                  not support it (e.g. kTLS).
+ *
+ * AI Declaration: TCP_ZEROCOPY_RECEIVE loop follows the kernel's
+ *   tools/testing/selftests/net/tcp_mmap.c; no AI prompts.
+ */
+
+#ifndef MT25042_PART_A_RECEIVE_H
+#define MT25042_PART_A_RECEIVE_H
+
+#include "MT25042_Part_A_Common.h"
+#include <sys/mman.h>
+#include <poll.h>
+
+/* ------------------------------------------------------------------ */
+/*  Direction                                                          */
+/* ------------------------------------------------------------------ */
+
+typedef enum {
+    DIR_DOWN = 0,                      /* server -> client (A1-A3)      */
+    DIR_UP,                            /* client -> server              */
+    DIR_BOTH,                          /* full duplex                   */
+    DIR_COUNT
+} direction_t;
+
+static const char *const direction_names[DIR_COUNT] = {
+    "down", "up", "both"
+};
+
+static inline int direction_from_name(const char *name)
+{
+    for (int i = 0; i < DIR_COUNT; i++)
+        if (strcmp(name, direction_names[i]) == 0) return i;
+    return -1;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Receive modes                                                      */
+/* ------------------------------------------------------------------ */
+
+typedef enum {
+    RX_RECV = 0,
+    RX_BULK,
+    RX_ZEROCOPY,
+    RX_COUNT
+} rx_mode_t;
+
+static const char *const rx_mode_names[RX_COUNT] = {
+    "recv", "bulk", "zerocopy_rx"
+};
+
+static inline int rx_mode_from_name(const char *name)
+{
+    for (int i = 0; i < RX_COUNT; i++)
+        if (strcmp(name, rx_mode_names[i]) == 0) return i;
+    return -1;
+}
+
+#define RX_BULK_SIZE       (256 * 1024)
+#define RX_ZC_CHUNK        (512 * 1024) /* mapped window, page multiple */
+
+typedef struct {
+    int     fd;
+    int     mode;
+    int     msg_len;
+    char   *buf;                       /* recv()/skip-hint buffer       */
+    size_t  buf_len;
+    void   *map;                       /* TCP_ZEROCOPY_RECEIVE window   */
+    long    zc_bytes;                  /* bytes received by remapping   */
+} receiver_t;
+
+/**
+ * receiver_init – prepares `fd` for receiving in `mode`.  Returns 0 on
+ *                 success, -1 on failure.
+ */
+static inline int receiver_init(receiver_t *r, int fd, int mode, int msg_len)
+{
+    memset(r, 0, sizeof(*r));
+    r->fd      = fd;
+    r->mode    = mode;
+    r->msg_len = msg_len;
+    r->buf_len = (mode == RX_RECV) ? (size_t)msg_len : RX_BULK_SIZE;
+    r->buf     = (char *)malloc(r->buf_len);
+    if (!r->buf) { perror("malloc rx buf"); return -1; }
+
+    if (mode == RX_ZEROCOPY) {
+        r->map = mmap(NULL, RX_ZC_CHUNK, PROT_READ, MAP_SHARED, fd, 0);
+        if (r->map == MAP_FAILED) {
+            perror("mmap for TCP_ZEROCOPY_RECEIVE (using bulk)");
+            r->map  = NULL;
+            r->mode = RX_BULK;
+        }
+    }
+    return 0;
+}
+
+/* Returns bytes consumed, 0 on EOF, -1 on error */
+static inline ssize_t receiver_recv(receiver_t *r)
+{
+    switch (r->mode) {
+    case RX_RECV:
+        return recv_all(r->fd, r->buf, r->msg_len, 0);
+    case RX_BULK:
+        while (1) {
+            ssize_t n = recv(r->fd, r->buf, r->buf_len, 0);
+            if (n < 0 && errno == EINTR) continue;
+            return n;
+        }
+    case RX_ZEROCOPY: {
+        struct tcp_zerocopy_receive zc;
+        socklen_t zlen = sizeof(zc);
+        memset(&zc, 0, sizeof(zc));
+        zc.address = (uint64_t)(unsigned long)r->map;
+        zc.length  = RX_ZC_CHUNK;
+
+        if (getsockopt(r->fd, IPPROTO_TCP, TCP_ZEROCOPY_RECEIVE,
+                       &zc, &zlen) < 0) {
+            if (errno == EINTR) return receiver_recv(r);
+            /* Fails with EIO once the peer has closed: report EOF */
+            char c;
+            if (recv(r->fd, &c, 1, MSG_PEEK | MSG_DONTWAIT) == 0) return 0;
+            perror("TCP_ZEROCOPY_RECEIVE (using bulk)");
+            munmap(r->map, RX_ZC_CHUNK);
+            r->map  = NULL;
+            r->mode = RX_BULK;
+            return receiver_recv(r);
+        }
+
+        if (zc.length == 0 && zc.recv_skip_hint == 0) {
+            /* Nothing queued: wait, then tell EOF apart from new data */
+            struct pollfd pfd = { .fd = r->fd, .events = POLLIN };
+            if (poll(&pfd, 1, -1) < 0 && errno != EINTR) return -1;
+            char c;
+            ssize_t n = recv(r->fd, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+            if (n == 0) return 0;
+            if (n < 0 && errno != EAGAIN && errno != EINTR) return -1;
+            return receiver_recv(r);
+        }
+
+        ssize_t got = zc.length;
+        r->zc_bytes += zc.length;
+
+        /* Bytes that could not be mapped (partial pages) */
+        size_t skip = zc.recv_skip_hint;
+        if (skip > 0) {
+            ssize_t n = recv(r->fd, r->buf,
+                             skip < r->buf_len ? skip : r->buf_len, 0);
+            if (n < 0) {
+                if (got > 0) return got;
+                return (errno == EINTR) ? receiver_recv(r) : -1;
+            }
+            if (n == 0 && got == 0) return 0;
+            got += n;
+        }
+        return got;
+    }
+    }
+    errno = EINVAL;
+    return -1;
+}
+
+static inline void receiver_free(receiver_t *r)
+{
+    if (r->map) munmap(r->map, RX_ZC_CHUNK);
+    free(r->buf);
+    r->map = NULL;
+    r->buf = NULL;
+}
+
+#endif /* MT25042_PART_A_RECEIVE_H */
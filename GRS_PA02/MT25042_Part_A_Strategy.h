@@ -0,0 +1,281 @@
+/**
+ * MT25042_Part_A_Strategy.h
+ * Graduate Systems (CSE638) - PA02: Analysis of Network I/O primitives
+ *
+ * The three send strategies of A1-A3 packaged behind one interface so a
+ * single process can switch between them at run time:
+ *   - two_copy  : serialize into a flat buffer, then send()
+ *   - one_copy  : sendmsg() with an iovec over the 8 heap fields
+ *   - zero_copy : sendmsg() + MSG_ZEROCOPY, completions drained from
+ *                 the socket error queue
+ *   - sendfile  : the serialized message lives in a memfd and is sent
+ *                 with sendfile(), so the kernel moves page-cache pages
+ *                 (this is also the path kTLS can do zero-copy on)
+ *
+ * Includers must define _GNU_SOURCE (for memfd_create).
+ *
+ * Unlike A2/A3, partial sendmsg() writes are resumed by advancing the
+ * iovec, so message boundaries on the wire are always preserved.
+ *
+ * AI Declaration: Reused the send loops from A1-A3; no new AI prompts.
+ */
+
+#ifndef MT25042_PART_A_STRATEGY_H
+#define MT25042_PART_A_STRATEGY_H
+
+#include "MT25042_Part_A_Common.h"
+#include "MT25042_Part_A_Trace.h"
+#include <sys/uio.h>
+#include <sys/mman.h>
+#include <sys/sendfile.h>
+#include <linux/errqueue.h>
+
+/* ------------------------------------------------------------------ */
+/*  Strategy identifiers                                               */
+/* ------------------------------------------------------------------ */
+
+typedef enum {
+    STRAT_TWO_COPY = 0,
+    STRAT_ONE_COPY,
+    STRAT_ZERO_COPY,
+    STRAT_SENDFILE,
+    STRAT_COUNT
+} strategy_t;
+
+static const char *const strategy_names[STRAT_COUNT] = {
+    "two_copy", "one_copy", "zero_copy", "sendfile"
+};
+
+/* Returns the strategy for `name`, or -1 if it is not recognised. */
+static inline int strategy_from_name(const char *name)
+{
+    for (int i = 0; i < STRAT_COUNT; i++)
+        if (strcmp(name, strategy_names[i]) == 0) return i;
+    return -1;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Sender state – one per connection                                  */
+/* ------------------------------------------------------------------ */
+
+#define ZC_DRAIN_INTERVAL  64          /* messages between error-queue drains */
+
+typedef struct {
+    int           fd;
+    int           strategy;
+    int           msg_len;             /* bytes per message on the wire */
+    message_t    *msg;
+    char         *flat;                /* serialized copy (two_copy)    */
+    int           file_fd;             /* memfd holding flat (sendfile) */
+    struct iovec  iov[NUM_FIELDS];
+    long          sends;               /* sendmsg calls issued          */
+    long          zc_msgs;             /* zero-copy messages sent       */
+    long          zc_completed;        /* zero-copy sends acknowledged  */
+    long          zc_copied;           /* ... that fell back to a copy  */
+} sender_t;
+
+/* ------------------------------------------------------------------ */
+/*  Zero-copy completion handling                                      */
+/* ------------------------------------------------------------------ */
+
+/**
+ * zc_drain – consume every pending MSG_ZEROCOPY notification on `fd`
+ *            without blocking.  Each notification covers the inclusive
+ *            send-id range [ee_info, ee_data]; the number of sends it
+ *            acknowledges is added to *completed (and to *copied when the
+ *            kernel had to fall back to copying).
+ */
+static inline void zc_drain(int fd, long *completed, long *copied)
+{
+    char cbuf[128];
+    struct msghdr mh;
+
+    while (1) {
+        memset(&mh, 0, sizeof(mh));
+        mh.msg_control    = cbuf;
+        mh.msg_controllen = sizeof(cbuf);
+
+        if (recvmsg(fd, &mh, MSG_ERRQUEUE | MSG_DONTWAIT) < 0)
+            break;   /* EAGAIN / no more notifications */
+
+        for (struct cmsghdr *cm = CMSG_FIRSTHDR(&mh); cm;
+             cm = CMSG_NXTHDR(&mh, cm)) {
+            struct sock_extended_err *ee =
+                (struct sock_extended_err *)CMSG_DATA(cm);
+            if (ee->ee_errno != 0 || ee->ee_origin != SO_EE_ORIGIN_ZEROCOPY)
+                continue;
+            long n = (long)(ee->ee_data - ee->ee_info) + 1;
+            trace_event(TR_ZC_DONE, ee->ee_info, (uint64_t)ee->ee_data |
+                        ((uint64_t)!!(ee->ee_code & SO_EE_CODE_ZEROCOPY_COPIED)
+                         << 63));
+            if (completed) *completed += n;
+            if (copied && (ee->ee_code & SO_EE_CODE_ZEROCOPY_COPIED))
+                *copied += n;
+        }
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/*  sendmsg() that survives partial writes                             */
+/* ------------------------------------------------------------------ */
+
+static inline ssize_t sendmsg_all(int fd, const struct iovec *src, int iovcnt,
+                                  int flags, sender_t *s)
+{
+    struct iovec iov[NUM_FIELDS];
+    size_t total = 0;
+    for (int i = 0; i < iovcnt; i++) {
+        iov[i]  = src[i];
+        total  += src[i].iov_len;
+    }
+
+    struct msghdr mh;
+    memset(&mh, 0, sizeof(mh));
+    mh.msg_iov    = iov;
+    mh.msg_iovlen = iovcnt;
+
+    size_t sent = 0;
+    while (sent < total) {
+        ssize_t n = sendmsg(fd, &mh, flags);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == ENOBUFS && (flags & MSG_ZEROCOPY)) {
+                /* Back-pressure: too many pinned pages outstanding */
+                trace_event(TR_ENOBUFS, (uint32_t)s->sends, 0);
+                zc_drain(fd, &s->zc_completed, &s->zc_copied);
+                usleep(100);
+                continue;
+            }
+            return -1;
+        }
+        if (n == 0) return 0;
+        s->sends++;
+        sent += (size_t)n;
+
+        /* Skip the iovec entries that went out completely */
+        size_t adv = (size_t)n;
+        while (mh.msg_iovlen > 0 && adv >= mh.msg_iov->iov_len) {
+            adv -= mh.msg_iov->iov_len;
+            mh.msg_iov++;
+            mh.msg_iovlen--;
+        }
+        if (mh.msg_iovlen > 0) {
+            mh.msg_iov->iov_base = (char *)mh.msg_iov->iov_base + adv;
+            mh.msg_iov->iov_len -= adv;
+        }
+    }
+    return (ssize_t)sent;
+}
+
+/* ------------------------------------------------------------------ */
+/*  sendfile() of one whole message                                    */
+/* ------------------------------------------------------------------ */
+
+static inline ssize_t sendfile_all(int fd, int file_fd, size_t len)
+{
+    off_t off = 0;
+    while ((size_t)off < len) {
+        ssize_t n = sendfile(fd, file_fd, &off, len - (size_t)off);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        if (n == 0) return 0;
+    }
+    return (ssize_t)len;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Sender lifecycle                                                   */
+/* ------------------------------------------------------------------ */
+
+/**
+ * sender_init – builds the message for `msg_size` and prepares `fd`
+ *               for `strategy`.  Returns 0 on success, -1 on failure.
+ */
+static inline int sender_init(sender_t *s, int fd, int strategy, int msg_size)
+{
+    memset(s, 0, sizeof(*s));
+    s->fd       = fd;
+    s->file_fd  = -1;
+    s->strategy = strategy;
+
+    s->msg = create_message(msg_size);
+    if (!s->msg) return -1;
+    s->msg_len = s->msg->field_len * NUM_FIELDS;
+
+    for (int i = 0; i < NUM_FIELDS; i++) {
+        s->iov[i].iov_base = s->msg->fields[i];
+        s->iov[i].iov_len  = s->msg->field_len;
+    }
+
+    if (strategy == STRAT_TWO_COPY || strategy == STRAT_SENDFILE) {
+        int len = 0;
+        s->flat = serialize_message(s->msg, &len);
+        if (!s->flat) { free_message(s->msg); s->msg = NULL; return -1; }
+    }
+
+    if (strategy == STRAT_SENDFILE) {
+        s->file_fd = memfd_create("pa02_sendfile", MFD_CLOEXEC);
+        if (s->file_fd < 0 ||
+            write(s->file_fd, s->flat, s->msg_len) != s->msg_len) {
+            perror("memfd for sendfile");
+            if (s->file_fd >= 0) close(s->file_fd);
+            free(s->flat);
+            free_message(s->msg);
+            s->file_fd = -1;
+            s->flat    = NULL;
+            s->msg     = NULL;
+            return -1;
+        }
+    } else if (strategy == STRAT_ZERO_COPY) {
+        int one = 1;
+        if (setsockopt(fd, SOL_SOCKET, SO_ZEROCOPY, &one, sizeof(one)) < 0)
+            perror("setsockopt SO_ZEROCOPY");
+    }
+    return 0;
+}
+
+static inline ssize_t sender_send_one(sender_t *s)
+{
+    switch (s->strategy) {
+    case STRAT_TWO_COPY:
+        return send_all(s->fd, s->flat, s->msg_len, 0);
+    case STRAT_ONE_COPY:
+        return sendmsg_all(s->fd, s->iov, NUM_FIELDS, 0, s);
+    case STRAT_ZERO_COPY: {
+        ssize_t n = sendmsg_all(s->fd, s->iov, NUM_FIELDS, MSG_ZEROCOPY, s);
+        /* Per message: a partial send bumps `sends` more than once */
+        if (++s->zc_msgs % ZC_DRAIN_INTERVAL == 0)
+            zc_drain(s->fd, &s->zc_completed, &s->zc_copied);
+        return n;
+    }
+    case STRAT_SENDFILE:
+        return sendfile_all(s->fd, s->file_fd, (size_t)s->msg_len);
+    }
+    errno = EINVAL;
+    return -1;
+}
+
+/* Sends one complete message.  Returns bytes sent, 0 on EOF, -1 on error. */
+static inline ssize_t sender_send(sender_t *s)
+{
+    trace_event(TR_SEND_BEGIN, (uint32_t)s->msg_len, 0);
+    ssize_t n = sender_send_one(s);
+    trace_event(TR_SEND_END, (uint32_t)n, n < 0 ? (uint64_t)errno : 0);
+    return n;
+}
+
+static inline void sender_free(sender_t *s)
+{
+    if (s->strategy == STRAT_ZERO_COPY)
+        zc_drain(s->fd, &s->zc_completed, &s->zc_copied);
+    if (s->file_fd >= 0) close(s->file_fd);
+    free(s->flat);
+    free_message(s->msg);
+    s->file_fd = -1;
+    s->flat    = NULL;
+    s->msg     = NULL;
+}
+
+#endif /* MT25042_PART_A_STRATEGY_H */
@@ -0,0 +1,113 @@
+/**
+ * MT25042_Part_A_Stripe.h
+ * Graduate Systems (CSE638) - PA02: Analysis of Network I/O primitives
+ *
+ * Wire format shared by a7_server and a7_client (striped streams):
+ *   - stripe_hello_t: first thing the client sends on each of the K
+ *     connections, so the server can group them into one session
+ *   - stripe_hdr_t  : precedes every message; the sequence number is
+ *     global to the session, not to the connection
+ * All fields are in network byte order on the wire.
+ *
+ * AI Declaration: This code structure was generated with AI assistance.
+ */
+
+#ifndef MT25042_PART_A_STRIPE_H
+#define MT25042_PART_A_STRIPE_H
+
+#include "MT25042_Part_A_Common.h"
+#include "MT25042_Part_A_Placement.h"
+#include <endian.h>
+#include <sys/uio.h>
+
+#define STRIPE_MAX         64          /* connections per session      */
+#define STRIPE_MAGIC       0x53545250u /* "STRP"                       */
+
+typedef struct {
+    uint32_t magic;
+    uint32_t session;                  /* random id chosen by client   */
+    uint32_t stripe;                   /* 0 .. streams-1               */
+    uint32_t streams;
+    uint32_t msg_size;
+} stripe_hello_t;
+
+typedef struct {
+    uint64_t seq;
+    uint32_t len;                      /* payload bytes that follow    */
+    uint32_t stripe;
+} stripe_hdr_t;
+
+static inline void stripe_hello_pack(stripe_hello_t *h, uint32_t session,
+                                     uint32_t stripe, uint32_t streams,
+                                     uint32_t msg_size)
+{
+    h->magic    = htonl(STRIPE_MAGIC);
+    h->session  = htonl(session);
+    h->stripe   = htonl(stripe);
+    h->streams  = htonl(streams);
+    h->msg_size = htonl(msg_size);
+}
+
+/* Converts in place; returns -1 if the hello is malformed or asks for
+ * messages larger than MAX_MSG_SIZE */
+static inline int stripe_hello_unpack(stripe_hello_t *h)
+{
+    h->magic    = ntohl(h->magic);
+    h->session  = ntohl(h->session);
+    h->stripe   = ntohl(h->stripe);
+    h->streams  = ntohl(h->streams);
+    h->msg_size = ntohl(h->msg_size);
+    if (h->magic != STRIPE_MAGIC || h->streams == 0 ||
+        h->streams > STRIPE_MAX || h->stripe >= h->streams ||
+        h->msg_size < NUM_FIELDS || h->msg_size > MAX_MSG_SIZE)
+        return -1;
+    return 0;
+}
+
+static inline void stripe_hdr_pack(stripe_hdr_t *h, uint64_t seq,
+                                   uint32_t len, int stripe)
+{
+    h->seq    = htobe64(seq);
+    h->len    = htonl(len);
+    h->stripe = htonl((uint32_t)stripe);
+}
+
+static inline void stripe_hdr_unpack(stripe_hdr_t *h)
+{
+    h->seq    = be64toh(h->seq);
+    h->len    = ntohl(h->len);
+    h->stripe = ntohl(h->stripe);
+}
+
+/* ------------------------------------------------------------------ */
+/*  Helpers                                                            */
+/* ------------------------------------------------------------------ */
+
+/* sendmsg() until every iovec is written; returns 0 or -1 */
+static inline int sendv_all(int fd, struct iovec *iov, int iovcnt)
+{
+    struct msghdr mh = { .msg_iov = iov, .msg_iovlen = (size_t)iovcnt };
+
+    while (mh.msg_iovlen > 0) {
+        ssize_t n = sendmsg(fd, &mh, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        /* Skip what was written, possibly part of one iovec */
+        while (n > 0 && mh.msg_iovlen > 0) {
+            if ((size_t)n >= mh.msg_iov->iov_len) {
+                n -= (ssize_t)mh.msg_iov->iov_len;
+                mh.msg_iov++;
+                mh.msg_iovlen--;
+            } else {
+                mh.msg_iov->iov_base = (char *)mh.msg_iov->iov_base + n;
+                mh.msg_iov->iov_len -= (size_t)n;
+                n = 0;
+            }
+        }
+    }
+    return 0;
+}
+
+#endif /* MT25042_PART_A_STRIPE_H */
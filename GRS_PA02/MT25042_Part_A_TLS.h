@@ -0,0 +1,305 @@
+/**
+ * MT25042_Part_A_TLS.h
+ * Graduate Systems (CSE638) - PA02: Analysis of Network I/O primitives
+ *
+ * Encryption on the data path, in two flavours:
+ *   - ktls : kernel TLS.  The TLS ULP is attached to the connected socket
+ *            and static AES-128-GCM keys are installed with TLS_TX /
+ *            TLS_RX, so no handshake is needed.  After that the normal
+ *            send()/sendmsg()/sendfile() paths produce TLS 1.2 records.
+ *   - user : user-space baseline.  Each message is encrypted with OpenSSL
+ *            into TLS-1.2-shaped records (5-byte header, 8-byte explicit
+ *            nonce, ciphertext, 16-byte tag) and then sent with send().
+ *
+ * Both directions use separate static keys (server->client and
+ * client->server).  These keys are test material only.
+ *
+ * AI Declaration: Asked ChatGPT "Which setsockopt calls enable kernel TLS
+ *   with a pre-shared AES-GCM key?"; record layout follows RFC 5288.
+ */
+
+#ifndef MT25042_PART_A_TLS_H
+#define MT25042_PART_A_TLS_H
+
+#include "MT25042_Part_A_Common.h"
+#include <stdint.h>
+#include <sys/uio.h>
+#include <linux/tls.h>
+#include <openssl/evp.h>
+
+/* ------------------------------------------------------------------ */
+/*  Modes                                                              */
+/* ------------------------------------------------------------------ */
+
+typedef enum {
+    TLS_MODE_NONE = 0,
+    TLS_MODE_KTLS,
+    TLS_MODE_USER,
+    TLS_MODE_COUNT
+} tls_mode_t;
+
+static const char *const tls_mode_names[TLS_MODE_COUNT] = {
+    "none", "ktls", "user"
+};
+
+static inline int tls_mode_from_name(const char *name)
+{
+    for (int i = 0; i < TLS_MODE_COUNT; i++)
+        if (strcmp(name, tls_mode_names[i]) == 0) return i;
+    return -1;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Static test key material (AES-128-GCM)                             */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+    unsigned char key[TLS_CIPHER_AES_GCM_128_KEY_SIZE];
+    unsigned char salt[TLS_CIPHER_AES_GCM_128_SALT_SIZE];
+    unsigned char iv[TLS_CIPHER_AES_GCM_128_IV_SIZE];
+} tls_key_t;
+
+static const tls_key_t tls_key_s2c = {
+    .key  = { 0x6d, 0x74, 0x32, 0x35, 0x30, 0x34, 0x32, 0x2d,
+              0x73, 0x32, 0x63, 0x2d, 0x6b, 0x65, 0x79, 0x01 },
+    .salt = { 0x53, 0x32, 0x43, 0x00 },
+    .iv   = { 0, 0, 0, 0, 0, 0, 0, 1 },
+};
+
+static const tls_key_t tls_key_c2s = {
+    .key  = { 0x6d, 0x74, 0x32, 0x35, 0x30, 0x34, 0x32, 0x2d,
+              0x63, 0x32, 0x73, 0x2d, 0x6b, 0x65, 0x79, 0x02 },
+    .salt = { 0x43, 0x32, 0x53, 0x00 },
+    .iv   = { 0, 0, 0, 0, 0, 0, 0, 2 },
+};
+
+/* ------------------------------------------------------------------ */
+/*  Kernel TLS                                                         */
+/* ------------------------------------------------------------------ */
+
+static inline void ktls_fill(struct tls12_crypto_info_aes_gcm_128 *ci,
+                             const tls_key_t *k)
+{
+    memset(ci, 0, sizeof(*ci));
+    ci->info.version     = TLS_1_2_VERSION;
+    ci->info.cipher_type = TLS_CIPHER_AES_GCM_128;
+    memcpy(ci->key,  k->key,  sizeof(ci->key));
+    memcpy(ci->salt, k->salt, sizeof(ci->salt));
+    memcpy(ci->iv,   k->iv,   sizeof(ci->iv));
+    /* rec_seq starts at 0 on both ends */
+}
+
+/**
+ * ktls_install – attaches the TLS ULP to a connected socket and installs
+ *                TX and RX keys for the given side.  With `zerocopy_ro`
+ *                also asks for TLS_TX_ZEROCOPY_RO (sendfile only; the
+ *                kernel may ignore it without device offload).
+ *                Returns 0 on success, -1 if kTLS is unavailable.
+ */
+static inline int ktls_install(int fd, int is_server, int zerocopy_ro)
+{
+    if (setsockopt(fd, IPPROTO_TCP, TCP_ULP, "tls", sizeof("tls")) < 0) {
+        perror("setsockopt TCP_ULP tls (is the tls module loaded?)");
+        return -1;
+    }
+
+    struct tls12_crypto_info_aes_gcm_128 tx, rx;
+    ktls_fill(&tx, is_server ? &tls_key_s2c : &tls_key_c2s);
+    ktls_fill(&rx, is_server ? &tls_key_c2s : &tls_key_s2c);
+
+    if (setsockopt(fd, SOL_TLS, TLS_TX, &tx, sizeof(tx)) < 0) {
+        perror("setsockopt TLS_TX");
+        return -1;
+    }
+    if (setsockopt(fd, SOL_TLS, TLS_RX, &rx, sizeof(rx)) < 0) {
+        perror("setsockopt TLS_RX");
+        return -1;
+    }
+
+    if (zerocopy_ro) {
+        int one = 1;
+        if (setsockopt(fd, SOL_TLS, TLS_TX_ZEROCOPY_RO, &one, sizeof(one)) < 0)
+            perror("setsockopt TLS_TX_ZEROCOPY_RO (continuing without)");
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------ */
+/*  User-space TLS-shaped records                                      */
+/* ------------------------------------------------------------------ */
+
+#define UTLS_HDR_LEN       5
+#define UTLS_NONCE_LEN     8
+#define UTLS_TAG_LEN       16
+#define UTLS_OVERHEAD      (UTLS_HDR_LEN + UTLS_NONCE_LEN + UTLS_TAG_LEN)
+#define UTLS_MAX_PLAIN     16384       /* TLS maximum fragment length */
+#define UTLS_TYPE_APPDATA  23
+
+typedef struct {
+    EVP_CIPHER_CTX  *ctx;
+    const tls_key_t *key;
+    uint64_t         seq;              /* record sequence number      */
+    unsigned char   *rec;              /* one message worth of records */
+    size_t           rec_cap;
+} utls_t;
+
+/* Wire size of one message of `len` plaintext bytes */
+static inline size_t utls_wire_len(size_t len)
+{
+    size_t records = (len + UTLS_MAX_PLAIN - 1) / UTLS_MAX_PLAIN;
+    return len + records * UTLS_OVERHEAD;
+}
+
+static inline int utls_init(utls_t *u, const tls_key_t *key, size_t max_msg)
+{
+    memset(u, 0, sizeof(*u));
+    u->key     = key;
+    u->ctx     = EVP_CIPHER_CTX_new();
+    u->rec_cap = utls_wire_len(max_msg);
+    u->rec     = (unsigned char *)malloc(u->rec_cap);
+    if (!u->ctx || !u->rec) {
+        fprintf(stderr, "utls_init: out of memory\n");
+        EVP_CIPHER_CTX_free(u->ctx);
+        free(u->rec);
+        return -1;
+    }
+    return 0;
+}
+
+static inline void utls_free(utls_t *u)
+{
+    EVP_CIPHER_CTX_free(u->ctx);
+    free(u->rec);
+    u->ctx = NULL;
+    u->rec = NULL;
+}
+
+/* nonce = salt(4) || seq(8, big endian); AAD = seq || type || ver || len */
+static inline void utls_nonce_aad(const utls_t *u, uint16_t len,
+                                  unsigned char nonce[12],
+                                  unsigned char aad[13])
+{
+    memcpy(nonce, u->key->salt, 4);
+    for (int i = 0; i < 8; i++) {
+        unsigned char b = (unsigned char)(u->seq >> (56 - 8 * i));
+        nonce[4 + i] = b;
+        aad[i]       = b;
+    }
+    aad[8]  = UTLS_TYPE_APPDATA;
+    aad[9]  = 0x03;
+    aad[10] = 0x03;
+    aad[11] = (unsigned char)(len >> 8);
+    aad[12] = (unsigned char)len;
+}
+
+/**
+ * utls_send_iov – encrypts the message described by `iov` straight from
+ *                 the heap fields into records (encryption doubles as the
+ *                 serialization copy) and sends them with send_all().
+ *                 Returns the plaintext bytes sent, or <= 0 on error.
+ */
+static inline ssize_t utls_send_iov(utls_t *u, int fd,
+                                    const struct iovec *iov, int iovcnt)
+{
+    size_t total = 0;
+    for (int i = 0; i < iovcnt; i++) total += iov[i].iov_len;
+    if (utls_wire_len(total) > u->rec_cap) { errno = EMSGSIZE; return -1; }
+
+    unsigned char *out = u->rec;
+    int    vi = 0;
+    size_t vo = 0;                       /* offset inside iov[vi]      */
+    size_t left = total;
+
+    while (left > 0) {
+        uint16_t plen = (uint16_t)(left < UTLS_MAX_PLAIN ? left : UTLS_MAX_PLAIN);
+        unsigned char nonce[12], aad[13];
+        utls_nonce_aad(u, plen, nonce, aad);
+
+        uint16_t body = plen + UTLS_NONCE_LEN + UTLS_TAG_LEN;
+        out[0] = UTLS_TYPE_APPDATA;
+        out[1] = 0x03;
+        out[2] = 0x03;
+        out[3] = (unsigned char)(body >> 8);
+        out[4] = (unsigned char)body;
+        memcpy(out + UTLS_HDR_LEN, nonce + 4, UTLS_NONCE_LEN);
+
+        unsigned char *ct = out + UTLS_HDR_LEN + UTLS_NONCE_LEN;
+        int outl = 0;
+        EVP_EncryptInit_ex(u->ctx, EVP_aes_128_gcm(), NULL, u->key->key, nonce);
+        EVP_EncryptUpdate(u->ctx, NULL, &outl, aad, sizeof(aad));
+
+        size_t need = plen;
+        while (need > 0) {
+            size_t chunk = iov[vi].iov_len - vo;
+            if (chunk > need) chunk = need;
+            EVP_EncryptUpdate(u->ctx, ct, &outl,
+                              (const unsigned char *)iov[vi].iov_base + vo,
+                              (int)chunk);
+            ct   += outl;
+            need -= chunk;
+            vo   += chunk;
+            if (vo == iov[vi].iov_len) { vi++; vo = 0; }
+        }
+        EVP_EncryptFinal_ex(u->ctx, ct, &outl);
+        EVP_CIPHER_CTX_ctrl(u->ctx, EVP_CTRL_GCM_GET_TAG, UTLS_TAG_LEN,
+                            ct + outl);
+
+        out  += UTLS_HDR_LEN + body;
+        left -= plen;
+        u->seq++;
+    }
+
+    ssize_t n = send_all(fd, u->rec, (size_t)(out - u->rec), 0);
+    return (n <= 0) ? n : (ssize_t)total;
+}
+
+/**
+ * utls_recv – receives and decrypts records until exactly `len` plaintext
+ *             bytes are in `buf` (the sender never lets a record span two
+ *             messages).  Returns `len`, 0 on EOF, -1 on error/bad tag.
+ */
+static inline ssize_t utls_recv(utls_t *u, int fd, void *buf, size_t len)
+{
+    size_t got = 0;
+    while (got < len) {
+        unsigned char *hdr = u->rec;
+        ssize_t n = recv_all(fd, hdr, UTLS_HDR_LEN + UTLS_NONCE_LEN, 0);
+        if (n <= 0) return n;
+
+        size_t body = ((size_t)hdr[3] << 8) | hdr[4];
+        if (body < UTLS_NONCE_LEN + UTLS_TAG_LEN ||
+            UTLS_HDR_LEN + body > u->rec_cap) {
+            errno = EPROTO;
+            return -1;
+        }
+        size_t plen = body - UTLS_NONCE_LEN - UTLS_TAG_LEN;
+        if (got + plen > len) { errno = EPROTO; return -1; }
+
+        unsigned char *ct = u->rec + UTLS_HDR_LEN + UTLS_NONCE_LEN;
+        n = recv_all(fd, ct, plen + UTLS_TAG_LEN, 0);
+        if (n <= 0) return n;
+
+        unsigned char nonce[12], aad[13];
+        utls_nonce_aad(u, (uint16_t)plen, nonce, aad);
+
+        int outl = 0;
+        EVP_DecryptInit_ex(u->ctx, EVP_aes_128_gcm(), NULL, u->key->key, nonce);
+        EVP_DecryptUpdate(u->ctx, NULL, &outl, aad, sizeof(aad));
+        EVP_DecryptUpdate(u->ctx, (unsigned char *)buf + got, &outl,
+                          ct, (int)plen);
+        EVP_CIPHER_CTX_ctrl(u->ctx, EVP_CTRL_GCM_SET_TAG, UTLS_TAG_LEN,
+                            ct + plen);
+        if (EVP_DecryptFinal_ex(u->ctx, (unsigned char *)buf + got + outl,
+                                &outl) <= 0) {
+            fprintf(stderr, "utls_recv: authentication failed\n");
+            errno = EBADMSG;
+            return -1;
+        }
+
+        got += plen;
+        u->seq++;
+    }
+    return (ssize_t)len;
+}
+
+#endif /* MT25042_PART_A_TLS_H */
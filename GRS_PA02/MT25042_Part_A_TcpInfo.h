@@ -0,0 +1,193 @@
+/**
+ * MT25042_Part_A_TcpInfo.h
+ * Graduate Systems (CSE638) - PA02: Analysis of Network I/O primitives
+ *
+ * Opt-in TCP_INFO time series:
+ *   Set PA02_TCPINFO=<prefix> (and optionally PA02_TCPINFO_MS, default
+ *   100) and a sampler thread reads getsockopt(TCP_INFO) for every
+ *   connection registered with tcpinfo_add(), writing one row per
+ *   connection per interval to <prefix>.<role>.<pid>.csv.  Rows carry
+ *   CLOCK_MONOTONIC time and both ports, so server and client files of
+ *   the same run can be joined.
+ *
+ *   busy/rwnd_limited/sndbuf_limited are the kernel's cumulative
+ *   microsecond counters: the slope over an interval tells what limited
+ *   the sender in that interval.
+ *
+ *   Connections need no unregistering: an entry is dropped as soon as
+ *   its fd no longer refers to the same socket (closed or reused).
+ *
+ * AI Declaration: This code structure was generated with AI assistance;
+ *   struct layout copied from <linux/tcp.h>, which cannot be included
+ *   next to <netinet/tcp.h>.
+ */
+
+#ifndef MT25042_PART_A_TCPINFO_H
+#define MT25042_PART_A_TCPINFO_H
+
+#include "MT25042_Part_A_Common.h"
+
+#define TCPINFO_MAX_CONNS   256
+#define TCPINFO_DEFAULT_MS  100
+
+/* struct tcp_info from <linux/tcp.h> (glibc's copy stops at total_retrans) */
+typedef struct {
+    uint8_t  state, ca_state, retransmits, probes, backoff, options;
+    uint8_t  wscale;
+    uint8_t  app_limited;              /* bit 0: delivery_rate_app_limited */
+    uint32_t rto, ato, snd_mss, rcv_mss;
+    uint32_t unacked, sacked, lost, retrans, fackets;
+    uint32_t last_data_sent, last_ack_sent, last_data_recv, last_ack_recv;
+    uint32_t pmtu, rcv_ssthresh, rtt, rttvar, snd_ssthresh, snd_cwnd;
+    uint32_t advmss, reordering, rcv_rtt, rcv_space, total_retrans;
+    uint64_t pacing_rate, max_pacing_rate, bytes_acked, bytes_received;
+    uint32_t segs_out, segs_in, notsent_bytes, min_rtt;
+    uint32_t data_segs_in, data_segs_out;
+    uint64_t delivery_rate;
+    uint64_t busy_time, rwnd_limited, sndbuf_limited;
+    uint32_t delivered, delivered_ce;
+    uint64_t bytes_sent, bytes_retrans;
+    uint32_t dsack_dups, reord_seen, rcv_ooopack, snd_wnd;
+} tcpinfo_full_t;
+
+typedef struct {
+    int      fd;
+    uint16_t lport;
+    uint16_t rport;
+} tcpinfo_conn_t;
+
+typedef struct {
+    int              enabled;
+    int              interval_ms;
+    const char      *role;
+    FILE            *out;
+    pthread_mutex_t  lock;
+    tcpinfo_conn_t   conns[TCPINFO_MAX_CONNS];
+    int              n;
+    pthread_t        thread;
+} tcpinfo_state_t;
+
+static tcpinfo_state_t g_tcpinfo = { .lock = PTHREAD_MUTEX_INITIALIZER };
+
+/* Local and peer port of `fd`, or -1 if it is not a connected socket */
+static inline int tcpinfo_ports(int fd, uint16_t *lport, uint16_t *rport)
+{
+    struct sockaddr_in a;
+    socklen_t len = sizeof(a);
+    if (getsockname(fd, (struct sockaddr *)&a, &len) < 0) return -1;
+    *lport = ntohs(a.sin_port);
+    len = sizeof(a);
+    if (getpeername(fd, (struct sockaddr *)&a, &len) < 0) return -1;
+    *rport = ntohs(a.sin_port);
+    return 0;
+}
+
+/* Writes one row per live connection; drops dead ones.  Under lock. */
+static inline void tcpinfo_sample_all(void)
+{
+    double t = mono_ns() / 1e9;
+
+    for (int i = 0; i < g_tcpinfo.n; ) {
+        tcpinfo_conn_t *c = &g_tcpinfo.conns[i];
+        tcpinfo_full_t  ti;
+        socklen_t       len = sizeof(ti);
+        uint16_t        lp, rp;
+
+        memset(&ti, 0, sizeof(ti));
+        if (tcpinfo_ports(c->fd, &lp, &rp) < 0 ||
+            lp != c->lport || rp != c->rport ||
+            getsockopt(c->fd, IPPROTO_TCP, TCP_INFO, &ti, &len) < 0) {
+            g_tcpinfo.conns[i] = g_tcpinfo.conns[--g_tcpinfo.n];
+            continue;
+        }
+
+        fprintf(g_tcpinfo.out,
+                "%.6f,%s,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,"
+                "%llu,%llu,%llu,%llu,%d,%llu,%llu,%u,%u\n",
+                t, g_tcpinfo.role, c->lport, c->rport, ti.state,
+                ti.snd_cwnd, ti.snd_ssthresh, ti.rtt, ti.rttvar, ti.min_rtt,
+                ti.total_retrans, ti.lost, ti.unacked,
+                (unsigned long long)ti.busy_time,
+                (unsigned long long)ti.rwnd_limited,
+                (unsigned long long)ti.sndbuf_limited,
+                (unsigned long long)ti.delivery_rate * 8,
+                ti.app_limited & 1,
+                (unsigned long long)ti.bytes_acked,
+                (unsigned long long)ti.bytes_received,
+                ti.snd_wnd, ti.notsent_bytes);
+        i++;
+    }
+    fflush(g_tcpinfo.out);
+}
+
+static inline void *tcpinfo_thread(void *arg)
+{
+    (void)arg;
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+
+    while (1) {
+        next.tv_nsec += (long)g_tcpinfo.interval_ms * 1000000L;
+        while (next.tv_nsec >= 1000000000L) {
+            next.tv_nsec -= 1000000000L;
+            next.tv_sec++;
+        }
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+
+        pthread_mutex_lock(&g_tcpinfo.lock);
+        tcpinfo_sample_all();
+        pthread_mutex_unlock(&g_tcpinfo.lock);
+    }
+    return NULL;
+}
+
+/**
+ * tcpinfo_init – starts the sampler if PA02_TCPINFO is set.  `role`
+ *                ("server" / "client") goes into the file name and rows.
+ */
+static inline void tcpinfo_init(const char *role)
+{
+    const char *prefix = getenv("PA02_TCPINFO");
+    if (!prefix || !*prefix) return;
+
+    const char *ms = getenv("PA02_TCPINFO_MS");
+    g_tcpinfo.interval_ms = (ms && atoi(ms) > 0) ? atoi(ms)
+                                                 : TCPINFO_DEFAULT_MS;
+    g_tcpinfo.role = role;
+
+    char path[512];
+    snprintf(path, sizeof(path), "%s.%s.%d.csv", prefix, role, (int)getpid());
+    g_tcpinfo.out = fopen(path, "w");
+    if (!g_tcpinfo.out) { perror(path); return; }
+    fprintf(g_tcpinfo.out,
+            "time_s,role,local_port,peer_port,state,cwnd,ssthresh,srtt_us,"
+            "rttvar_us,min_rtt_us,total_retrans,lost,unacked,busy_us,"
+            "rwnd_limited_us,sndbuf_limited_us,delivery_rate_bps,"
+            "app_limited,bytes_acked,bytes_received,snd_wnd,notsent_bytes\n");
+
+    if (pthread_create(&g_tcpinfo.thread, NULL, tcpinfo_thread, NULL) != 0) {
+        perror("pthread_create tcpinfo");
+        fclose(g_tcpinfo.out);
+        return;
+    }
+    pthread_detach(g_tcpinfo.thread);
+    g_tcpinfo.enabled = 1;
+    fprintf(stderr, "[tcpinfo] every %d ms → %s\n", g_tcpinfo.interval_ms,
+            path);
+}
+
+/* Registers a connected socket with the sampler (no-op when disabled) */
+static inline void tcpinfo_add(int fd)
+{
+    if (!g_tcpinfo.enabled) return;
+
+    tcpinfo_conn_t c = { .fd = fd };
+    if (tcpinfo_ports(fd, &c.lport, &c.rport) < 0) return;
+
+    pthread_mutex_lock(&g_tcpinfo.lock);
+    if (g_tcpinfo.n < TCPINFO_MAX_CONNS)
+        g_tcpinfo.conns[g_tcpinfo.n++] = c;
+    pthread_mutex_unlock(&g_tcpinfo.lock);
+}
+
+#endif /* MT25042_PART_A_TCPINFO_H */
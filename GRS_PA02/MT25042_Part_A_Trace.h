@@ -0,0 +1,236 @@
+/**
+ * MT25042_Part_A_Trace.h
+ * Graduate Systems (CSE638) - PA02: Analysis of Network I/O primitives
+ *
+ * Opt-in per-message event trace:
+ *   Set PA02_TRACE=<prefix> in the environment and call trace_init() in
+ *   main().  Every thread that records an event gets its own ring of
+ *   TRACE_DEFAULT_EVENTS 24-byte events (PA02_TRACE_EVENTS to change;
+ *   the oldest are overwritten).  Recording is one TSC read and one
+ *   store into the thread's ring, no locks or syscalls; rings are linked
+ *   into a global list with a CAS when they are created.
+ *
+ *   At exit (or on SIGINT/SIGTERM if the program has no handler of its
+ *   own) every ring is written to <prefix>.<pid>.trace.
+ *   MT25042_Part_D_TraceJson.py turns one or more dumps into Chrome
+ *   trace / Perfetto JSON; dumps of server and client line up because
+ *   timestamps are converted to CLOCK_MONOTONIC.
+ *
+ *   With PA02_TRACE unset trace_event() is a single predictable branch.
+ *
+ * AI Declaration: This code structure was generated with AI assistance.
+ */
+
+#ifndef MT25042_PART_A_TRACE_H
+#define MT25042_PART_A_TRACE_H
+
+#include "MT25042_Part_A_Common.h"
+#include <fcntl.h>
+#include <signal.h>
+#include <stdatomic.h>
+
+#define TRACE_DEFAULT_EVENTS  (1u << 16)   /* per thread, power of two  */
+#define TRACE_MAGIC           "PA2TRC1"
+
+/* Event types; a/b meaning in brackets */
+enum {
+    TR_SEND_BEGIN = 1,                 /* [msg bytes, -]                */
+    TR_SEND_END,                       /* [bytes returned, errno]       */
+    TR_ENOBUFS,                        /* [sends issued, -]             */
+    TR_ZC_DONE,                        /* [first id, last id | copied<<63] */
+    TR_RECV_BEGIN,                     /* [-, -]                        */
+    TR_RECV_END,                       /* [bytes returned, errno]       */
+};
+
+typedef struct {
+    uint64_t ts;                       /* ticks_now()                   */
+    uint32_t type;
+    uint32_t a;
+    uint64_t b;
+} trace_ev_t;
+
+typedef struct trace_ring {
+    struct trace_ring *next;           /* global list                   */
+    uint32_t           tid;
+    uint32_t           mask;
+    _Atomic uint64_t   head;           /* events ever written           */
+    trace_ev_t         ev[];
+} trace_ring_t;
+
+typedef struct {
+    int                     enabled;
+    uint32_t                events;    /* ring size                     */
+    char                    path[256];
+    uint64_t                tick0;     /* tick / CLOCK_MONOTONIC pair   */
+    uint64_t                mono0;
+    _Atomic(trace_ring_t *) rings;
+    atomic_int              dumped;
+} trace_state_t;
+
+/* On-disk layout: file header, then per ring a ring header + events */
+typedef struct {
+    char     magic[8];
+    uint32_t pid;
+    uint32_t nrings;
+    double   ns_per_tick;
+    uint64_t tick0;
+    uint64_t mono0;
+    char     prog[32];
+} trace_file_hdr_t;
+
+typedef struct {
+    uint32_t tid;
+    uint32_t pad;
+    uint64_t count;                    /* events that follow            */
+    uint64_t dropped;                  /* overwritten before the dump   */
+} trace_ring_hdr_t;
+
+static trace_state_t g_trace;
+static __thread trace_ring_t *t_trace_ring;
+
+/* ------------------------------------------------------------------ */
+/*  Recording                                                          */
+/* ------------------------------------------------------------------ */
+
+static inline trace_ring_t *trace_ring_new(void)
+{
+    trace_ring_t *r = (trace_ring_t *)calloc(1, sizeof(trace_ring_t) +
+                                             g_trace.events * sizeof(trace_ev_t));
+    if (!r) { g_trace.enabled = 0; return NULL; }
+    r->tid  = (uint32_t)syscall(SYS_gettid);
+    r->mask = g_trace.events - 1;
+
+    trace_ring_t *head = atomic_load(&g_trace.rings);
+    do {
+        r->next = head;
+    } while (!atomic_compare_exchange_weak(&g_trace.rings, &head, r));
+
+    t_trace_ring = r;
+    return r;
+}
+
+static inline void trace_event(uint32_t type, uint32_t a, uint64_t b)
+{
+    if (__builtin_expect(!g_trace.enabled, 1)) return;
+
+    trace_ring_t *r = t_trace_ring;
+    if (!r && !(r = trace_ring_new())) return;
+
+    /* Single writer per ring: a plain read of head is enough */
+    uint64_t    h = atomic_load_explicit(&r->head, memory_order_relaxed);
+    trace_ev_t *e = &r->ev[h & r->mask];
+    e->ts   = ticks_now();
+    e->type = type;
+    e->a    = a;
+    e->b    = b;
+    atomic_store_explicit(&r->head, h + 1, memory_order_release);
+}
+
+/* ------------------------------------------------------------------ */
+/*  Dump                                                               */
+/* ------------------------------------------------------------------ */
+
+/* Only open/write/close: also called from the signal handler */
+static inline int trace_write(int fd, const void *p, size_t len)
+{
+    const char *c = (const char *)p;
+    while (len > 0) {
+        ssize_t n = write(fd, c, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        c   += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+static inline void trace_dump(void)
+{
+    if (!g_trace.enabled || atomic_exchange(&g_trace.dumped, 1)) return;
+
+    int fd = open(g_trace.path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) return;
+
+    trace_file_hdr_t fh;
+    memset(&fh, 0, sizeof(fh));
+    memcpy(fh.magic, TRACE_MAGIC, sizeof(TRACE_MAGIC));
+    fh.pid         = (uint32_t)getpid();
+    fh.ns_per_tick = g_ticks.ns_per_tick;
+    fh.tick0       = g_trace.tick0;
+    fh.mono0       = g_trace.mono0;
+    for (trace_ring_t *r = atomic_load(&g_trace.rings); r; r = r->next)
+        fh.nrings++;
+    extern char *program_invocation_short_name;
+    strncpy(fh.prog, program_invocation_short_name, sizeof(fh.prog) - 1);
+    trace_write(fd, &fh, sizeof(fh));
+
+    for (trace_ring_t *r = atomic_load(&g_trace.rings); r; r = r->next) {
+        uint64_t head  = atomic_load_explicit(&r->head, memory_order_acquire);
+        uint64_t size  = (uint64_t)r->mask + 1;
+        uint64_t first = head > size ? head - size : 0;
+
+        trace_ring_hdr_t rh = {
+            .tid = r->tid, .count = head - first, .dropped = first
+        };
+        trace_write(fd, &rh, sizeof(rh));
+
+        /* Oldest first: the tail of the array, then the start */
+        uint64_t start = first & r->mask;
+        if (head > size) {
+            trace_write(fd, &r->ev[start], (size - start) * sizeof(trace_ev_t));
+            trace_write(fd, r->ev, start * sizeof(trace_ev_t));
+        } else {
+            trace_write(fd, r->ev, head * sizeof(trace_ev_t));
+        }
+    }
+    close(fd);
+}
+
+static inline void trace_on_signal(int sig)
+{
+    trace_dump();
+    signal(sig, SIG_DFL);
+    raise(sig);
+}
+
+/**
+ * trace_init – enables tracing if PA02_TRACE is set.  Call once from
+ *              main() before the worker threads start.
+ */
+static inline void trace_init(void)
+{
+    const char *prefix = getenv("PA02_TRACE");
+    if (!prefix || !*prefix) return;
+
+    timing_init();
+
+    uint32_t events = TRACE_DEFAULT_EVENTS;
+    const char *e = getenv("PA02_TRACE_EVENTS");
+    if (e && atol(e) > 0) {
+        events = 1;
+        while (events < (uint32_t)atol(e) && events < (1u << 30)) events <<= 1;
+    }
+
+    g_trace.events = events;
+    g_trace.tick0  = ticks_now();
+    g_trace.mono0  = mono_ns();
+    snprintf(g_trace.path, sizeof(g_trace.path), "%s.%d.trace",
+             prefix, (int)getpid());
+    g_trace.enabled = 1;
+
+    atexit(trace_dump);
+
+    /* Servers usually end with Ctrl-C; keep any handler they install */
+    int sigs[2] = { SIGINT, SIGTERM };
+    for (int i = 0; i < 2; i++) {
+        struct sigaction old;
+        if (sigaction(sigs[i], NULL, &old) == 0 && old.sa_handler == SIG_DFL)
+            signal(sigs[i], trace_on_signal);
+    }
+
+    fprintf(stderr, "[trace] %u events/thread → %s\n", events, g_trace.path);
+}
+
+#endif /* MT25042_PART_A_TRACE_H */
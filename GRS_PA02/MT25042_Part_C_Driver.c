@@ -0,0 +1,804 @@
+/**
+ * MT25042_Part_C_Driver.c
+ * Graduate Systems (CSE638) - PA02: Analysis of Network I/O primitives
+ *
+ * Native benchmark driver (alternative to MT25042_Part_C_Experiment.sh):
+ *   - launches one a4_server and reconfigures it over the control port
+ *     for every (implementation, msg_size, threads) point
+ *   - runs a4_client N times per point, each with an unmeasured
+ *     warm-up phase
+ *   - counts cycles, L1/LLC misses and context switches of every client
+ *     run with perf_event_open(), enabled only after the warm-up
+ *   - writes mean, standard deviation and 95% confidence interval of
+ *     every metric to the results CSV (one row per point)
+ *   - appends every repetition, tagged with a run id, the git revision,
+ *     kernel, CPU model and configuration, to a persistent history CSV
+ *     that MT25042_Part_D_Compare.py checks for regressions
+ *   - with -I, has server and clients sample TCP_INFO per connection
+ *     into <results>_tcpinfo*.csv files (see MT25042_Part_A_TcpInfo.h)
+ *   - with -A, pins server handlers and client threads with a placement
+ *     policy (MT25042_Part_A_Placement.h); the policy is part of the
+ *     configuration stored in the history
+ *   - with -P / -K, runs the clients in busy-poll receive mode
+ *     (MT25042_Part_A_BusyPoll.h)
+ *
+ * Runs on loopback by default.  With -n it uses the ns_server/ns_client
+ * namespaces created by the experiment script (requires root).
+ *
+ * Usage: ./c_driver [-i impls] [-m sizes] [-t threads] [-r reps]
+ *                   [-w warmup_sec] [-d duration_sec] [-T tls]
+ *                   [-Z] [-B batch] [-D direction] [-x rx_mode] [-n]
+ *                   [-o results.csv] [-R raw.csv] [-H history.csv]
+ *                   [-I tcpinfo_ms] [-A placement] [-P spin_us]
+ *                   [-K busy_poll_us]
+ *
+ * AI Declaration: This code structure was generated with AI assistance;
+ *   the Student-t table values are the standard two-sided 95% quantiles.
+ */
+
+#define _GNU_SOURCE
+#include "MT25042_Part_A_Control.h"
+#include <fcntl.h>
+#include <math.h>
+#include <sched.h>
+#include <signal.h>
+#include <libgen.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <sys/utsname.h>
+#include <sys/wait.h>
+#include <linux/perf_event.h>
+
+/* ------------------------------------------------------------------ */
+/*  Constants                                                          */
+/* ------------------------------------------------------------------ */
+
+#define MAX_LIST           16          /* entries per -i/-m/-t list    */
+#define MAX_REPS           100
+#define NS_SERVER          "ns_server"
+#define NS_CLIENT          "ns_client"
+#define NS_SERVER_IP       "10.0.0.1"
+#define LOOPBACK_IP        "127.0.0.1"
+#define SERVER_START_MS    5000        /* wait for the control port    */
+#define HISTORY_CSV        "MT25042_Part_B_History.csv"
+
+/* ------------------------------------------------------------------ */
+/*  Metrics                                                            */
+/* ------------------------------------------------------------------ */
+
+enum {
+    M_THROUGHPUT, M_LATENCY,                       /* from RESULT line  */
+    M_CYCLES, M_L1_MISS, M_LLC_MISS, M_CTX_SW,     /* from perf events  */
+    M_COUNT
+};
+
+#define PERF_FIRST  M_CYCLES
+#define PERF_COUNT  (M_COUNT - M_CYCLES)
+
+static const char *const metric_names[M_COUNT] = {
+    "throughput_gbps", "latency_us", "cpu_cycles",
+    "l1_cache_misses", "llc_cache_misses", "context_switches"
+};
+
+#define HW_CACHE_READ_MISS(c) \
+    ((c) | (PERF_COUNT_HW_CACHE_OP_READ << 8) | \
+     (PERF_COUNT_HW_CACHE_RESULT_MISS << 16))
+
+static const struct { __u32 type; __u64 config; } perf_events[PERF_COUNT] = {
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+    { PERF_TYPE_HW_CACHE, HW_CACHE_READ_MISS(PERF_COUNT_HW_CACHE_L1D) },
+    { PERF_TYPE_HW_CACHE, HW_CACHE_READ_MISS(PERF_COUNT_HW_CACHE_LL) },
+    { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES },
+};
+
+/* ------------------------------------------------------------------ */
+/*  Configuration                                                      */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+    int         impls[MAX_LIST];   int n_impls;
+    int         sizes[MAX_LIST];   int n_sizes;
+    int         threads[MAX_LIST]; int n_threads;
+    int         reps;
+    int         warmup;
+    int         duration;
+    int         tls;
+    int         compress;
+    int         batch;
+    int         direction;
+    int         rx_mode;
+    int         use_netns;
+    int         tcpinfo_ms;            /* 0 = no TCP_INFO sampling     */
+    char        tcpinfo_prefix[512];
+    const char *placement;             /* PA02_PLACEMENT, NULL = none  */
+    const char *spin_us;               /* a4_client -P, NULL = blocking */
+    const char *kpoll_us;              /* a4_client -K                  */
+    const char *out_csv;
+    const char *raw_csv;
+    const char *history_csv;           /* "-" disables the history     */
+    char        bin_dir[512];
+} driver_config_t;
+
+/* ------------------------------------------------------------------ */
+/*  Statistics                                                         */
+/* ------------------------------------------------------------------ */
+
+/* Two-sided 95% Student-t quantiles for 1..30 degrees of freedom */
+static const double t95[30] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+     2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+     2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+};
+
+/**
+ * summarize – sample mean, sample standard deviation and the half-width
+ *             of the 95% confidence interval of the mean.
+ */
+static void summarize(const double *x, int n,
+                      double *mean, double *sd, double *ci95)
+{
+    double sum = 0, sq = 0;
+    for (int i = 0; i < n; i++) sum += x[i];
+    *mean = (n > 0) ? sum / n : 0;
+
+    for (int i = 0; i < n; i++) sq += (x[i] - *mean) * (x[i] - *mean);
+    *sd = (n > 1) ? sqrt(sq / (n - 1)) : 0;
+
+    double t = (n - 1 > 30) ? 1.960 : (n > 1 ? t95[n - 2] : 0);
+    *ci95 = (n > 1) ? t * *sd / sqrt((double)n) : 0;
+}
+
+/* ------------------------------------------------------------------ */
+/*  perf_event_open helpers                                            */
+/* ------------------------------------------------------------------ */
+
+static int perf_open(pid_t pid, __u32 type, __u64 config)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size     = sizeof(attr);
+    attr.type     = type;
+    attr.config   = config;
+    attr.disabled = 1;
+    attr.inherit  = 1;                 /* follow every client thread */
+
+    return (int)syscall(SYS_perf_event_open, &attr, pid, -1, -1,
+                        PERF_FLAG_FD_CLOEXEC);
+}
+
+static double perf_read(int fd)
+{
+    __u64 v = 0;
+    if (fd < 0 || read(fd, &v, sizeof(v)) != sizeof(v)) return 0;
+    return (double)v;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Process helpers                                                    */
+/* ------------------------------------------------------------------ */
+
+/**
+ * spawn – fork + exec `argv`.  The child's stdout/stderr go to `out_fd`
+ *         (or /dev/null if -1).  If `go_fd` is >= 0 the child blocks on
+ *         it until the parent writes a byte, which lets the parent attach
+ *         perf counters before the program starts.
+ */
+static pid_t spawn(char *const argv[], int out_fd, int go_fd)
+{
+    pid_t pid = fork();
+    if (pid != 0) return pid;
+
+    int out = (out_fd >= 0) ? out_fd : open("/dev/null", O_WRONLY);
+    dup2(out, STDOUT_FILENO);
+    dup2(out, STDERR_FILENO);
+
+    if (go_fd >= 0) {
+        char c;
+        if (read(go_fd, &c, 1) != 1) _exit(127);
+    }
+    execvp(argv[0], argv);
+    perror("execvp");
+    _exit(127);
+}
+
+/* Builds argv, prefixed with "ip netns exec <ns>" when namespaces are used */
+static int build_argv(char **argv, const driver_config_t *dc, const char *ns)
+{
+    int n = 0;
+    if (dc->use_netns) {
+        argv[n++] = "ip";
+        argv[n++] = "netns";
+        argv[n++] = "exec";
+        argv[n++] = (char *)ns;
+    }
+    return n;
+}
+
+/**
+ * connect_in_netns – connects to ip:port from inside network namespace
+ *                    `ns` (NULL = current namespace).  The socket keeps
+ *                    its namespace after we switch back.
+ */
+static int connect_in_netns(const char *ns, const char *ip, int port)
+{
+    int self = -1;
+    if (ns) {
+        char path[128];
+        snprintf(path, sizeof(path), "/var/run/netns/%s", ns);
+        int target = open(path, O_RDONLY | O_CLOEXEC);
+        self = open("/proc/self/ns/net", O_RDONLY | O_CLOEXEC);
+        if (target < 0 || self < 0 || setns(target, CLONE_NEWNET) < 0) {
+            perror("setns");
+            if (target >= 0) close(target);
+            if (self >= 0) close(self);
+            return -1;
+        }
+        close(target);
+    }
+
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port   = htons(port)
+    };
+    inet_pton(AF_INET, ip, &addr.sin_addr);
+    if (fd >= 0 && connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        close(fd);
+        fd = -1;
+    }
+
+    if (ns) {
+        if (setns(self, CLONE_NEWNET) < 0) perror("setns back");
+        close(self);
+    }
+    return fd;
+}
+
+/* ------------------------------------------------------------------ */
+/*  One client run                                                     */
+/* ------------------------------------------------------------------ */
+
+/**
+ * run_client – runs one client to completion and fills vals[M_*].
+ *              Returns 0 if the client produced a RESULT line.
+ */
+static int run_client(const driver_config_t *dc, int impl, int msg_size,
+                      int threads, double *vals)
+{
+    char path[600], s_msg[16], s_thr[16], s_dur[16], s_warm[16];
+    snprintf(path, sizeof(path), "%s/a4_client", dc->bin_dir);
+    snprintf(s_msg, sizeof(s_msg), "%d", msg_size);
+    snprintf(s_thr, sizeof(s_thr), "%d", threads);
+    snprintf(s_dur, sizeof(s_dur), "%d", dc->duration);
+    snprintf(s_warm, sizeof(s_warm), "%d", dc->warmup);
+
+    char *argv[24];
+    int n = build_argv(argv, dc, NS_CLIENT);
+    argv[n++] = path;
+    argv[n++] = "-s";
+    argv[n++] = (char *)strategy_names[impl];
+    argv[n++] = "-T";
+    argv[n++] = (char *)tls_mode_names[dc->tls];
+    if (dc->compress) argv[n++] = "-Z";
+    if (dc->spin_us) {
+        argv[n++] = "-P";
+        argv[n++] = (char *)dc->spin_us;
+    }
+    if (dc->kpoll_us) {
+        argv[n++] = "-K";
+        argv[n++] = (char *)dc->kpoll_us;
+    }
+    argv[n++] = "-D";
+    argv[n++] = (char *)direction_names[dc->direction];
+    argv[n++] = dc->use_netns ? NS_SERVER_IP : LOOPBACK_IP;
+    argv[n++] = s_msg;
+    argv[n++] = s_thr;
+    argv[n++] = s_dur;
+    argv[n++] = s_warm;
+    argv[n]   = NULL;
+
+    int out[2], go[2];
+    if (pipe2(out, O_CLOEXEC) < 0 || pipe2(go, O_CLOEXEC) < 0) {
+        perror("pipe");
+        return -1;
+    }
+
+    pid_t pid = spawn(argv, out[1], go[0]);
+    close(out[1]);
+    close(go[0]);
+    if (pid < 0) { perror("fork"); close(out[0]); close(go[1]); return -1; }
+
+    int pfd[PERF_COUNT];
+    for (int i = 0; i < PERF_COUNT; i++)
+        pfd[i] = perf_open(pid, perf_events[i].type, perf_events[i].config);
+
+    /* Release the child, then start counting once the warm-up is over */
+    if (write(go[1], "g", 1) != 1) perror("write go");
+    close(go[1]);
+    if (dc->warmup > 0) sleep(dc->warmup);
+    for (int i = 0; i < PERF_COUNT; i++)
+        if (pfd[i] >= 0) ioctl(pfd[i], PERF_EVENT_IOC_ENABLE, 0);
+
+    /* Collect the client's output and look for the RESULT line */
+    FILE *fp = fdopen(out[0], "r");
+    char line[512];
+    int  found = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        if (strncmp(line, "RESULT,", 7) != 0) continue;
+        /* RESULT,<impl>,<msg>,<threads>,<gbps>,<lat_us>,<bytes>,<msgs> */
+        char *f = line;
+        for (int col = 0; col < 4 && f; col++)
+            if ((f = strchr(f, ',')) != NULL) f++;
+        if (f && sscanf(f, "%lf,%lf", &vals[M_THROUGHPUT], &vals[M_LATENCY]) == 2)
+            found = 1;
+    }
+    fclose(fp);
+
+    int status;
+    waitpid(pid, &status, 0);
+
+    for (int i = 0; i < PERF_COUNT; i++) {
+        vals[PERF_FIRST + i] = perf_read(pfd[i]);
+        if (pfd[i] >= 0) close(pfd[i]);
+    }
+    return found ? 0 : -1;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Run metadata for the history CSV                                   */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+    char run_id[64];
+    char timestamp[32];
+    char git_rev[64];
+    char kernel[128];
+    char cpu_model[128];
+    char config[384];
+} run_info_t;
+
+/* Commas would break the CSV columns */
+static void csv_clean(char *s)
+{
+    for (; *s; s++)
+        if (*s == ',' || *s == '\n') *s = ' ';
+}
+
+/* First line of a shell command's output, or "" */
+static void read_command(const char *cmd, char *buf, size_t len)
+{
+    buf[0] = '\0';
+    FILE *p = popen(cmd, "r");
+    if (!p) return;
+    if (fgets(buf, (int)len, p)) buf[strcspn(buf, "\n")] = '\0';
+    pclose(p);
+}
+
+static void collect_run_info(const driver_config_t *dc, run_info_t *ri)
+{
+    char cmd[700], dirty[8];
+    snprintf(cmd, sizeof(cmd),
+             "git -C '%s' rev-parse --short HEAD 2>/dev/null", dc->bin_dir);
+    read_command(cmd, ri->git_rev, sizeof(ri->git_rev));
+    snprintf(cmd, sizeof(cmd),
+             "git -C '%s' status --porcelain -uno 2>/dev/null | head -1",
+             dc->bin_dir);
+    read_command(cmd, dirty, sizeof(dirty));
+    if (!ri->git_rev[0]) strcpy(ri->git_rev, "unknown");
+    else if (dirty[0])   strcat(ri->git_rev, "-dirty");
+
+    struct utsname u;
+    snprintf(ri->kernel, sizeof(ri->kernel), "%s",
+             uname(&u) == 0 ? u.release : "unknown");
+
+    strcpy(ri->cpu_model, "unknown");
+    FILE *f = fopen("/proc/cpuinfo", "r");
+    char line[256];
+    while (f && fgets(line, sizeof(line), f)) {
+        char *colon = strchr(line, ':');
+        if (strncmp(line, "model name", 10) != 0 || !colon) continue;
+        colon += strspn(colon + 1, " ") + 1;
+        colon[strcspn(colon, "\n")] = '\0';
+        snprintf(ri->cpu_model, sizeof(ri->cpu_model), "%s", colon);
+        break;
+    }
+    if (f) fclose(f);
+
+    time_t now = time(NULL);
+    struct tm tm;
+    localtime_r(&now, &tm);
+    strftime(ri->timestamp, sizeof(ri->timestamp), "%Y-%m-%dT%H:%M:%S", &tm);
+    char stamp[32];
+    strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", &tm);
+    snprintf(ri->run_id, sizeof(ri->run_id), "%s-%s", stamp, ri->git_rev);
+
+    snprintf(ri->config, sizeof(ri->config),
+             "driver;reps=%d;warmup=%d;duration=%d;tls=%s;compress=%d;"
+             "batch=%d;direction=%s;rx_mode=%s;net=%s;placement=%s;"
+             "busy_poll=%s/%s",
+             dc->reps, dc->warmup, dc->duration, tls_mode_names[dc->tls],
+             dc->compress, dc->batch, direction_names[dc->direction],
+             rx_mode_names[dc->rx_mode],
+             dc->use_netns ? "netns" : "loopback",
+             dc->placement ? dc->placement : "none",
+             dc->spin_us ? dc->spin_us : "off",
+             dc->kpoll_us ? dc->kpoll_us : "0");
+
+    csv_clean(ri->git_rev);
+    csv_clean(ri->kernel);
+    csv_clean(ri->cpu_model);
+    csv_clean(ri->config);             /* list:0,2,... placements */
+}
+
+/**
+ * open_history – opens the history CSV for appending, writing the
+ *                header first if the file is new or empty.
+ */
+static FILE *open_history(const char *path)
+{
+    FILE *f = fopen(path, "a");
+    if (!f) return NULL;
+    if (ftell(f) == 0) {
+        fprintf(f, "run_id,timestamp,git_rev,kernel,cpu_model,config,"
+                "implementation,msg_size,threads,rep");
+        for (int m = 0; m < M_COUNT; m++) fprintf(f, ",%s", metric_names[m]);
+        fprintf(f, "\n");
+    }
+    return f;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Argument parsing                                                   */
+/* ------------------------------------------------------------------ */
+
+/* Non-zero (and a message) if tok is left over after MAX_LIST entries */
+static int list_too_long(const char *tok)
+{
+    if (!tok) return 0;
+    fprintf(stderr, "Error: at most %d entries per list, '%s' is one more\n",
+            MAX_LIST, tok);
+    return 1;
+}
+
+static int parse_int_list(char *s, int *out)
+{
+    int n = 0;
+    char *tok = strtok(s, ",");
+    for (; tok && n < MAX_LIST; tok = strtok(NULL, ","))
+        if ((out[n] = atoi(tok)) > 0) n++;
+    return list_too_long(tok) ? -1 : n;
+}
+
+static int parse_impl_list(char *s, int *out)
+{
+    int n = 0;
+    char *tok = strtok(s, ",");
+    for (; tok && n < MAX_LIST; tok = strtok(NULL, ",")) {
+        int v = strategy_from_name(tok);
+        if (v < 0) {
+            fprintf(stderr, "Error: unknown implementation '%s'\n", tok);
+            return -1;
+        }
+        out[n++] = v;
+    }
+    return list_too_long(tok) ? -1 : n;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s [-i impls] [-m sizes] [-t threads] [-r reps]\n"
+            "          [-w warmup_sec] [-d duration_sec] [-T tls]\n"
+            "          [-Z] [-B batch] [-D direction] [-x rx_mode] [-n]\n"
+            "          [-o results.csv] [-R raw.csv] [-H history.csv]\n"
+            "          [-I tcpinfo_ms] [-A placement] [-P spin_us]\n"
+            "          [-K busy_poll_us]\n"
+            "  -i  comma list of two_copy,one_copy,zero_copy,sendfile\n"
+            "      (default two_copy,one_copy,zero_copy)\n"
+            "  -m  comma list of message sizes (default 1024,4096,16384,65536)\n"
+            "  -t  comma list of thread counts (default 1,2,4,8)\n"
+            "  -r  repetitions per point (default 5)\n"
+            "  -w  unmeasured warm-up per repetition (default 2 s)\n"
+            "  -d  measured duration per repetition (default %d s)\n"
+            "  -T  none | ktls | user encryption (default none)\n"
+            "  -Z  compress on the server, -B messages per frame (default 1)\n"
+            "  -D  down | up | both traffic direction (default down)\n"
+            "  -x  recv | bulk | zerocopy_rx server receive path (default recv)\n"
+            "  -n  run in the ns_server/ns_client namespaces (root)\n"
+            "  -o  summary CSV (default MT25042_Part_C_DriverSummary.csv)\n"
+            "  -R  also write every repetition to this CSV\n"
+            "  -H  append every repetition to this history CSV\n"
+            "      (default " HISTORY_CSV ", - to disable)\n"
+            "  -I  sample TCP_INFO every N ms into <results>_tcpinfo*.csv\n"
+            "  -A  compact | scatter | same_core | cross_socket | list:<cpus>\n"
+            "      thread placement for server and clients (default none)\n"
+            "  -P  busy-poll receive in the clients, spin budget per wait in\n"
+            "      us (-1 = never sleep); -K adds kernel busy polling (us);\n"
+            "      both need -D down\n",
+            prog, DEFAULT_DURATION);
+}
+
+/* ------------------------------------------------------------------ */
+/*  Main                                                               */
+/* ------------------------------------------------------------------ */
+
+int main(int argc, char *argv[])
+{
+    driver_config_t dc = {
+        .impls    = { STRAT_TWO_COPY, STRAT_ONE_COPY, STRAT_ZERO_COPY },
+        .n_impls  = 3,
+        .sizes    = { 1024, 4096, 16384, 65536 },
+        .n_sizes  = 4,
+        .threads  = { 1, 2, 4, 8 },
+        .n_threads = 4,
+        .reps     = 5,
+        .warmup   = 2,
+        .duration = DEFAULT_DURATION,
+        .batch    = 1,
+        .out_csv  = "MT25042_Part_C_DriverSummary.csv",
+        .history_csv = HISTORY_CSV,
+    };
+
+    int opt;
+    while ((opt = getopt(argc, argv, "i:m:t:r:w:d:T:ZB:D:x:no:R:H:I:A:P:K:h")) != -1) {
+        switch (opt) {
+        case 'i': dc.n_impls   = parse_impl_list(optarg, dc.impls); break;
+        case 'm': dc.n_sizes   = parse_int_list(optarg, dc.sizes); break;
+        case 't': dc.n_threads = parse_int_list(optarg, dc.threads); break;
+        case 'r': dc.reps      = atoi(optarg); break;
+        case 'w': dc.warmup    = atoi(optarg); break;
+        case 'd': dc.duration  = atoi(optarg); break;
+        case 'T':
+            if ((dc.tls = tls_mode_from_name(optarg)) < 0) {
+                fprintf(stderr, "Error: unknown tls mode '%s'\n", optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        case 'Z': dc.compress  = 1; break;
+        case 'B': dc.batch     = atoi(optarg); break;
+        case 'D':
+            if ((dc.direction = direction_from_name(optarg)) < 0) {
+                fprintf(stderr, "Error: unknown direction '%s'\n", optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        case 'x':
+            if ((dc.rx_mode = rx_mode_from_name(optarg)) < 0) {
+                fprintf(stderr, "Error: unknown rx_mode '%s'\n", optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        case 'n': dc.use_netns = 1; break;
+        case 'o': dc.out_csv   = optarg; break;
+        case 'R': dc.raw_csv   = optarg; break;
+        case 'H': dc.history_csv = optarg; break;
+        case 'I': dc.tcpinfo_ms  = atoi(optarg); break;
+        case 'A': dc.placement   = optarg; break;
+        case 'P': dc.spin_us     = optarg; break;
+        case 'K': dc.kpoll_us    = optarg; break;
+        default:  usage(argv[0]); return EXIT_FAILURE;
+        }
+    }
+
+    if (dc.n_impls <= 0 || dc.n_sizes <= 0 || dc.n_threads <= 0 ||
+        dc.reps <= 0 || dc.reps > MAX_REPS || dc.warmup < 0 ||
+        dc.duration <= 0 || dc.batch <= 0 || dc.tcpinfo_ms < 0 ||
+        (dc.compress && dc.tls == TLS_MODE_USER)) {
+        fprintf(stderr, "Error: invalid arguments (reps must be 1..%d, "
+                "-Z cannot be combined with -T user)\n",
+                MAX_REPS);
+        return EXIT_FAILURE;
+    }
+    /* Busy polling only changes the clients' receive loop */
+    if ((dc.spin_us || dc.kpoll_us) && dc.direction != DIR_DOWN) {
+        fprintf(stderr, "Error: -P/-K busy-poll the receive path and need "
+                "-D down, not -D %s\n", direction_names[dc.direction]);
+        return EXIT_FAILURE;
+    }
+    if (dc.kpoll_us && !dc.spin_us) {
+        fprintf(stderr, "Error: -K needs -P\n");
+        return EXIT_FAILURE;
+    }
+
+    /* Sibling binaries live next to the driver */
+    char self[512];
+    ssize_t len = readlink("/proc/self/exe", self, sizeof(self) - 1);
+    if (len < 0) { perror("readlink"); return EXIT_FAILURE; }
+    self[len] = '\0';
+    snprintf(dc.bin_dir, sizeof(dc.bin_dir), "%s", dirname(self));
+
+    FILE *out = fopen(dc.out_csv, "w");
+    if (!out) { perror(dc.out_csv); return EXIT_FAILURE; }
+    fprintf(out, "implementation,msg_size,threads,reps");
+    for (int m = 0; m < M_COUNT; m++)
+        fprintf(out, ",%s_mean,%s_std,%s_ci95",
+                metric_names[m], metric_names[m], metric_names[m]);
+    fprintf(out, "\n");
+
+    FILE *raw = NULL;
+    if (dc.raw_csv) {
+        raw = fopen(dc.raw_csv, "w");
+        if (!raw) { perror(dc.raw_csv); return EXIT_FAILURE; }
+        fprintf(raw, "implementation,msg_size,threads,rep");
+        for (int m = 0; m < M_COUNT; m++) fprintf(raw, ",%s", metric_names[m]);
+        fprintf(raw, "\n");
+    }
+
+    FILE      *hist = NULL;
+    run_info_t ri;
+    if (strcmp(dc.history_csv, "-") != 0) {
+        collect_run_info(&dc, &ri);
+        hist = open_history(dc.history_csv);
+        if (!hist) { perror(dc.history_csv); return EXIT_FAILURE; }
+        printf("[Driver] Run %s (kernel %s, %s)\n",
+               ri.run_id, ri.kernel, ri.cpu_model);
+    }
+
+    /* TCP_INFO files sit next to the results: <stem>_tcpinfo... */
+    if (dc.tcpinfo_ms > 0) {
+        char ms[16];
+        int  stem = (int)strlen(dc.out_csv);
+        if (stem > 4 && strcmp(dc.out_csv + stem - 4, ".csv") == 0) stem -= 4;
+        snprintf(dc.tcpinfo_prefix, sizeof(dc.tcpinfo_prefix), "%.*s_tcpinfo",
+                 stem, dc.out_csv);
+        snprintf(ms, sizeof(ms), "%d", dc.tcpinfo_ms);
+        setenv("PA02_TCPINFO_MS", ms, 1);
+        setenv("PA02_TCPINFO", dc.tcpinfo_prefix, 1);
+    }
+
+    /* Server and clients read the policy at startup */
+    if (dc.placement) setenv("PA02_PLACEMENT", dc.placement, 1);
+
+    /* Start the warm server */
+    char server_path[600];
+    snprintf(server_path, sizeof(server_path), "%s/a4_server", dc.bin_dir);
+    char *sargv[8];
+    int sn = build_argv(sargv, &dc, NS_SERVER);
+    sargv[sn++] = server_path;
+    sargv[sn]   = NULL;
+
+    pid_t server = spawn(sargv, -1, -1);
+    if (server < 0) { perror("fork server"); return EXIT_FAILURE; }
+
+    char cmd[CONTROL_LINE_MAX], reply[CONTROL_LINE_MAX];
+    const char *ctl_ns = dc.use_netns ? NS_SERVER : NULL;
+    int ctl = -1;
+    for (int waited = 0; ctl < 0 && waited < SERVER_START_MS; waited += 100) {
+        usleep(100 * 1000);
+        ctl = connect_in_netns(ctl_ns, LOOPBACK_IP, CONTROL_PORT);
+    }
+    if (ctl < 0) {
+        fprintf(stderr, "Error: a4_server control port did not come up\n");
+        kill(server, SIGTERM);
+        waitpid(server, NULL, 0);
+        return EXIT_FAILURE;
+    }
+
+    printf("[Driver] %d impl x %d sizes x %d thread counts, %d reps, "
+           "warmup=%ds, duration=%ds, tls=%s, %s\n",
+           dc.n_impls, dc.n_sizes, dc.n_threads, dc.reps, dc.warmup,
+           dc.duration, tls_mode_names[dc.tls],
+           dc.use_netns ? "namespaces" : "loopback");
+
+    /* Settings for the whole sweep.  Every row is labelled with them, so
+     * one the server rejects ends the run before any row is written */
+    char fixed[5][CONTROL_LINE_MAX];
+    snprintf(fixed[0], sizeof(fixed[0]), "SET tls %s", tls_mode_names[dc.tls]);
+    snprintf(fixed[1], sizeof(fixed[1]), "SET compress %d", dc.compress);
+    snprintf(fixed[2], sizeof(fixed[2]), "SET batch %d", dc.batch);
+    snprintf(fixed[3], sizeof(fixed[3]), "SET direction %s",
+             direction_names[dc.direction]);
+    snprintf(fixed[4], sizeof(fixed[4]), "SET rx_mode %s",
+             rx_mode_names[dc.rx_mode]);
+    for (int i = 0; i < 5; i++) {
+        reply[0] = '\0';
+        if (control_request(ctl, fixed[i], reply, sizeof(reply)) < 0) {
+            fprintf(stderr, "Error: '%s' failed: %s\n", fixed[i], reply);
+            close(ctl);
+            kill(server, SIGTERM);
+            waitpid(server, NULL, 0);
+            return EXIT_FAILURE;
+        }
+    }
+
+    static double samples[M_COUNT][MAX_REPS];
+
+    for (int ii = 0; ii < dc.n_impls; ii++) {
+        int impl = dc.impls[ii];
+        for (int si = 0; si < dc.n_sizes; si++) {
+            int msg_size = dc.sizes[si];
+            for (int ti = 0; ti < dc.n_threads; ti++) {
+                int threads = dc.threads[ti];
+
+                /* Same label a4_client prints, e.g. "sendfile+ktls" */
+                char label[64];
+                snprintf(label, sizeof(label), "%s%s%s%s%s%s",
+                         strategy_names[impl],
+                         dc.tls != TLS_MODE_NONE ? "+" : "",
+                         dc.tls != TLS_MODE_NONE ? tls_mode_names[dc.tls] : "",
+                         dc.compress ? "+lz" : "",
+                         dc.direction != DIR_DOWN ? "+" : "",
+                         dc.direction != DIR_DOWN
+                             ? direction_names[dc.direction] : "");
+
+                snprintf(cmd, sizeof(cmd), "SET strategy %s",
+                         strategy_names[impl]);
+                int rc = control_request(ctl, cmd, reply, sizeof(reply));
+                snprintf(cmd, sizeof(cmd), "SET msg_size %d", msg_size);
+                rc |= control_request(ctl, cmd, reply, sizeof(reply));
+                if (rc < 0) {
+                    fprintf(stderr, "Error: reconfigure failed: %s\n", reply);
+                    continue;
+                }
+
+                int ok = 0;
+                for (int r = 0; r < dc.reps; r++) {
+                    double vals[M_COUNT] = { 0 };
+                    control_request(ctl, "RESET", reply, sizeof(reply));
+                    if (dc.tcpinfo_ms > 0) {
+                        char prefix[700];
+                        snprintf(prefix, sizeof(prefix), "%s_%s_%d_%d_r%d",
+                                 dc.tcpinfo_prefix, label, msg_size,
+                                 threads, r);
+                        setenv("PA02_TCPINFO", prefix, 1);
+                    }
+
+                    if (run_client(&dc, impl, msg_size, threads, vals) < 0) {
+                        fprintf(stderr, "[Driver] %s/%d/%d rep %d: no result\n",
+                                label, msg_size, threads, r);
+                        continue;
+                    }
+                    for (int m = 0; m < M_COUNT; m++) samples[m][ok] = vals[m];
+                    ok++;
+
+                    if (raw) {
+                        fprintf(raw, "%s,%d,%d,%d", label,
+                                msg_size, threads, r);
+                        for (int m = 0; m < M_COUNT; m++)
+                            fprintf(raw, ",%.4f", vals[m]);
+                        fprintf(raw, "\n");
+                        fflush(raw);
+                    }
+                    if (hist) {
+                        fprintf(hist, "%s,%s,%s,%s,%s,%s,%s,%d,%d,%d",
+                                ri.run_id, ri.timestamp, ri.git_rev,
+                                ri.kernel, ri.cpu_model, ri.config, label,
+                                msg_size, threads, r);
+                        for (int m = 0; m < M_COUNT; m++)
+                            fprintf(hist, ",%.4f", vals[m]);
+                        fprintf(hist, "\n");
+                        fflush(hist);
+                    }
+                }
+
+                fprintf(out, "%s,%d,%d,%d", label,
+                        msg_size, threads, ok);
+                double mean[M_COUNT], sd[M_COUNT], ci[M_COUNT];
+                for (int m = 0; m < M_COUNT; m++) {
+                    summarize(samples[m], ok, &mean[m], &sd[m], &ci[m]);
+                    fprintf(out, ",%.4f,%.4f,%.4f", mean[m], sd[m], ci[m]);
+                }
+                fprintf(out, "\n");
+                fflush(out);
+
+                printf("[Driver] %-9s msg=%-6d thr=%d  %.4f ± %.4f Gbps  "
+                       "%.2f ± %.2f µs  (n=%d)\n",
+                       label, msg_size, threads,
+                       mean[M_THROUGHPUT], ci[M_THROUGHPUT],
+                       mean[M_LATENCY], ci[M_LATENCY], ok);
+            }
+        }
+    }
+
+    control_request(ctl, "SHUTDOWN", reply, sizeof(reply));
+    close(ctl);
+    waitpid(server, NULL, 0);
+
+    fclose(out);
+    if (raw) fclose(raw);
+    if (hist) fclose(hist);
+    printf("[Driver] Results saved to %s\n", dc.out_csv);
+    if (hist)
+        printf("[Driver] Run %s appended to %s\n", ri.run_id, dc.history_csv);
+    return EXIT_SUCCESS;
+}
@@ -8,11 +8,19 @@
 #   2. Sets up Linux network namespaces (ns_server / ns_client)
 #   3. Runs experiments across message sizes and thread counts
 #   4. Collects perf stat metrics + application-level throughput/latency
-#   5. Stores everything in CSV format
+#   5. Stores everything in CSV format, and appends the sweep (tagged
+#      with git revision, kernel, CPU model and configuration) to the
+#      persistent history read by MT25042_Part_D_Compare.py
 #
 # MUST be run as root (sudo) because namespace creation requires it.
 #
-# Usage:  sudo ./MT25042_Part_C_Experiment.sh
+# Usage:  sudo ./MT25042_Part_C_Experiment.sh [--warm] [--xdp]
+#
+#   --warm   Start one a4_server for the whole sweep and reconfigure it
+#            over its control port between points instead of killing and
+#            restarting a per-implementation server every time.
+#   --xdp    Also run every message size over AF_XDP (a10_xdp, one
+#            thread), stored as implementation "af_xdp".
 #
 # AI Declaration: Asked ChatGPT "How to create Linux network namespaces
 #   connected with veth for testing TCP locally?" and adapted the setup.
@@ -25,6 +33,7 @@
 ROLL_NUM="MT25042"
 SCRIPT_DIR="$(cd "$(dirname "$0")" && pwd)"
 OUTPUT_CSV="${SCRIPT_DIR}/${ROLL_NUM}_Part_B_Results.csv"
+HISTORY_CSV="${SCRIPT_DIR}/${ROLL_NUM}_Part_B_History.csv"
 
 # Namespace names
 NS_SERVER="ns_server"
@@ -49,8 +58,10 @@ IMPL_NAMES=("two_copy" "one_copy" "zero_copy")
 DURATION=10
 
 # Server binaries
-declare -A SERVER_BIN=( [a1]="a1_server" [a2]="a2_server" [a3]="a3_server" )
-declare -A CLIENT_BIN=( [a1]="a1_client" [a2]="a2_client" [a3]="a3_client" )
+declare -A SERVER_BIN=( [a1]="a1_server" [a2]="a2_server" [a3]="a3_server"
+                        [xdp]="a10_xdp" )
+declare -A CLIENT_BIN=( [a1]="a1_client" [a2]="a2_client" [a3]="a3_client"
+                        [xdp]="a10_xdp" )
 
 # Colours for terminal output
 RED='\033[0;31m'
@@ -60,6 +71,11 @@ BLUE='\033[0;34m'
 NC='\033[0m'
 
 PORT=9876
+CTL_PORT=9877
+
+# Set by --warm / --xdp
+WARM=0
+XDP=0
 
 #------------------------------------------------------------------------------
 # Utility functions
@@ -138,6 +154,36 @@ wait_for_port() {
     return 1
 }
 
+#------------------------------------------------------------------------------
+# Control channel of the warm a4_server (see MT25042_Part_A_Control.h)
+#
+# Sends each argument as one command line and prints the replies.
+# Fails if any reply starts with ERR.
+#------------------------------------------------------------------------------
+ctl() {
+    local replies
+    replies=$(ip netns exec "$NS_SERVER" bash -c '
+        exec 3<>/dev/tcp/127.0.0.1/'"$CTL_PORT"' || exit 1
+        for cmd in "$@"; do printf "%s\n" "$cmd" >&3; done
+        printf "QUIT\n" >&3
+        cat <&3' _ "$@") || return 1
+    echo "$replies" | grep -v '^BYE$'
+    ! echo "$replies" | grep -q '^ERR'
+}
+
+start_warm_server() {
+    ip netns exec "$NS_SERVER" "${SCRIPT_DIR}/a4_server" \
+        -p "$PORT" -C "$CTL_PORT" > /dev/null &
+    WARM_SERVER_PID=$!
+    wait_for_port "$NS_CLIENT" "$PORT" || exit 1
+    msg "$GREEN" "Warm a4_server running (pid ${WARM_SERVER_PID})."
+}
+
+stop_warm_server() {
+    ctl "SHUTDOWN" >/dev/null 2>&1 || true
+    wait "$WARM_SERVER_PID" 2>/dev/null || true
+}
+
 #------------------------------------------------------------------------------
 # Parse perf stat output (expects --field-separator=, -x, format)
 #------------------------------------------------------------------------------
@@ -161,43 +207,28 @@ parse_perf() {
 }
 
 #------------------------------------------------------------------------------
-# Run a single experiment
+# Run the client under perf stat and append one CSV row
 #------------------------------------------------------------------------------
-run_experiment() {
+run_client() {
     local impl=$1
     local impl_name=$2
     local msg_size=$3
     local threads=$4
 
-    local server="${SCRIPT_DIR}/${SERVER_BIN[$impl]}"
     local client="${SCRIPT_DIR}/${CLIENT_BIN[$impl]}"
 
-    msg "$YELLOW" "--- ${impl_name} | msg=${msg_size} | threads=${threads} ---"
-
-    # Kill any leftover server
-    kill_server
-
-    # Start server in ns_server (background)
-    ip netns exec "$NS_SERVER" "$server" "$msg_size" "$threads" &
-    local server_pid=$!
-    sleep 1
-
-    # Verify server is running
-    if ! kill -0 "$server_pid" 2>/dev/null; then
-        msg "$RED" "Server failed to start!"
-        echo "${impl_name},${msg_size},${threads},0,0,0,0,0,0" >> "$OUTPUT_CSV"
-        return
-    fi
-
     # Run client in ns_client, wrapped with perf stat
     local perf_out=$(mktemp /tmp/perf_XXXXXX.txt)
     local client_out=$(mktemp /tmp/client_XXXXXX.txt)
 
+    local client_args=("$IP_SERVER" "$msg_size" "$threads" "$DURATION")
+    [ "$impl" = "xdp" ] && client_args=(-i "$VETH_C" recv "$msg_size" "$DURATION")
+
     ip netns exec "$NS_CLIENT" perf stat \
         -e cpu-cycles,L1-dcache-load-misses,LLC-load-misses,context-switches \
         -x, \
         -o "$perf_out" \
-        "$client" "$IP_SERVER" "$msg_size" "$threads" "$DURATION" \
+        "$client" "${client_args[@]}" \
         > "$client_out" 2>&1
 
     # Parse application-level results from client output
@@ -225,15 +256,124 @@ run_experiment() {
     echo "${impl_name},${msg_size},${threads},${tp_gbps},${avg_lat},${cpu_cycles},${l1_misses},${llc_misses},${ctx_switches}" \
         >> "$OUTPUT_CSV"
 
+    rm -f "$perf_out" "$client_out"
+}
+
+#------------------------------------------------------------------------------
+# Run a single experiment
+#------------------------------------------------------------------------------
+run_experiment() {
+    local impl=$1
+    local impl_name=$2
+    local msg_size=$3
+    local threads=$4
+
+    local server="${SCRIPT_DIR}/${SERVER_BIN[$impl]}"
+
+    msg "$YELLOW" "--- ${impl_name} | msg=${msg_size} | threads=${threads} ---"
+
+    # Kill any leftover server
+    kill_server
+
+    # Start server in ns_server (background)
+    ip netns exec "$NS_SERVER" "$server" "$msg_size" "$threads" &
+    local server_pid=$!
+    sleep 1
+
+    # Verify server is running
+    if ! kill -0 "$server_pid" 2>/dev/null; then
+        msg "$RED" "Server failed to start!"
+        echo "${impl_name},${msg_size},${threads},0,0,0,0,0,0" >> "$OUTPUT_CSV"
+        return
+    fi
+
+    run_client "$impl" "$impl_name" "$msg_size" "$threads"
+
     # Clean up server
     kill "$server_pid" 2>/dev/null || true
     wait "$server_pid" 2>/dev/null || true
-    rm -f "$perf_out" "$client_out"
 
     # Brief pause between experiments
     sleep 1
 }
 
+#------------------------------------------------------------------------------
+# Run a single experiment against the warm a4_server
+#------------------------------------------------------------------------------
+run_experiment_warm() {
+    local impl=$1
+    local impl_name=$2
+    local msg_size=$3
+    local threads=$4
+
+    msg "$YELLOW" "--- ${impl_name} | msg=${msg_size} | threads=${threads} (warm) ---"
+
+    if ! ctl "SET strategy ${impl_name}" "SET msg_size ${msg_size}" "RESET" \
+            >/dev/null; then
+        msg "$RED" "Reconfiguring the warm server failed!"
+        echo "${impl_name},${msg_size},${threads},0,0,0,0,0,0" >> "$OUTPUT_CSV"
+        return
+    fi
+
+    run_client "$impl" "$impl_name" "$msg_size" "$threads"
+
+    msg "$GREEN" "  Server: $(ctl STATS)"
+}
+
+#------------------------------------------------------------------------------
+# Run a single AF_XDP experiment (a10_xdp sender in ns_server)
+#
+# Only the sender is stopped, so a warm a4_server keeps running.
+#------------------------------------------------------------------------------
+run_experiment_xdp() {
+    local msg_size=$1
+
+    msg "$YELLOW" "--- af_xdp | msg=${msg_size} | threads=1 ---"
+
+    ip netns exec "$NS_SERVER" "${SCRIPT_DIR}/${SERVER_BIN[xdp]}" \
+        -i "$VETH_S" send "$msg_size" > /dev/null &
+    local sender_pid=$!
+    sleep 1
+
+    if ! kill -0 "$sender_pid" 2>/dev/null; then
+        msg "$RED" "AF_XDP sender failed to start!"
+        echo "af_xdp,${msg_size},1,0,0,0,0,0,0" >> "$OUTPUT_CSV"
+        return
+    fi
+
+    run_client "xdp" "af_xdp" "$msg_size" 1
+
+    kill -INT "$sender_pid" 2>/dev/null || true
+    wait "$sender_pid" 2>/dev/null || true
+    sleep 1
+}
+
+#------------------------------------------------------------------------------
+# Append this sweep to the history CSV (same columns as c_driver -H)
+#------------------------------------------------------------------------------
+store_history() {
+    local rev kernel cpu stamp run_id config
+    rev=$(git -C "$SCRIPT_DIR" rev-parse --short HEAD 2>/dev/null || echo unknown)
+    if [ -n "$(git -C "$SCRIPT_DIR" status --porcelain -uno 2>/dev/null | head -1)" ]; then
+        rev="${rev}-dirty"
+    fi
+    kernel=$(uname -r)
+    cpu=$(grep -m1 '^model name' /proc/cpuinfo | cut -d: -f2- | sed 's/^ *//; s/,/ /g')
+    stamp=$(date +%Y-%m-%dT%H:%M:%S)
+    run_id="$(date -d "$stamp" +%Y%m%d-%H%M%S)-${rev}"
+    config="script;reps=1;warmup=0;duration=${DURATION};warm=${WARM};net=netns"
+
+    if [ ! -s "$HISTORY_CSV" ]; then
+        echo "run_id,timestamp,git_rev,kernel,cpu_model,config,implementation,msg_size,threads,rep,throughput_gbps,latency_us,cpu_cycles,l1_cache_misses,llc_cache_misses,context_switches" \
+            > "$HISTORY_CSV"
+    fi
+    tail -n +2 "$OUTPUT_CSV" | while IFS=',' read -r impl size thr rest; do
+        echo "${run_id},${stamp},${rev},${kernel},${cpu:-unknown},${config},${impl},${size},${thr},0,${rest}"
+    done >> "$HISTORY_CSV"
+
+    msg "$GREEN" "Run ${run_id} appended to: ${HISTORY_CSV}"
+}
+
 #------------------------------------------------------------------------------
 # Main
 #------------------------------------------------------------------------------
@@ -244,6 +384,14 @@ main() {
     msg "$GREEN" "========================================================="
     echo ""
 
+    for arg in "$@"; do
+        case "$arg" in
+            --warm) WARM=1 ;;
+            --xdp)  XDP=1 ;;
+            *) msg "$RED" "Unknown option: $arg"; exit 1 ;;
+        esac
+    done
+
     # Must be root
     if [ "$(id -u)" -ne 0 ]; then
         msg "$RED" "ERROR: This script must be run as root (sudo)."
@@ -259,6 +407,7 @@ main() {
     # Step 2: Set up namespaces
     msg "$BLUE" "[Step 2] Setting up network namespaces..."
     setup_namespaces
+    [ "$WARM" -eq 1 ] && start_warm_server
     echo ""
 
     # Step 3: Initialise CSV
@@ -270,6 +419,7 @@ main() {
     # Step 4: Run experiments
     msg "$BLUE" "[Step 4] Running experiments..."
     local total=$(( ${#IMPLEMENTATIONS[@]} * ${#MSG_SIZES[@]} * ${#THREAD_COUNTS[@]} ))
+    [ "$XDP" -eq 1 ] && total=$(( total + ${#MSG_SIZES[@]} ))
     local count=0
 
     for idx in "${!IMPLEMENTATIONS[@]}"; do
@@ -280,15 +430,30 @@ main() {
             for threads in "${THREAD_COUNTS[@]}"; do
                 count=$((count + 1))
                 msg "$BLUE" "=== Experiment ${count}/${total} ==="
-                run_experiment "$impl" "$impl_name" "$msg_size" "$threads"
+                if [ "$WARM" -eq 1 ]; then
+                    run_experiment_warm "$impl" "$impl_name" "$msg_size" "$threads"
+                else
+                    run_experiment "$impl" "$impl_name" "$msg_size" "$threads"
+                fi
                 echo ""
             done
         done
     done
 
+    if [ "$XDP" -eq 1 ]; then
+        for msg_size in "${MSG_SIZES[@]}"; do
+            count=$((count + 1))
+            msg "$BLUE" "=== Experiment ${count}/${total} ==="
+            run_experiment_xdp "$msg_size"
+            echo ""
+        done
+    fi
+
     # Step 5: Clean up
     msg "$BLUE" "[Step 5] Cleaning up namespaces..."
+    [ "$WARM" -eq 1 ] && stop_warm_server
     cleanup_namespaces
+    store_history
 
     msg "$GREEN" "========================================================="
     msg "$GREEN" "All experiments complete!"
@@ -0,0 +1,200 @@
+#!/usr/bin/env python3
+"""
+MT25042_Part_D_Compare.py
+Graduate Systems (CSE638) - PA02: Analysis of Network I/O primitives
+
+Regression check over the results history (MT25042_Part_B_History.csv),
+which c_driver and MT25042_Part_C_Experiment.sh append to on every run.
+
+For every (implementation, msg_size, threads) point present in both the
+run and the baseline, throughput (higher is better), latency and CPU
+cycles (lower is better) are compared with Welch's t-test at 95%.  A
+point is flagged as a regression when the difference is significant AND
+worse than the noise threshold (-t, default 5%).  Points with a single
+repetition on either side cannot be tested and are flagged on the
+threshold alone (marked '~').
+
+Usage:
+  python3 MT25042_Part_D_Compare.py --list
+  python3 MT25042_Part_D_Compare.py [-H history.csv] [-b baseline] [-r run]
+                                    [-t percent]
+
+  Runs are given by run id (or a unique prefix), 'latest' or 'previous'.
+  Defaults: run = latest, baseline = previous.
+  Exits with status 1 if any regression was found.
+
+AI Declaration: This script was generated with AI assistance;
+  Welch-Satterthwaite degrees of freedom as in any statistics textbook.
+"""
+
+import argparse
+import csv
+import math
+import os
+import sys
+
+HISTORY_CSV = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                           'MT25042_Part_B_History.csv')
+
+# metric column -> (short name, True if higher is better)
+METRICS = {
+    'throughput_gbps': ('tput', True),
+    'latency_us':      ('lat', False),
+    'cpu_cycles':      ('cycles', False),
+}
+
+# Two-sided 95% Student-t quantiles for 1..30 degrees of freedom
+T95 = [12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262,
+       2.228, 2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101,
+       2.093, 2.086, 2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052,
+       2.048, 2.045, 2.042]
+
+
+# ============================================================================
+# History
+# ============================================================================
+
+def load_history(path):
+    """Returns (runs, samples).
+
+    runs:    ordered list of dicts with run_id, timestamp, git_rev,
+             kernel, cpu_model, config (oldest first)
+    samples: {run_id: {(impl, msg_size, threads): {metric: [values]}}}
+    """
+    runs, samples = [], {}
+    with open(path, newline='') as f:
+        for row in csv.DictReader(f):
+            rid = row['run_id']
+            if rid not in samples:
+                samples[rid] = {}
+                runs.append({k: row[k] for k in
+                             ('run_id', 'timestamp', 'git_rev', 'kernel',
+                              'cpu_model', 'config')})
+            key = (row['implementation'], int(row['msg_size']),
+                   int(row['threads']))
+            point = samples[rid].setdefault(key, {m: [] for m in METRICS})
+            for m in METRICS:
+                point[m].append(float(row[m] or 0))
+    runs.sort(key=lambda r: r['timestamp'])
+    return runs, samples
+
+
+def resolve_run(runs, name):
+    """Maps 'latest', 'previous' or a run-id prefix to a run id."""
+    if not runs:
+        sys.exit('Error: the history is empty')
+    if name == 'latest':
+        return runs[-1]['run_id']
+    if name == 'previous':
+        if len(runs) < 2:
+            sys.exit('Error: the history has only one run')
+        return runs[-2]['run_id']
+    matches = [r['run_id'] for r in runs if r['run_id'].startswith(name)]
+    if len(matches) != 1:
+        sys.exit(f"Error: run '{name}' matches {len(matches)} runs")
+    return matches[0]
+
+
+# ============================================================================
+# Statistics
+# ============================================================================
+
+def mean_var(x):
+    n = len(x)
+    m = sum(x) / n
+    v = sum((a - m) ** 2 for a in x) / (n - 1) if n > 1 else 0.0
+    return m, v
+
+
+def welch_significant(a, b):
+    """True if the means of a and b differ at the 95% level."""
+    if len(a) < 2 or len(b) < 2:
+        return None
+    ma, va = mean_var(a)
+    mb, vb = mean_var(b)
+    se2 = va / len(a) + vb / len(b)
+    if se2 == 0:
+        return ma != mb
+    t = abs(ma - mb) / math.sqrt(se2)
+    df = se2 ** 2 / ((va / len(a)) ** 2 / (len(a) - 1) +
+                     (vb / len(b)) ** 2 / (len(b) - 1))
+    # Rounding df down keeps the test conservative
+    crit = 1.960 if df > 30 else T95[max(int(df), 1) - 1]
+    return t > crit
+
+
+def compare(base, run, threshold):
+    """Yields (key, metric, base_mean, run_mean, change_pct, flag)."""
+    for key in sorted(set(base) & set(run)):
+        for m, (_, higher_better) in METRICS.items():
+            b, r = base[key][m], run[key][m]
+            mb, mr = sum(b) / len(b), sum(r) / len(r)
+            if mb == 0 and mr == 0:
+                continue                # counter not available
+            change = (mr - mb) / mb * 100 if mb else float('inf')
+            worse = -change if higher_better else change
+            sig = welch_significant(b, r)
+            flag = ''
+            if worse > threshold:
+                if sig is None:
+                    flag = '~'
+                elif sig:
+                    flag = '!'
+            yield key, m, mb, mr, change, flag
+
+
+# ============================================================================
+# Main
+# ============================================================================
+
+def describe(run):
+    return (f"{run['run_id']}  rev {run['git_rev']}  kernel {run['kernel']}"
+            f"  {run['cpu_model']}\n    {run['config']}")
+
+
+def main():
+    ap = argparse.ArgumentParser(description='Flag performance regressions '
+                                 'between two runs in the results history.')
+    ap.add_argument('-H', '--history', default=HISTORY_CSV)
+    ap.add_argument('-b', '--baseline', default='previous')
+    ap.add_argument('-r', '--run', default='latest')
+    ap.add_argument('-t', '--threshold', type=float, default=5.0,
+                    help='noise threshold in percent (default 5)')
+    ap.add_argument('--list', action='store_true', help='list stored runs')
+    args = ap.parse_args()
+
+    runs, samples = load_history(args.history)
+
+    if args.list:
+        for r in runs:
+            print(describe(r))
+        return 0
+
+    base_id = resolve_run(runs, args.baseline)
+    run_id = resolve_run(runs, args.run)
+    info = {r['run_id']: r for r in runs}
+    print('Baseline: ' + describe(info[base_id]))
+    print('Run:      ' + describe(info[run_id]))
+    for field in ('kernel', 'cpu_model', 'config'):
+        if info[base_id][field] != info[run_id][field]:
+            print(f'Warning: {field} differs between the two runs')
+    print()
+
+    print(f"{'implementation':<20}{'msg':>7}{'thr':>5}  {'metric':<7}"
+          f"{'baseline':>14}{'run':>14}{'change':>9}")
+    regressions = 0
+    for key, m, mb, mr, change, flag in compare(samples[base_id],
+                                                samples[run_id],
+                                                args.threshold):
+        impl, size, thr = key
+        print(f"{impl:<20}{size:>7}{thr:>5}  {METRICS[m][0]:<7}"
+              f"{mb:>14.4g}{mr:>14.4g}{change:>+8.1f}% {flag}")
+        regressions += flag != ''
+
+    print(f"\n{regressions} regression(s) beyond {args.threshold:g}% "
+          "('!' significant at 95%, '~' single repetition, not testable)")
+    return 1 if regressions else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -16,6 +16,11 @@ Plots generated:
   3. Cache Misses vs Message Size
   4. CPU Cycles per Byte Transferred
 
+With --run/--baseline the plots come from the results history instead
+(MT25042_Part_B_History.csv): throughput and latency of any stored run
+against a baseline run, e.g.
+  python3 MT25042_Part_D_Plots.py --baseline 20250301 --run latest out/
+
 AI Declaration: Asked ChatGPT for help with matplotlib multi-line plot
   layout and legend positioning. Prompt: "How to plot throughput vs
   message size with multiple lines for different implementations
@@ -26,9 +31,12 @@ import matplotlib
 matplotlib.use('Agg')
 import matplotlib.pyplot as plt
 import numpy as np
+import argparse
 import os
 import sys
 
+from MT25042_Part_D_Compare import HISTORY_CSV, load_history, resolve_run
+
 # ============================================================================
 # Hardcoded experimental data (from perf stat measurements on CachyOS)
 # ============================================================================
@@ -340,17 +348,82 @@ def plot_cycles_per_byte(output_dir, thread_idx=2):
     save_plot(fig, 'MT25042_Part_D_CyclesPerByte_vs_MsgSize.png', output_dir)
 
 
+# ============================================================================
+# Plot 5: Stored run vs baseline (from the results history)
+# ============================================================================
+def plot_run_vs_baseline(output_dir, history, baseline, run, threads):
+    """Throughput and latency vs message size: run solid, baseline dashed."""
+    runs, samples = load_history(history)
+    base_id = resolve_run(runs, baseline)
+    run_id = resolve_run(runs, run)
+
+    def mean(x):
+        return sum(x) / len(x)
+
+    fig, (ax1, ax2) = plt.subplots(1, 2, figsize=(14, 6))
+    impls = sorted({k[0] for k in samples[run_id]} |
+                   {k[0] for k in samples[base_id]})
+    cmap = plt.get_cmap('tab10')
+
+    for i, impl in enumerate(impls):
+        color = COLORS.get(impl, cmap(i % 10))
+        marker = MARKERS.get(impl, 'o')
+        for rid, style, tag in ((base_id, '--', 'baseline'),
+                                (run_id, '-', 'run')):
+            pts = sorted((k[1], v) for k, v in samples[rid].items()
+                         if k[0] == impl and k[2] == threads)
+            if not pts:
+                continue
+            sizes = [p[0] for p in pts]
+            ax1.plot(sizes, [mean(p[1]['throughput_gbps']) for p in pts],
+                     linestyle=style, marker=marker, color=color,
+                     label=f'{impl} ({tag})', linewidth=2, markersize=7)
+            ax2.plot(sizes, [mean(p[1]['latency_us']) for p in pts],
+                     linestyle=style, marker=marker, color=color,
+                     label=f'{impl} ({tag})', linewidth=2, markersize=7)
+
+    for ax, ylabel in ((ax1, 'Throughput (Gbps)'),
+                       (ax2, 'Average Latency (µs)')):
+        ax.set_xlabel('Message Size (bytes)')
+        ax.set_ylabel(ylabel)
+        ax.set_xscale('log', base=2)
+        ax.legend()
+    ax1.set_title(f'Throughput ({threads} threads)')
+    ax2.set_title(f'Latency ({threads} threads)')
+
+    fig.suptitle(f'Run {run_id} vs baseline {base_id}', fontsize=13,
+                 fontweight='bold')
+    plt.tight_layout()
+
+    save_plot(fig, f'MT25042_Part_D_Run_{run_id}_vs_{base_id}.png',
+              output_dir)
+
+
 # ============================================================================
 # Main
 # ============================================================================
 def main():
-    output_dir = os.path.dirname(os.path.abspath(__file__))
-    if len(sys.argv) >= 2:
-        output_dir = sys.argv[1]
+    ap = argparse.ArgumentParser(description='Generate the Part D plots.')
+    ap.add_argument('output_dir', nargs='?',
+                    default=os.path.dirname(os.path.abspath(__file__)))
+    ap.add_argument('--history', default=HISTORY_CSV)
+    ap.add_argument('--run', help="stored run to plot ('latest', id prefix)")
+    ap.add_argument('--baseline', default='previous',
+                    help='run to compare against (default previous)')
+    ap.add_argument('--threads', type=int, default=4)
+    args = ap.parse_args()
+
+    output_dir = args.output_dir
     os.makedirs(output_dir, exist_ok=True)
 
     set_style()
 
+    if args.run:
+        print("Generating run vs baseline plot...")
+        plot_run_vs_baseline(output_dir, args.history, args.baseline,
+                             args.run, args.threads)
+        return
+
     print("Generating plots...")
     plot_throughput_vs_msgsize(output_dir)
     plot_latency_vs_threads(output_dir)
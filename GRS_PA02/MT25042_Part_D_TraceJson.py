@@ -0,0 +1,112 @@
+#!/usr/bin/env python3
+"""
+MT25042_Part_D_TraceJson.py
+Graduate Systems (CSE638) - PA02: Analysis of Network I/O primitives
+
+Converts the binary event rings written with PA02_TRACE=<prefix> (see
+MT25042_Part_A_Trace.h) into Chrome trace JSON, which chrome://tracing
+and https://ui.perfetto.dev open directly.  Pass the server's and the
+client's dumps together to get both on one timeline.
+
+  send / recv          duration slices per thread (bytes, errno in args)
+  ENOBUFS              instant event (zero-copy back-pressure)
+  zc_done              instant event with the completed send-id range
+
+Usage:
+  python3 MT25042_Part_D_TraceJson.py out.json run.1234.trace run.1240.trace
+
+AI Declaration: This script was generated with AI assistance;
+  the JSON layout follows the public Trace Event Format document.
+"""
+
+import json
+import struct
+import sys
+
+FILE_HDR = struct.Struct('<8sIIdQQ32s')
+RING_HDR = struct.Struct('<IIQQ')
+EVENT = struct.Struct('<QIIQ')
+
+TR_SEND_BEGIN, TR_SEND_END, TR_ENOBUFS, TR_ZC_DONE, \
+    TR_RECV_BEGIN, TR_RECV_END = range(1, 7)
+
+SLICES = {TR_SEND_BEGIN: ('send', True), TR_SEND_END: ('send', False),
+          TR_RECV_BEGIN: ('recv', True), TR_RECV_END: ('recv', False)}
+
+
+def signed32(v):
+    return v - (1 << 32) if v & (1 << 31) else v
+
+
+def read_dump(path):
+    """Yields Chrome trace events for one dump file."""
+    with open(path, 'rb') as f:
+        data = f.read()
+
+    magic, pid, nrings, ns_per_tick, tick0, mono0, prog = \
+        FILE_HDR.unpack_from(data, 0)
+    if magic.rstrip(b'\0') != b'PA2TRC1':
+        sys.exit(f'Error: {path} is not a PA02 trace dump')
+    prog = prog.rstrip(b'\0').decode(errors='replace')
+
+    yield {'ph': 'M', 'name': 'process_name', 'pid': pid,
+           'args': {'name': f'{prog} ({pid})'}}
+
+    def to_us(ticks):
+        # Same CLOCK_MONOTONIC base in every process on the host
+        return (mono0 + (ticks - tick0) * ns_per_tick) / 1e3
+
+    off = FILE_HDR.size
+    for _ in range(nrings):
+        tid, _, count, dropped = RING_HDR.unpack_from(data, off)
+        off += RING_HDR.size
+        yield {'ph': 'M', 'name': 'thread_name', 'pid': pid, 'tid': tid,
+               'args': {'name': f'tid {tid}' +
+                        (f' ({dropped} events dropped)' if dropped else '')}}
+
+        open_slice = None
+        for i in range(count):
+            ts, typ, a, b = EVENT.unpack_from(data, off + i * EVENT.size)
+            ev = {'pid': pid, 'tid': tid, 'ts': to_us(ts)}
+
+            if typ in SLICES:
+                name, begin = SLICES[typ]
+                if begin:
+                    open_slice = name
+                    ev.update(ph='B', name=name)
+                elif open_slice == name:
+                    # An end whose begin was overwritten is dropped
+                    open_slice = None
+                    ev.update(ph='E', name=name,
+                              args={'bytes': signed32(a), 'errno': b})
+                else:
+                    continue
+            elif typ == TR_ENOBUFS:
+                ev.update(ph='i', s='t', name='ENOBUFS',
+                          args={'sends': a})
+            elif typ == TR_ZC_DONE:
+                ev.update(ph='i', s='t', name='zc_done',
+                          args={'first': a, 'last': b & ((1 << 63) - 1),
+                                'copied': b >> 63})
+            else:
+                continue
+            yield ev
+        off += count * EVENT.size
+
+
+def main():
+    if len(sys.argv) < 3:
+        sys.exit(f'Usage: {sys.argv[0]} out.json dump.trace [dump.trace ...]')
+
+    events = []
+    for path in sys.argv[2:]:
+        events.extend(read_dump(path))
+
+    with open(sys.argv[1], 'w') as f:
+        json.dump({'traceEvents': events, 'displayTimeUnit': 'ns'}, f)
+    print(f'{len(events)} events from {len(sys.argv) - 2} dump(s) '
+          f'written to {sys.argv[1]}')
+
+
+if __name__ == '__main__':
+    main()